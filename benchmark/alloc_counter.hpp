@@ -0,0 +1,139 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef kep3_BENCHMARK_ALLOC_COUNTER_HPP
+#define kep3_BENCHMARK_ALLOC_COUNTER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+// Counts the heap allocations made through the global operator new, by
+// replacing all of its forms (single object and array, aligned or not,
+// throwing or not) and the matching operator delete. As any replacement of
+// the global allocation functions, it must be included by a single
+// translation unit of the program.
+namespace kep3_benchmarks {
+
+inline std::atomic<unsigned long> n_allocs{0u};
+
+// Number of allocations made so far.
+inline unsigned long allocations() { return n_allocs.load(); }
+
+namespace detail {
+
+inline void *counted_alloc(std::size_t size) noexcept {
+  ++n_allocs;
+  // NOTE: malloc(0) may return a null pointer, while operator new must not.
+  return std::malloc(size == 0u ? 1u : size);
+}
+
+inline void *counted_aligned_alloc(std::size_t size,
+                                   std::align_val_t al) noexcept {
+  ++n_allocs;
+  const auto align = static_cast<std::size_t>(al);
+  // NOTE: std::aligned_alloc() requires the size to be a multiple of the
+  // alignment.
+  const std::size_t sz = (std::max<std::size_t>(size, 1u) + align - 1u) /
+                         align * align;
+  return std::aligned_alloc(align, sz);
+}
+
+} // namespace detail
+
+} // namespace kep3_benchmarks
+
+void *operator new(std::size_t size) {
+  if (void *ptr = kep3_benchmarks::detail::counted_alloc(size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size) {
+  if (void *ptr = kep3_benchmarks::detail::counted_alloc(size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+  return kep3_benchmarks::detail::counted_alloc(size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+  return kep3_benchmarks::detail::counted_alloc(size);
+}
+
+void *operator new(std::size_t size, std::align_val_t al) {
+  if (void *ptr = kep3_benchmarks::detail::counted_aligned_alloc(size, al)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size, std::align_val_t al) {
+  if (void *ptr = kep3_benchmarks::detail::counted_aligned_alloc(size, al)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void *operator new(std::size_t size, std::align_val_t al,
+                   const std::nothrow_t &) noexcept {
+  return kep3_benchmarks::detail::counted_aligned_alloc(size, al);
+}
+
+void *operator new[](std::size_t size, std::align_val_t al,
+                     const std::nothrow_t &) noexcept {
+  return kep3_benchmarks::detail::counted_aligned_alloc(size, al);
+}
+
+// NOTE: all the memory above comes from malloc() or aligned_alloc(), and is
+// thus released by free(). GCC cannot see it, and warns about free()
+// releasing memory from operator new.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete[](void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete(void *ptr, const std::nothrow_t &) noexcept {
+  std::free(ptr);
+}
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept {
+  std::free(ptr);
+}
+void operator delete(void *ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+void operator delete[](void *ptr, std::size_t, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+void operator delete(void *ptr, std::align_val_t,
+                     const std::nothrow_t &) noexcept {
+  std::free(ptr);
+}
+void operator delete[](void *ptr, std::align_val_t,
+                       const std::nothrow_t &) noexcept {
+  std::free(ptr);
+}
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif // kep3_BENCHMARK_ALLOC_COUNTER_HPP
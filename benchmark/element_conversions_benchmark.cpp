@@ -0,0 +1,205 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include <kep3/core_astro/constants.hpp>
+#include <kep3/core_astro/elements_batch.hpp>
+#include <kep3/core_astro/eq2par2eq.hpp>
+#include <kep3/core_astro/ic2eq2ic.hpp>
+#include <kep3/core_astro/ic2par2ic.hpp>
+
+#include "alloc_counter.hpp"
+
+using std::chrono::duration_cast;
+using std::chrono::high_resolution_clock;
+using std::chrono::microseconds;
+
+// In this benchmark we test the speed of the element conversions, one state
+// at a time (scalar) and in SoA batches, counting the heap allocations made
+// by the scalar conversions. We then test the speed of their Jacobians,
+// against central finite differences (twelve scalar conversions).
+
+// Six arrays of N values.
+using soa = std::array<std::vector<double>, 6>;
+
+kep3::elements_batch_input in(const soa &s) {
+  return {s[0], s[1], s[2], s[3], s[4], s[5]};
+}
+
+kep3::elements_batch_output out(soa &s) {
+  return {s[0], s[1], s[2], s[3], s[4], s[5]};
+}
+
+std::array<double, 6> get(const soa &s, std::size_t i) {
+  return {s[0][i], s[1][i], s[2][i], s[3][i], s[4][i], s[5][i]};
+}
+
+void set(soa &s, std::size_t i, const std::array<double, 6> &v) {
+  for (auto c = 0u; c < 6u; ++c) {
+    s[c][i] = v[c];
+  }
+}
+
+std::array<double, 6> flat(const std::array<std::array<double, 3>, 2> &pv) {
+  return {pv[0][0], pv[0][1], pv[0][2], pv[1][0], pv[1][1], pv[1][2]};
+}
+
+std::array<std::array<double, 3>, 2> split(const std::array<double, 6> &v) {
+  return {{{v[0], v[1], v[2]}, {v[3], v[4], v[5]}}};
+}
+
+template <typename Scalar, typename Batch>
+void perform_test_speed(const char *name, const soa &input, unsigned N,
+                        const Scalar &scalar, const Batch &batch) {
+  soa output;
+  for (auto &v : output) {
+    v.resize(N);
+  }
+  const auto allocs = kep3_benchmarks::allocations();
+  auto start = high_resolution_clock::now();
+  for (auto i = 0u; i < N; ++i) {
+    set(output, i, scalar(get(input, i)));
+  }
+  auto stop = high_resolution_clock::now();
+  const auto scalar_allocs = kep3_benchmarks::allocations() - allocs;
+  const auto t_scalar = static_cast<double>(
+                            duration_cast<microseconds>(stop - start).count()) /
+                        1e6;
+  start = high_resolution_clock::now();
+  batch(in(input), out(output));
+  stop = high_resolution_clock::now();
+  const auto t_batch = static_cast<double>(
+                           duration_cast<microseconds>(stop - start).count()) /
+                       1e6;
+  fmt::print("{}, on {} states: scalar {:.3f}s ({} allocations), batch "
+             "{:.3f}s ({:.1f}x)\n",
+             name, N, t_scalar, scalar_allocs, t_batch, t_scalar / t_batch);
+}
+
+template <typename Scalar, typename Jac>
+void perform_test_speed_jac(const char *name, const soa &input, unsigned N,
+                            const Scalar &scalar, const Jac &jac) {
+  // NOTE: the sum of the Jacobians prevents the loops from being optimised
+  // away.
+  double sum_fd = 0., sum_jac = 0.;
+  auto start = high_resolution_clock::now();
+  for (auto i = 0u; i < N; ++i) {
+    const auto x = get(input, i);
+    for (auto j = 0u; j < 6u; ++j) {
+      const double h = 1e-7 * std::max(1., std::abs(x[j]));
+      auto xp = x, xm = x;
+      xp[j] += h;
+      xm[j] -= h;
+      const auto fp = scalar(xp);
+      const auto fm = scalar(xm);
+      for (auto k = 0u; k < 6u; ++k) {
+        sum_fd += (fp[k] - fm[k]) / (2. * h);
+      }
+    }
+  }
+  auto stop = high_resolution_clock::now();
+  const auto t_fd = static_cast<double>(
+                        duration_cast<microseconds>(stop - start).count()) /
+                    1e6;
+  start = high_resolution_clock::now();
+  for (auto i = 0u; i < N; ++i) {
+    const auto J = jac(get(input, i));
+    for (const auto &row : J) {
+      for (auto v : row) {
+        sum_jac += v;
+      }
+    }
+  }
+  stop = high_resolution_clock::now();
+  const auto t_jac = static_cast<double>(
+                         duration_cast<microseconds>(stop - start).count()) /
+                     1e6;
+  fmt::print("{}_jac, on {} states: finite differences {:.3f}s, automatic "
+             "differentiation {:.3f}s ({:.1f}x) (checksums {:.3e} {:.3e})\n",
+             name, N, t_fd, t_jac, t_fd / t_jac, sum_fd, sum_jac);
+}
+
+int main() {
+  const unsigned N = 1000000u;
+  // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+  std::mt19937 rng_engine(122012203u);
+  std::uniform_real_distribution<double> sma_d(1.1, 100.);
+  std::uniform_real_distribution<double> ecc_d(0, 0.99);
+  std::uniform_real_distribution<double> incl_d(0.01, kep3::pi - 0.01);
+  std::uniform_real_distribution<double> angle_d(0., 2 * kep3::pi);
+  // We generate the random dataset (ellipses).
+  soa par, pos_vel, eq;
+  for (auto c = 0u; c < 6u; ++c) {
+    par[c].resize(N);
+    pos_vel[c].resize(N);
+    eq[c].resize(N);
+  }
+  for (auto i = 0u; i < N; ++i) {
+    set(par, i,
+        {sma_d(rng_engine), ecc_d(rng_engine), incl_d(rng_engine),
+         angle_d(rng_engine), angle_d(rng_engine), angle_d(rng_engine)});
+  }
+  kep3::par2ic_batch(in(par), 1., out(pos_vel));
+  kep3::ic2eq_batch(in(pos_vel), 1., out(eq));
+
+  perform_test_speed(
+      "ic2par", pos_vel, N,
+      [](const auto &s) { return kep3::ic2par(split(s), 1.); },
+      [](const auto &i, const auto &o) { kep3::ic2par_batch(i, 1., o); });
+  perform_test_speed(
+      "par2ic", par, N,
+      [](const auto &p) { return flat(kep3::par2ic(p, 1.)); },
+      [](const auto &i, const auto &o) { kep3::par2ic_batch(i, 1., o); });
+  perform_test_speed(
+      "ic2eq", pos_vel, N,
+      [](const auto &s) { return kep3::ic2eq(split(s), 1.); },
+      [](const auto &i, const auto &o) { kep3::ic2eq_batch(i, 1., o); });
+  perform_test_speed(
+      "eq2ic", eq, N, [](const auto &e) { return flat(kep3::eq2ic(e, 1.)); },
+      [](const auto &i, const auto &o) { kep3::eq2ic_batch(i, 1., o); });
+  perform_test_speed(
+      "par2eq", par, N, [](const auto &p) { return kep3::par2eq(p); },
+      [](const auto &i, const auto &o) { kep3::par2eq_batch(i, o); });
+  perform_test_speed(
+      "eq2par", eq, N, [](const auto &e) { return kep3::eq2par(e); },
+      [](const auto &i, const auto &o) { kep3::eq2par_batch(i, o); });
+
+  // Jacobians.
+  const unsigned N_jac = N / 10u;
+  perform_test_speed_jac(
+      "ic2par", pos_vel, N_jac,
+      [](const auto &s) { return kep3::ic2par(split(s), 1.); },
+      [](const auto &s) { return kep3::ic2par_jac(split(s), 1.).second; });
+  perform_test_speed_jac(
+      "par2ic", par, N_jac,
+      [](const auto &p) { return flat(kep3::par2ic(p, 1.)); },
+      [](const auto &p) { return kep3::par2ic_jac(p, 1.).second; });
+  perform_test_speed_jac(
+      "ic2eq", pos_vel, N_jac,
+      [](const auto &s) { return kep3::ic2eq(split(s), 1.); },
+      [](const auto &s) { return kep3::ic2eq_jac(split(s), 1.).second; });
+  perform_test_speed_jac(
+      "eq2ic", eq, N_jac,
+      [](const auto &e) { return flat(kep3::eq2ic(e, 1.)); },
+      [](const auto &e) { return kep3::eq2ic_jac(e, 1.).second; });
+  perform_test_speed_jac(
+      "par2eq", par, N_jac, [](const auto &p) { return kep3::par2eq(p); },
+      [](const auto &p) { return kep3::par2eq_jac(p).second; });
+  perform_test_speed_jac(
+      "eq2par", eq, N_jac, [](const auto &e) { return kep3::eq2par(e); },
+      [](const auto &e) { return kep3::eq2par_jac(e).second; });
+}
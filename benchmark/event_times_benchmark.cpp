@@ -0,0 +1,136 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include <kep3/core_astro/constants.hpp>
+#include <kep3/core_astro/elements_batch.hpp>
+#include <kep3/core_astro/event_times.hpp>
+#include <kep3/core_astro/ic2par2ic.hpp>
+#include <kep3/core_astro/propagate_lagrangian.hpp>
+
+using std::chrono::duration_cast;
+using std::chrono::high_resolution_clock;
+using std::chrono::microseconds;
+
+// In this benchmark we test the speed of the closed-form time to a radius
+// crossing, in its scalar and batch versions, against a bisection on the time
+// with kep3::propagate_lagrangian(). The states are on ellipses, on their way
+// to the periapsis, and the radius is halfway between the current one and
+// the periapsis.
+
+namespace {
+
+double norm(const std::array<double, 3> &x) {
+  return std::sqrt(x[0] * x[0] + x[1] * x[1] + x[2] * x[2]);
+}
+
+// Bisection on [0, T / 2]: within it, the radius is crossed exactly when the
+// body is below it or has passed the periapsis.
+double bisection(const std::array<std::array<double, 3>, 2> &pos_vel,
+                 double R, double T, unsigned iter) {
+  double lb = 0., ub = T / 2;
+  for (auto k = 0u; k < iter; ++k) {
+    const double t = 0.5 * (lb + ub);
+    auto pv = pos_vel;
+    kep3::propagate_lagrangian(pv, t, 1.);
+    const double rv =
+        pv[0][0] * pv[1][0] + pv[0][1] * pv[1][1] + pv[0][2] * pv[1][2];
+    if (norm(pv[0]) < R || rv > 0.) {
+      ub = t;
+    } else {
+      lb = t;
+    }
+  }
+  return 0.5 * (lb + ub);
+}
+
+void perform_test_speed(double min_ecc, double max_ecc, unsigned N) {
+  // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+  std::mt19937 rng_engine(122012203u);
+  std::uniform_real_distribution<double> sma_d(1.1, 10.);
+  std::uniform_real_distribution<double> ecc_d(min_ecc, max_ecc);
+  std::uniform_real_distribution<double> incl_d(0., kep3::pi);
+  std::uniform_real_distribution<double> angle_d(0., 2 * kep3::pi);
+
+  // We generate the random dataset.
+  std::vector<std::array<std::array<double, 3>, 2>> states(N);
+  std::array<std::vector<double>, 6> soa;
+  for (auto &v : soa) {
+    v.resize(N);
+  }
+  std::vector<double> radii(N), periods(N);
+  for (auto i = 0u; i < N; ++i) {
+    const double sma = sma_d(rng_engine), ecc = ecc_d(rng_engine);
+    // True anomaly in (pi, 2pi): on the way to the periapsis.
+    states[i] = kep3::par2ic({sma, ecc, incl_d(rng_engine),
+                              angle_d(rng_engine), angle_d(rng_engine),
+                              kep3::pi + 0.5 * angle_d(rng_engine)},
+                             1.);
+    radii[i] = 0.5 * (norm(states[i][0]) + sma * (1. - ecc));
+    periods[i] = 2 * kep3::pi * std::sqrt(sma * sma * sma);
+    for (auto c = 0u; c < 6u; ++c) {
+      soa[c][i] = states[i][c / 3u][c % 3u];
+    }
+  }
+  const kep3::elements_batch_input pos_vel = {soa[0], soa[1], soa[2],
+                                              soa[3], soa[4], soa[5]};
+
+  fmt::print("{:.2f} min_ecc, {:.2f} max_ecc, on {} data points: ", min_ecc,
+             max_ecc, N);
+  std::vector<double> t_scalar(N), t_batch(N), t_bisection(N);
+  auto start = high_resolution_clock::now();
+  for (auto i = 0u; i < N; ++i) {
+    t_scalar[i] = kep3::time_to_radius(states[i], radii[i], 1.);
+  }
+  auto stop = high_resolution_clock::now();
+  const auto d_scalar = static_cast<double>(
+                            duration_cast<microseconds>(stop - start).count()) /
+                        1e6;
+  start = high_resolution_clock::now();
+  kep3::time_to_radius_batch(pos_vel, radii, 1., t_batch);
+  stop = high_resolution_clock::now();
+  const auto d_batch = static_cast<double>(
+                           duration_cast<microseconds>(stop - start).count()) /
+                       1e6;
+  // The bisection runs on a tenth of the states, as it is much slower.
+  const unsigned N_bis = N / 10u;
+  start = high_resolution_clock::now();
+  for (auto i = 0u; i < N_bis; ++i) {
+    t_bisection[i] = bisection(states[i], radii[i], periods[i], 50u);
+  }
+  stop = high_resolution_clock::now();
+  const auto d_bisection =
+      static_cast<double>(duration_cast<microseconds>(stop - start).count()) /
+      1e6 * 10.;
+  double err = 0.;
+  for (auto i = 0u; i < N_bis; ++i) {
+    err = std::max(err, std::abs(t_scalar[i] - t_bisection[i]));
+  }
+  fmt::print("bisection {:.3f}s, scalar {:.3f}s ({:.1f}x), batch {:.3f}s "
+             "({:.1f}x), max difference {:.1e}\n",
+             d_bisection, d_scalar, d_bisection / d_scalar, d_batch,
+             d_bisection / d_batch, err);
+}
+
+} // namespace
+
+int main() {
+  fmt::print("\nComputes speed at different eccentricity ranges:\n");
+  perform_test_speed(0, 0.5, 1000000);
+  perform_test_speed(0.5, 0.9, 1000000);
+  perform_test_speed(0.9, 0.99, 1000000);
+}
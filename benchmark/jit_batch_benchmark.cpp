@@ -0,0 +1,137 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <array>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include <kep3/core_astro/constants.hpp>
+#include <kep3/core_astro/elements_batch.hpp>
+#include <kep3/core_astro/ic2par2ic.hpp>
+#include <kep3/core_astro/jit_batch.hpp>
+#include <kep3/core_astro/propagate_lagrangian.hpp>
+
+using std::chrono::duration_cast;
+using std::chrono::high_resolution_clock;
+using std::chrono::microseconds;
+
+// In this benchmark we compare the batch kernels JIT-compiled by heyoka with
+// the scalar functions called in a loop and, for par2ic, with the batch
+// version in elements_batch.hpp. The first call to each JIT kernel, which
+// compiles it, is timed separately.
+
+namespace {
+
+// Seconds elapsed since start.
+double elapsed(high_resolution_clock::time_point start) {
+  return static_cast<double>(
+             duration_cast<microseconds>(high_resolution_clock::now() - start)
+                 .count()) /
+         1e6;
+}
+
+void perform_test_speed(unsigned N) {
+  // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+  std::mt19937 rng_engine(122012203u);
+  std::uniform_real_distribution<double> sma_d(0.5, 20.);
+  std::uniform_real_distribution<double> ecc_d(0., 0.9);
+  std::uniform_real_distribution<double> incl_d(0., kep3::pi);
+  std::uniform_real_distribution<double> angle_d(0., 2 * kep3::pi);
+  std::uniform_real_distribution<double> tof_d(10., 100.);
+
+  // We generate the random dataset, in SoA form.
+  std::array<std::vector<double>, 6> par, pos_vel, pos_vel_new;
+  for (auto k = 0u; k < 6u; ++k) {
+    par[k].resize(N);
+    pos_vel[k].resize(N);
+    pos_vel_new[k].resize(N);
+  }
+  std::vector<double> tofs(N);
+  for (auto i = 0u; i < N; ++i) {
+    par[0][i] = sma_d(rng_engine);
+    par[1][i] = ecc_d(rng_engine);
+    par[2][i] = incl_d(rng_engine);
+    par[3][i] = angle_d(rng_engine);
+    par[4][i] = angle_d(rng_engine);
+    par[5][i] = angle_d(rng_engine);
+    tofs[i] = tof_d(rng_engine);
+  }
+  const kep3::elements_batch_input par_in = {par[0], par[1], par[2],
+                                             par[3], par[4], par[5]};
+  const kep3::elements_batch_input pos_vel_in = {
+      pos_vel[0], pos_vel[1], pos_vel[2], pos_vel[3], pos_vel[4], pos_vel[5]};
+  const kep3::elements_batch_output pos_vel_out = {
+      pos_vel[0], pos_vel[1], pos_vel[2], pos_vel[3], pos_vel[4], pos_vel[5]};
+  const kep3::elements_batch_output pos_vel_new_out = {
+      pos_vel_new[0], pos_vel_new[1], pos_vel_new[2],
+      pos_vel_new[3], pos_vel_new[4], pos_vel_new[5]};
+
+  fmt::print("On {} data points:\n", N);
+
+  // par2ic.
+  auto start = high_resolution_clock::now();
+  for (auto i = 0u; i < N; ++i) {
+    const auto [r, v] = kep3::par2ic(
+        {par[0][i], par[1][i], par[2][i], par[3][i], par[4][i], par[5][i]},
+        1.);
+    for (auto k = 0u; k < 3u; ++k) {
+      pos_vel[k][i] = r[k];
+      pos_vel[k + 3u][i] = v[k];
+    }
+  }
+  const auto t_scalar = elapsed(start);
+  start = high_resolution_clock::now();
+  kep3::par2ic_batch(par_in, 1., pos_vel_out);
+  const auto t_batch = elapsed(start);
+  start = high_resolution_clock::now();
+  kep3::par2ic_jit_batch(par_in, 1., pos_vel_out);
+  const auto t_compile = elapsed(start);
+  start = high_resolution_clock::now();
+  kep3::par2ic_jit_batch(par_in, 1., pos_vel_out);
+  const auto t_jit = elapsed(start);
+  fmt::print("par2ic: scalar {:.3f}s, batch {:.3f}s, jit {:.3f}s ({:.1f}x on "
+             "scalar, {:.1f}x on batch), first jit call {:.3f}s\n",
+             t_scalar, t_batch, t_jit, t_scalar / t_jit, t_batch / t_jit,
+             t_compile);
+
+  // propagate_lagrangian, from the states just computed.
+  start = high_resolution_clock::now();
+  for (auto i = 0u; i < N; ++i) {
+    std::array<std::array<double, 3>, 2> pv = {
+        {{pos_vel[0][i], pos_vel[1][i], pos_vel[2][i]},
+         {pos_vel[3][i], pos_vel[4][i], pos_vel[5][i]}}};
+    kep3::propagate_lagrangian(pv, tofs[i], 1.);
+    for (auto k = 0u; k < 3u; ++k) {
+      pos_vel_new[k][i] = pv[0][k];
+      pos_vel_new[k + 3u][i] = pv[1][k];
+    }
+  }
+  const auto t_prop_scalar = elapsed(start);
+  start = high_resolution_clock::now();
+  kep3::propagate_lagrangian_jit_batch(pos_vel_in, tofs, 1., pos_vel_new_out);
+  const auto t_prop_compile = elapsed(start);
+  start = high_resolution_clock::now();
+  kep3::propagate_lagrangian_jit_batch(pos_vel_in, tofs, 1., pos_vel_new_out);
+  const auto t_prop_jit = elapsed(start);
+  fmt::print("propagate_lagrangian: scalar {:.3f}s, jit {:.3f}s ({:.1f}x), "
+             "first jit call {:.3f}s\n",
+             t_prop_scalar, t_prop_jit, t_prop_scalar / t_prop_jit,
+             t_prop_compile);
+}
+
+} // namespace
+
+int main() {
+  fmt::print("\nComputes the speed of the JIT-compiled kernels:\n");
+  perform_test_speed(10000);
+  perform_test_speed(1000000);
+}
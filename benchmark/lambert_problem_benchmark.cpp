@@ -23,20 +23,31 @@
  *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
  *****************************************************************************/
 
+#include <algorithm>
 #include <array>
+#include <cmath>
 #include <chrono>
+#include <cstddef>
 #include <iomanip>
 #include <iostream>
+#include <limits>
 #include <random>
+#include <vector>
 
 #include <fmt/core.h>
 #include <fmt/ranges.h>
 
 #include <kep3/core_astro/constants.hpp>
 #include <kep3/core_astro/propagate_lagrangian.hpp>
+#include <kep3/detail/lambert_kernels.hpp>
+#include <kep3/lambert_batch.hpp>
+#include <kep3/lambert_bounds.hpp>
 #include <kep3/lambert_problem.hpp>
+#include <kep3/lambert_solve.hpp>
 #include <stdexcept>
 
+#include "alloc_counter.hpp"
+
 using std::chrono::duration_cast;
 using std::chrono::high_resolution_clock;
 using std::chrono::microseconds;
@@ -76,7 +87,7 @@ int main() {
   for (auto i = 0u; i < trials; ++i) {
     // 2 - Solve the lambert problem
     kep3::lambert_problem lp(r1s[i], r2s[i], tof[i], mu[i], cw[i], revs_max);
-    count = count + lp.get_v1().size();
+    count = count + lp.get_v1_span().size();
   }
   auto stop = high_resolution_clock::now();
   auto duration = duration_cast<microseconds>(stop - start);
@@ -98,4 +109,516 @@ int main() {
              (static_cast<double>(duration.count()) / 1e6));
   fmt::print("Projected number of solutions per second: {}\n",
              static_cast<double>(count) / ((static_cast<double>(duration.count()) / 1e6)));
-}
\ No newline at end of file
+
+  // 4 - Solve the same problems (prograde only) in batch, with the scalar and
+  // the lanes solvers.
+  std::vector<double> r1x(trials), r1y(trials), r1z(trials), r2x(trials),
+      r2y(trials), r2z(trials), v1x(trials), v1y(trials), v1z(trials),
+      v2x(trials), v2y(trials), v2z(trials);
+  std::vector<kep3::lambert_status> status(trials);
+  for (auto i = 0u; i < trials; ++i) {
+    r1x[i] = r1s[i][0];
+    r1y[i] = r1s[i][1];
+    r1z[i] = r1s[i][2];
+    r2x[i] = r2s[i][0];
+    r2y[i] = r2s[i][1];
+    r2z[i] = r2s[i][2];
+  }
+  const kep3::lambert_batch_input in{r1x, r1y, r1z, r2x, r2y, r2z, tof, mu};
+  const kep3::lambert_batch_output out{v1x, v1y, v1z, v2x, v2y, v2z, status};
+
+  start = high_resolution_clock::now();
+  kep3::lambert_batch(in, out);
+  stop = high_resolution_clock::now();
+  duration = duration_cast<microseconds>(stop - start);
+  fmt::print("\nLambert batch (0 revs only):\n{} solutions computed in {:.3f}s\n", trials,
+             (static_cast<double>(duration.count()) / 1e6));
+  fmt::print("Projected number of solutions per second: {}\n",
+             static_cast<double>(trials) / ((static_cast<double>(duration.count()) / 1e6)));
+
+  for (unsigned lanes : {4u, 8u}) {
+    start = high_resolution_clock::now();
+    kep3::lambert_batch_lanes(in, out, false, lanes);
+    stop = high_resolution_clock::now();
+    duration = duration_cast<microseconds>(stop - start);
+    fmt::print("\nLambert batch, {} lanes (0 revs only):\n{} solutions computed in {:.3f}s\n",
+               lanes, trials, (static_cast<double>(duration.count()) / 1e6));
+    fmt::print("Projected number of solutions per second: {}\n",
+               static_cast<double>(trials) / ((static_cast<double>(duration.count()) / 1e6)));
+  }
+
+  // 5 - Velocities and their sensitivities with respect to r1, r2 and tof, via
+  // the analytic Jacobians and via central finite differences.
+  count = 0; // reset counter
+  start = high_resolution_clock::now();
+  for (auto i = 0u; i < trials; ++i) {
+    kep3::lambert_problem lp(r1s[i], r2s[i], tof[i], mu[i], cw[i], 0u, {.sensitivities = true});
+    count += lp.get_dv1_dp().size();
+  }
+  stop = high_resolution_clock::now();
+  duration = duration_cast<microseconds>(stop - start);
+  fmt::print("\nLambert with analytic sensitivities (0 revs only):\n{} solutions computed in {:.3f}s\n",
+             count, (static_cast<double>(duration.count()) / 1e6));
+  fmt::print("Projected number of solutions per second: {}\n",
+             static_cast<double>(count) / ((static_cast<double>(duration.count()) / 1e6)));
+
+  count = 0; // reset counter
+  double checksum = 0.;
+  start = high_resolution_clock::now();
+  for (auto i = 0u; i < trials; ++i) {
+    kep3::lambert_problem lp(r1s[i], r2s[i], tof[i], mu[i], cw[i], 0u);
+    std::array<double, 7> p{r1s[i][0], r1s[i][1], r1s[i][2], r2s[i][0],
+                            r2s[i][1], r2s[i][2], tof[i]};
+    for (auto k = 0u; k < 7u; ++k) {
+      auto pp = p, pm = p;
+      pp[k] += 1e-6;
+      pm[k] -= 1e-6;
+      kep3::lambert_problem lpp({pp[0], pp[1], pp[2]}, {pp[3], pp[4], pp[5]},
+                                pp[6], mu[i], cw[i], 0u);
+      kep3::lambert_problem lpm({pm[0], pm[1], pm[2]}, {pm[3], pm[4], pm[5]},
+                                pm[6], mu[i], cw[i], 0u);
+      checksum += lpp.get_v1_span()[0][0] - lpm.get_v1_span()[0][0];
+    }
+    count += lp.get_v1_span().size();
+  }
+  stop = high_resolution_clock::now();
+  duration = duration_cast<microseconds>(stop - start);
+  fmt::print("\nLambert with finite differences sensitivities (0 revs only):\n{} solutions computed in {:.3f}s (checksum {:.3e})\n",
+             count, (static_cast<double>(duration.count()) / 1e6), checksum);
+  fmt::print("Projected number of solutions per second: {}\n",
+             static_cast<double>(count) / ((static_cast<double>(duration.count()) / 1e6)));
+
+  // 6 - Minimum DV solution between bodies on random, nearly coplanar,
+  // circular orbits, exhaustively and with the pruned branch search. Longer
+  // times of flight are used here so that many revolutions are feasible.
+  std::uniform_real_distribution<double> R_d(0.8, 1.6);
+  std::uniform_real_distribution<double> theta_d(0., 2. * kep3::pi);
+  std::uniform_real_distribution<double> z_d(-0.05, 0.05);
+  std::uniform_real_distribution<double> tof_long_d(20., 100.);
+  std::vector<std::array<double, 3>> r_deps(trials), r_arrs(trials), v_deps(trials),
+      v_arrs(trials);
+  std::vector<double> tof_long(trials);
+  auto circular = [&](std::array<double, 3> &r, std::array<double, 3> &v) {
+    const double R = R_d(rng_engine), theta = theta_d(rng_engine);
+    r = {R * std::cos(theta), R * std::sin(theta), z_d(rng_engine)};
+    v = {-std::sin(theta) / std::sqrt(R), std::cos(theta) / std::sqrt(R), 0.};
+  };
+  for (auto i = 0u; i < trials; ++i) {
+    circular(r_deps[i], v_deps[i]);
+    circular(r_arrs[i], v_arrs[i]);
+    tof_long[i] = tof_long_d(rng_engine);
+  }
+  auto dv = [](const std::array<double, 3> &a, const std::array<double, 3> &b) {
+    return std::sqrt((a[0] - b[0]) * (a[0] - b[0]) + (a[1] - b[1]) * (a[1] - b[1]) +
+                     (a[2] - b[2]) * (a[2] - b[2]));
+  };
+  double dv_tot = 0.;
+  start = high_resolution_clock::now();
+  for (auto i = 0u; i < trials; ++i) {
+    kep3::lambert_problem lp(r_deps[i], r_arrs[i], tof_long[i], 1., false, revs_max);
+    double best = std::numeric_limits<double>::infinity();
+    for (decltype(lp.get_v1_span().size()) j = 0u; j < lp.get_v1_span().size(); ++j) {
+      best = std::min(best, dv(lp.get_v1_span()[j], v_deps[i]) + dv(lp.get_v2_span()[j], v_arrs[i]));
+    }
+    dv_tot += best;
+  }
+  stop = high_resolution_clock::now();
+  duration = duration_cast<microseconds>(stop - start);
+  fmt::print("\nLambert min DV (all branches, {} revs):\n{} problems solved in {:.3f}s (total DV {:.6e})\n",
+             revs_max, trials, (static_cast<double>(duration.count()) / 1e6), dv_tot);
+  fmt::print("Projected number of problems per second: {}\n",
+             static_cast<double>(trials) / ((static_cast<double>(duration.count()) / 1e6)));
+
+  dv_tot = 0.;
+  start = high_resolution_clock::now();
+  for (auto i = 0u; i < trials; ++i) {
+    const auto sol = kep3::lambert_solve_min_dv(r_deps[i], r_arrs[i], tof_long[i], 1., v_deps[i],
+                                                v_arrs[i], false, revs_max);
+    dv_tot += dv(sol.v1, v_deps[i]) + dv(sol.v2, v_arrs[i]);
+  }
+  stop = high_resolution_clock::now();
+  duration = duration_cast<microseconds>(stop - start);
+  fmt::print("\nLambert min DV (pruned branches, {} revs):\n{} problems solved in {:.3f}s (total DV {:.6e})\n",
+             revs_max, trials, (static_cast<double>(duration.count()) / 1e6), dv_tot);
+  fmt::print("Projected number of problems per second: {}\n",
+             static_cast<double>(trials) / ((static_cast<double>(duration.count()) / 1e6)));
+
+  // 7 - Time of flight sweeps between fixed positions (as in a porkchop
+  // column), solved independently and with the continuation of lambert_sweep.
+  {
+    const unsigned n_geo = 1000u, n_tof = 100u;
+    std::vector<double> tof_sweep(n_tof);
+    for (auto j = 0u; j < n_tof; ++j) {
+      tof_sweep[j] = 2. + 38. * j / (n_tof - 1u);
+    }
+    std::vector<double> sx(n_tof), sy(n_tof), sz(n_tof), wx(n_tof), wy(n_tof), wz(n_tof),
+        xs(n_tof);
+    std::vector<kep3::lambert_status> sstatus(n_tof);
+    std::vector<unsigned> siters(n_tof);
+    const kep3::lambert_batch_output sout{sx, sy, sz, wx, wy, wz, sstatus, xs, siters};
+
+    unsigned long iters_tot = 0u;
+    start = high_resolution_clock::now();
+    for (auto i = 0u; i < n_geo; ++i) {
+      for (auto j = 0u; j < n_tof; ++j) {
+        const auto sol = kep3::lambert_solve(r1s[i], r2s[i], tof_sweep[j], 1.);
+        iters_tot += sol.iters;
+      }
+    }
+    stop = high_resolution_clock::now();
+    duration = duration_cast<microseconds>(stop - start);
+    fmt::print("\nLambert tof sweep (independent solves, 0 revs):\n{} solutions computed in {:.3f}s, "
+               "{:.2f} iterations per solution\n",
+               n_geo * n_tof, (static_cast<double>(duration.count()) / 1e6),
+               static_cast<double>(iters_tot) / (n_geo * n_tof));
+    fmt::print("Projected number of solutions per second: {}\n",
+               static_cast<double>(n_geo * n_tof) / ((static_cast<double>(duration.count()) / 1e6)));
+
+    iters_tot = 0u;
+    start = high_resolution_clock::now();
+    for (auto i = 0u; i < n_geo; ++i) {
+      kep3::lambert_sweep(r1s[i], r2s[i], tof_sweep, 1., sout);
+      for (auto j = 0u; j < n_tof; ++j) {
+        iters_tot += siters[j];
+      }
+    }
+    stop = high_resolution_clock::now();
+    duration = duration_cast<microseconds>(stop - start);
+    fmt::print("\nLambert tof sweep (lambert_sweep, 0 revs):\n{} solutions computed in {:.3f}s, "
+               "{:.2f} iterations per solution\n",
+               n_geo * n_tof, (static_cast<double>(duration.count()) / 1e6),
+               static_cast<double>(iters_tot) / (n_geo * n_tof));
+    fmt::print("Projected number of solutions per second: {}\n",
+               static_cast<double>(n_geo * n_tof) / ((static_cast<double>(duration.count()) / 1e6)));
+  }
+
+  // 8 - One departure position to many arrival positions (as in tour or debris
+  // removal planning), with a lambert_problem per target and with
+  // lambert_one_to_many.
+  {
+    const std::array<double, 1> tof_one{10.};
+    count = 0; // reset counter
+    start = high_resolution_clock::now();
+    for (auto i = 0u; i < trials; ++i) {
+      kep3::lambert_problem lp(r1s[0], r2s[i], tof_one[0], 1., false, 0u);
+      count += lp.get_v1_span().size();
+    }
+    stop = high_resolution_clock::now();
+    duration = duration_cast<microseconds>(stop - start);
+    fmt::print("\nLambert one to many (lambert_problem per target, 0 revs):\n{} solutions computed in {:.3f}s\n",
+               count, (static_cast<double>(duration.count()) / 1e6));
+    fmt::print("Projected number of solutions per second: {}\n",
+               static_cast<double>(count) / ((static_cast<double>(duration.count()) / 1e6)));
+
+    start = high_resolution_clock::now();
+    kep3::lambert_one_to_many(r1s[0], r2x, r2y, r2z, tof_one, 1., out);
+    stop = high_resolution_clock::now();
+    duration = duration_cast<microseconds>(stop - start);
+    fmt::print("\nLambert one to many (lambert_one_to_many, 0 revs):\n{} solutions computed in {:.3f}s\n",
+               trials, (static_cast<double>(duration.count()) / 1e6));
+    fmt::print("Projected number of solutions per second: {}\n",
+               static_cast<double>(trials) / ((static_cast<double>(duration.count()) / 1e6)));
+  }
+
+  // 9 - Feasibility of N revolutions close to the minimum time of flight,
+  // iterating on dT/dx = 0 from x = 0 and via the tabulated T_min curve.
+  {
+    std::uniform_real_distribution<double> lambda_d(-1., 1.);
+    std::uniform_int_distribution<unsigned> N_d(1u, 20u);
+    std::uniform_real_distribution<double> dT_d(-0.2, 0.2);
+    std::vector<double> lambdas(trials), Ts(trials);
+    std::vector<unsigned> Ns(trials);
+    for (auto i = 0u; i < trials; ++i) {
+      lambdas[i] = lambda_d(rng_engine);
+      Ns[i] = N_d(rng_engine);
+      Ts[i] = kep3::detail::lambert_T_min(lambdas[i], Ns[i]) + dT_d(rng_engine);
+    }
+    unsigned long feasible = 0u;
+    start = high_resolution_clock::now();
+    for (auto i = 0u; i < trials; ++i) {
+      double x_min = 0.;
+      feasible += !(kep3::detail::lambert_T_min_from(lambdas[i], Ns[i], 0., x_min) > Ts[i]);
+    }
+    stop = high_resolution_clock::now();
+    duration = duration_cast<microseconds>(stop - start);
+    fmt::print("\nLambert N revs feasibility (iterations from x = 0):\n{} checks ({} feasible) in {:.3f}s\n",
+               trials, feasible, (static_cast<double>(duration.count()) / 1e6));
+    fmt::print("Projected number of checks per second: {}\n",
+               static_cast<double>(trials) / ((static_cast<double>(duration.count()) / 1e6)));
+
+    feasible = 0u;
+    start = high_resolution_clock::now();
+    for (auto i = 0u; i < trials; ++i) {
+      feasible += kep3::detail::lambert_T_min_feasible(Ts[i], lambdas[i], Ns[i]);
+    }
+    stop = high_resolution_clock::now();
+    duration = duration_cast<microseconds>(stop - start);
+    fmt::print("\nLambert N revs feasibility (tabulated T_min):\n{} checks ({} feasible) in {:.3f}s\n",
+               trials, feasible, (static_cast<double>(duration.count()) / 1e6));
+    fmt::print("Projected number of checks per second: {}\n",
+               static_cast<double>(trials) / ((static_cast<double>(duration.count()) / 1e6)));
+  }
+
+  // 10 - Initial guesses from the analytic expressions and from the tabulated
+  // solution surface (up to 5 revolutions): distribution of the iterations and
+  // throughput.
+  {
+    const unsigned revs_tab = 5u;
+    // Builds the table outside of the timings.
+    kep3::lambert_problem warmup({1., 0., 0.}, {0., 1., 0.}, 10., 1., false, revs_tab,
+                                 {.tabulated_guess = true});
+    for (bool tabulated : {false, true}) {
+      std::array<unsigned long, 7> hist{};
+      count = 0u;
+      start = high_resolution_clock::now();
+      for (auto i = 0u; i < trials; ++i) {
+        kep3::lambert_problem lp(r1s[i], r2s[i], tof[i], mu[i], cw[i], revs_tab,
+                                 {.tabulated_guess = tabulated});
+        for (auto it : lp.get_iters_span()) {
+          ++hist[std::min(it, 6u)];
+        }
+        count += lp.get_iters_span().size();
+      }
+      stop = high_resolution_clock::now();
+      duration = duration_cast<microseconds>(stop - start);
+      fmt::print("\nLambert ({} initial guess, up to {} revs):\n{} solutions computed in {:.3f}s\n",
+                 tabulated ? "tabulated" : "analytic", revs_tab, count,
+                 (static_cast<double>(duration.count()) / 1e6));
+      fmt::print("Solutions taking 1, 2, 3, 4, 5, 6+ iterations: {}\n",
+                 std::vector<unsigned long>(hist.begin() + 1, hist.end()));
+      fmt::print("Projected number of solutions per second: {}\n",
+                 static_cast<double>(count) / ((static_cast<double>(duration.count()) / 1e6)));
+    }
+  }
+
+  // 11 - Accuracy profiles: throughput and errors of the solutions (up to 5
+  // revolutions), checked by propagating (r1, v1) for tof and comparing with
+  // (r2, v2).
+  {
+    const unsigned revs_acc = 5u;
+    for (auto accuracy : {kep3::lambert_accuracy::fast, kep3::lambert_accuracy::standard,
+                          kep3::lambert_accuracy::precise}) {
+      count = 0u;
+      unsigned long iters_tot = 0u;
+      start = high_resolution_clock::now();
+      for (auto i = 0u; i < trials; ++i) {
+        kep3::lambert_problem lp(r1s[i], r2s[i], tof[i], mu[i], cw[i], revs_acc,
+                                 {.accuracy = accuracy});
+        count += lp.get_v1_span().size();
+        for (auto it : lp.get_iters_span()) {
+          iters_tot += it;
+        }
+      }
+      stop = high_resolution_clock::now();
+      duration = duration_cast<microseconds>(stop - start);
+      std::vector<double> err_r, err_v;
+      for (auto i = 0u; i < trials; i += 10u) {
+        kep3::lambert_problem lp(r1s[i], r2s[i], tof[i], mu[i], cw[i], revs_acc,
+                                 {.accuracy = accuracy});
+        for (decltype(lp.get_v1_span().size()) j = 0u; j < lp.get_v1_span().size(); ++j) {
+          std::array<std::array<double, 3>, 2> pos_vel{r1s[i], lp.get_v1_span()[j]};
+          kep3::propagate_lagrangian(pos_vel, tof[i], mu[i]);
+          double dr = 0., dv = 0., r = 0., v = 0.;
+          for (auto k = 0u; k < 3u; ++k) {
+            dr += (pos_vel[0][k] - r2s[i][k]) * (pos_vel[0][k] - r2s[i][k]);
+            dv += (pos_vel[1][k] - lp.get_v2_span()[j][k]) * (pos_vel[1][k] - lp.get_v2_span()[j][k]);
+            r += r2s[i][k] * r2s[i][k];
+            v += lp.get_v2_span()[j][k] * lp.get_v2_span()[j][k];
+          }
+          err_r.push_back(std::sqrt(dr / r));
+          err_v.push_back(std::sqrt(dv / v));
+        }
+      }
+      std::sort(err_r.begin(), err_r.end());
+      std::sort(err_v.begin(), err_v.end());
+      const char *name = accuracy == kep3::lambert_accuracy::fast
+                             ? "fast"
+                             : (accuracy == kep3::lambert_accuracy::standard ? "standard" : "precise");
+      fmt::print("\nLambert ({} accuracy, up to {} revs):\n{} solutions computed in {:.3f}s, {:.2f} "
+                 "iterations per solution\n",
+                 name, revs_acc, count, (static_cast<double>(duration.count()) / 1e6),
+                 static_cast<double>(iters_tot) / static_cast<double>(count));
+      fmt::print("Projected number of solutions per second: {}\n",
+                 static_cast<double>(count) / ((static_cast<double>(duration.count()) / 1e6)));
+      fmt::print("Propagated arc, relative error on r2 (median, 99%, max): {:.1e} {:.1e} {:.1e}\n",
+                 err_r[err_r.size() / 2u], err_r[err_r.size() * 99u / 100u], err_r.back());
+      fmt::print("Propagated arc, relative error on v2 (median, 99%, max): {:.1e} {:.1e} {:.1e}\n",
+                 err_v[err_v.size() / 2u], err_v[err_v.size() * 99u / 100u], err_v.back());
+    }
+  }
+
+  // 12 - Construction of lambert_problem objects (and a copy of each, as when
+  // storing them in a container): heap allocations and throughput.
+  {
+    std::vector<kep3::lambert_problem> store(1u);
+    for (unsigned revs : {0u, 5u, 20u}) {
+      count = 0u;
+      const auto allocations_start = kep3_benchmarks::allocations();
+      start = high_resolution_clock::now();
+      for (auto i = 0u; i < trials; ++i) {
+        kep3::lambert_problem lp(r1s[i], r2s[i], tof[i], mu[i], cw[i], revs);
+        count += lp.get_v1_span().size();
+        store[0] = lp;
+      }
+      stop = high_resolution_clock::now();
+      duration = duration_cast<microseconds>(stop - start);
+      fmt::print("\nLambert construction and copy (up to {} revs):\n{} objects ({} solutions) in {:.3f}s, {:.2f} "
+                 "allocations per object\n",
+                 revs, trials, count, (static_cast<double>(duration.count()) / 1e6),
+                 static_cast<double>(kep3_benchmarks::allocations() - allocations_start) / trials);
+      fmt::print("Projected number of objects per second: {}\n",
+                 static_cast<double>(trials) / ((static_cast<double>(duration.count()) / 1e6)));
+    }
+  }
+
+  // 13 - High revolution counts (e.g. resonant transfers): long times of
+  // flight with up to 20 revolutions, i.e. up to 41 branches per problem.
+  {
+    std::uniform_real_distribution<double> tof_long_d(100., 200.);
+    std::vector<double> tof_long(trials);
+    for (auto i = 0u; i < trials; ++i) {
+      tof_long[i] = tof_long_d(rng_engine);
+    }
+    count = 0u;
+    start = high_resolution_clock::now();
+    for (auto i = 0u; i < trials; ++i) {
+      kep3::lambert_problem lp(r1s[i], r2s[i], tof_long[i], mu[i], cw[i], 20u);
+      count += lp.get_v1_span().size();
+    }
+    stop = high_resolution_clock::now();
+    duration = duration_cast<microseconds>(stop - start);
+    fmt::print("\nLambert (long tof, up to 20 revs):\n{} solutions computed in {:.3f}s, {:.1f} per problem\n", count,
+               (static_cast<double>(duration.count()) / 1e6), static_cast<double>(count) / trials);
+    fmt::print("Projected number of solutions per second: {}\n",
+               static_cast<double>(count) / ((static_cast<double>(duration.count()) / 1e6)));
+  }
+
+  // 14 - Bounds queries (no solve) against the full solution, with up to 5
+  // revolutions. The DV lower bound is compared with the best DV of the
+  // solutions, for random velocities of the departure and arrival bodies.
+  {
+    std::uniform_real_distribution<double> v_d(-1, 1);
+    std::vector<std::array<double, 3>> v_dep(trials), v_arr(trials);
+    for (auto i = 0u; i < trials; ++i) {
+      v_dep[i] = {v_d(rng_engine), v_d(rng_engine), v_d(rng_engine)};
+      v_arr[i] = {v_d(rng_engine), v_d(rng_engine), v_d(rng_engine)};
+    }
+    std::vector<double> dv_min(trials), dv_bound(trials);
+    start = high_resolution_clock::now();
+    for (auto i = 0u; i < trials; ++i) {
+      kep3::lambert_problem lp(r1s[i], r2s[i], tof[i], mu[i], cw[i], 5u);
+      dv_min[i] = std::numeric_limits<double>::max();
+      for (auto j = 0u; j < lp.get_v1_span().size(); ++j) {
+        double dv1 = 0., dv2 = 0.;
+        for (auto k = 0u; k < 3u; ++k) {
+          dv1 += (lp.get_v1_span()[j][k] - v_dep[i][k]) * (lp.get_v1_span()[j][k] - v_dep[i][k]);
+          dv2 += (lp.get_v2_span()[j][k] - v_arr[i][k]) * (lp.get_v2_span()[j][k] - v_arr[i][k]);
+        }
+        dv_min[i] = std::min(dv_min[i], std::sqrt(dv1) + std::sqrt(dv2));
+      }
+    }
+    stop = high_resolution_clock::now();
+    const auto duration_solve = duration_cast<microseconds>(stop - start);
+    fmt::print("\nLambert solve and best DV (up to 5 revs):\n{} problems in {:.3f}s\n", trials,
+               (static_cast<double>(duration_solve.count()) / 1e6));
+
+    count = 0u;
+    start = high_resolution_clock::now();
+    for (auto i = 0u; i < trials; ++i) {
+      count += kep3::lambert_Nmax(r1s[i], r2s[i], tof[i], mu[i], cw[i], 5u);
+    }
+    stop = high_resolution_clock::now();
+    duration = duration_cast<microseconds>(stop - start);
+    fmt::print("Nmax query: {} problems in {:.3f}s ({:.1f}x cheaper, {} revolutions in total)\n", trials,
+               (static_cast<double>(duration.count()) / 1e6),
+               static_cast<double>(duration_solve.count()) / static_cast<double>(duration.count()), count);
+
+    start = high_resolution_clock::now();
+    for (auto i = 0u; i < trials; ++i) {
+      dv_bound[i] = kep3::lambert_dv_lower_bound(r1s[i], r2s[i], tof[i], mu[i], v_dep[i], v_arr[i], cw[i], 5u);
+    }
+    stop = high_resolution_clock::now();
+    duration = duration_cast<microseconds>(stop - start);
+    double ratio = 0.;
+    for (auto i = 0u; i < trials; ++i) {
+      ratio += dv_bound[i] / dv_min[i];
+    }
+    fmt::print("DV lower bound: {} problems in {:.3f}s ({:.1f}x cheaper), average bound / best DV: {:.2f}\n",
+               trials, (static_cast<double>(duration.count()) / 1e6),
+               static_cast<double>(duration_solve.count()) / static_cast<double>(duration.count()),
+               ratio / trials);
+  }
+
+  // 15 - Head to head comparison of the Lambert engines, split by number of
+  // revolutions and by transfer angle. The accuracy is measured as the
+  // relative error of v1 with respect to the precise profile of the default
+  // engine.
+  {
+    const std::array<const char *, 4> angle_names = {"0-90", "90-180", "180-270", "270-360"};
+    std::array<std::vector<unsigned>, 4> bins;
+    for (auto i = 0u; i < trials; ++i) {
+      const double cos_dnu = (r1s[i][0] * r2s[i][0] + r1s[i][1] * r2s[i][1] + r1s[i][2] * r2s[i][2])
+                             / std::sqrt(r1s[i][0] * r1s[i][0] + r1s[i][1] * r1s[i][1] + r1s[i][2] * r1s[i][2])
+                             / std::sqrt(r2s[i][0] * r2s[i][0] + r2s[i][1] * r2s[i][1] + r2s[i][2] * r2s[i][2]);
+      double dnu = std::acos(std::clamp(cos_dnu, -1., 1.));
+      const bool hz_negative = r1s[i][0] * r2s[i][1] - r1s[i][1] * r2s[i][0] < 0.;
+      if (hz_negative != cw[i]) {
+        dnu = 2. * kep3::pi - dnu;
+      }
+      bins[std::min(3u, static_cast<unsigned>(dnu / (kep3::pi / 2.)))].push_back(i);
+    }
+    fmt::print("\nLambert engines (izzo vs universal), solutions per second, iterations per solution and "
+               "relative error on v1 (median, max):\n");
+    for (unsigned N = 0u; N <= 2u; ++N) {
+      for (auto b = 0u; b < 4u; ++b) {
+        for (auto engine : {kep3::lambert_engine::izzo, kep3::lambert_engine::universal}) {
+          unsigned long iters_tot = 0u;
+          std::vector<double> err;
+          count = 0u;
+          start = high_resolution_clock::now();
+          for (auto i : bins[b]) {
+            for (bool right : {false, true}) {
+              if (N == 0u && right) {
+                continue;
+              }
+              const auto sol = kep3::lambert_solve(r1s[i], r2s[i], tof[i], mu[i], cw[i], {N, right},
+                                                   kep3::lambert_accuracy::standard, engine);
+              if (sol.status == kep3::lambert_status::success) {
+                ++count;
+                iters_tot += sol.iters;
+              }
+            }
+          }
+          stop = high_resolution_clock::now();
+          duration = duration_cast<microseconds>(stop - start);
+          // Accuracy, outside of the timed loop.
+          for (auto i : bins[b]) {
+            for (bool right : {false, true}) {
+              if (N == 0u && right) {
+                continue;
+              }
+              const auto sol = kep3::lambert_solve(r1s[i], r2s[i], tof[i], mu[i], cw[i], {N, right},
+                                                   kep3::lambert_accuracy::standard, engine);
+              const auto ref = kep3::lambert_solve(r1s[i], r2s[i], tof[i], mu[i], cw[i], {N, right},
+                                                   kep3::lambert_accuracy::precise);
+              if (sol.status == kep3::lambert_status::success && ref.status == kep3::lambert_status::success) {
+                double e2 = 0., n2 = 0.;
+                for (auto k = 0u; k < 3u; ++k) {
+                  e2 += (sol.v1[k] - ref.v1[k]) * (sol.v1[k] - ref.v1[k]);
+                  n2 += ref.v1[k] * ref.v1[k];
+                }
+                err.push_back(std::sqrt(e2 / n2));
+              }
+            }
+          }
+          std::sort(err.begin(), err.end());
+          fmt::print("N = {}, angle {:>7} deg, {:>9}: {:>10.0f} sol/s, {:5.2f} iters, errors {:.1e} {:.1e}\n", N,
+                     angle_names[b], engine == kep3::lambert_engine::izzo ? "izzo" : "universal",
+                     static_cast<double>(count) / ((static_cast<double>(duration.count()) / 1e6)),
+                     static_cast<double>(iters_tot) / static_cast<double>(std::max(count, 1ul)),
+                     err.empty() ? 0. : err[err.size() / 2u], err.empty() ? 0. : err.back());
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,115 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include <kep3/core_astro/constants.hpp>
+#include <kep3/epoch.hpp>
+#include <kep3/lambert_problem.hpp>
+#include <kep3/planet.hpp>
+#include <kep3/planets/jpl_lp.hpp>
+#include <kep3/porkchop.hpp>
+#include <kep3/window_search.hpp>
+
+using std::chrono::duration_cast;
+using std::chrono::high_resolution_clock;
+using std::chrono::microseconds;
+
+// In this benchmark we compute an Earth - Mars porkchop plot, first naively
+// (two ephemerides and one lambert_problem per grid point, on one thread) and
+// then with kep3::porkchop(). Finally, the best window is searched for with
+// kep3::window_search().
+
+double norm_diff(const std::array<double, 3> &a,
+                 const std::array<double, 3> &b) {
+  return std::sqrt((a[0] - b[0]) * (a[0] - b[0]) +
+                   (a[1] - b[1]) * (a[1] - b[1]) +
+                   (a[2] - b[2]) * (a[2] - b[2]));
+}
+
+int main() {
+  const std::size_t n = 1000u;
+  std::vector<double> t_dep(n), t_arr(n);
+  for (auto i = 0u; i < n; ++i) {
+    // Departures over two years from 2030, arrivals 100 to 600 days later.
+    t_dep[i] = 10958. + 730. * i / n;
+    t_arr[i] = t_dep[0] + 100. + (730. + 500.) * i / n;
+  }
+  kep3::planet earth{kep3::udpla::jpl_lp("earth")};
+  kep3::planet mars{kep3::udpla::jpl_lp("mars")};
+  const double mu = earth.get_mu_central_body();
+
+  // 1 - Naive computation.
+  std::vector<double> dv_naive(n * n);
+  auto start = high_resolution_clock::now();
+  for (auto i = 0u; i < n; ++i) {
+    for (auto j = 0u; j < n; ++j) {
+      const double tof = (t_arr[j] - t_dep[i]) * kep3::DAY2SEC;
+      if (tof <= 0.) {
+        dv_naive[i * n + j] = std::nan("");
+        continue;
+      }
+      const auto [r1, v1] = earth.eph(kep3::epoch(t_dep[i]));
+      const auto [r2, v2] = mars.eph(kep3::epoch(t_arr[j]));
+      const kep3::lambert_problem lp(r1, r2, tof, mu, false, 0u);
+      dv_naive[i * n + j] =
+          norm_diff(lp.get_v1_span()[0], v1) + norm_diff(lp.get_v2_span()[0], v2);
+    }
+  }
+  auto stop = high_resolution_clock::now();
+  auto duration = duration_cast<microseconds>(stop - start);
+  const double t_naive = static_cast<double>(duration.count()) / 1e6;
+  fmt::print("Naive porkchop ({}x{}): {:.3f}s\n", n, n, t_naive);
+
+  // 2 - Porkchop engine.
+  start = high_resolution_clock::now();
+  const auto res = kep3::porkchop(earth, mars, t_dep, t_arr);
+  stop = high_resolution_clock::now();
+  duration = duration_cast<microseconds>(stop - start);
+  const double t_engine = static_cast<double>(duration.count()) / 1e6;
+  double err = 0.;
+  for (auto k = 0u; k < n * n; ++k) {
+    if (!std::isnan(dv_naive[k])) {
+      err = std::max(err, std::abs(res.dv[k] - dv_naive[k]) / dv_naive[k]);
+    }
+  }
+  fmt::print("kep3::porkchop ({}x{}, {} threads): {:.3f}s ({:.1f}x faster), "
+             "max relative difference on the DV: {:.1e}\n",
+             n, n, std::thread::hardware_concurrency(), t_engine,
+             t_naive / t_engine, err);
+
+  // 3 - Adaptive window search, against the best cell of the grid with a
+  // time of flight between 100 and 500 days.
+  double dv_grid = 1e300;
+  for (auto i = 0u; i < n; ++i) {
+    for (auto j = 0u; j < n; ++j) {
+      const double tof = t_arr[j] - t_dep[i];
+      if (tof >= 100. && tof <= 500. && res.dv[i * n + j] < dv_grid) {
+        dv_grid = res.dv[i * n + j];
+      }
+    }
+  }
+  start = high_resolution_clock::now();
+  const auto ws =
+      kep3::window_search(earth, mars, {t_dep[0], t_dep[0] + 730.},
+                          {100., 500.});
+  stop = high_resolution_clock::now();
+  duration = duration_cast<microseconds>(stop - start);
+  fmt::print("kep3::window_search: {:.3f}s, {} Lambert problems, best DV "
+             "{:.3f} m/s (grid: {:.3f} m/s), {} windows\n",
+             static_cast<double>(duration.count()) / 1e6, ws.n_lambert,
+             ws.windows[0].dv, dv_grid, ws.windows.size());
+}
@@ -8,16 +8,17 @@
 // with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
 
 #include <chrono>
+#include <functional>
 #include <iostream>
 #include <kep3/core_astro/ic2par2ic.hpp>
 #include <kep3/core_astro/propagate_lagrangian.hpp>
 #include <random>
 
+#include <boost/math/constants/constants.hpp>
 #include <fmt/core.h>
 #include <fmt/ranges.h>
 
 #include <kep3/core_astro/convert_anomalies.hpp>
-#include <xtensor/xtensor.hpp>
 
 using std::chrono::duration_cast;
 using std::chrono::high_resolution_clock;
@@ -0,0 +1,93 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include <kep3/core_astro/constants.hpp>
+#include <kep3/core_astro/ic2eq2ic.hpp>
+#include <kep3/core_astro/ic2par2ic.hpp>
+#include <kep3/core_astro/propagate_lagrangian.hpp>
+#include <kep3/core_astro/propagate_meq.hpp>
+
+using std::chrono::duration_cast;
+using std::chrono::high_resolution_clock;
+using std::chrono::microseconds;
+
+// In this benchmark we test the speed of the propagation of the modified
+// equinoctial elements, directly with kep3::propagate_meq() and through the
+// cartesian state (eq2ic, propagate_lagrangian and ic2eq).
+
+void perform_test_speed(double min_ecc, double max_ecc, unsigned N) {
+  // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+  std::mt19937 rng_engine(122012203u);
+  std::uniform_real_distribution<double> sma_d(0.5, 20.);
+  std::uniform_real_distribution<double> ecc_d(min_ecc, max_ecc);
+  std::uniform_real_distribution<double> incl_d(0., kep3::pi);
+  std::uniform_real_distribution<double> angle_d(0., 2 * kep3::pi);
+  std::uniform_real_distribution<double> tof_d(10., 100.);
+
+  // We generate the random dataset.
+  std::vector<std::array<double, 6>> eqs(N);
+  std::vector<double> tofs(N);
+  for (auto i = 0u; i < N; ++i) {
+    eqs[i] = kep3::ic2eq(
+        kep3::par2ic({sma_d(rng_engine), ecc_d(rng_engine), incl_d(rng_engine),
+                      angle_d(rng_engine), angle_d(rng_engine),
+                      angle_d(rng_engine)},
+                     1.),
+        1.);
+    tofs[i] = tof_d(rng_engine);
+  }
+
+  fmt::print("{:.2f} min_ecc, {:.2f} max_ecc, on {} data points: ", min_ecc,
+             max_ecc, N);
+  auto eqs_rt = eqs;
+  auto start = high_resolution_clock::now();
+  for (auto i = 0u; i < N; ++i) {
+    auto pos_vel = kep3::eq2ic(eqs_rt[i], 1.);
+    kep3::propagate_lagrangian(pos_vel, tofs[i], 1.);
+    eqs_rt[i] = kep3::ic2eq(pos_vel, 1.);
+  }
+  auto stop = high_resolution_clock::now();
+  const auto t_rt = static_cast<double>(
+                        duration_cast<microseconds>(stop - start).count()) /
+                    1e6;
+  auto eqs_meq = eqs;
+  start = high_resolution_clock::now();
+  for (auto i = 0u; i < N; ++i) {
+    kep3::propagate_meq(eqs_meq[i], tofs[i], 1.);
+  }
+  stop = high_resolution_clock::now();
+  const auto t_meq = static_cast<double>(
+                         duration_cast<microseconds>(stop - start).count()) /
+                     1e6;
+  // The two agree on the true longitude (modulo 2pi).
+  double err = 0.;
+  for (auto i = 0u; i < N; ++i) {
+    err = std::max(err, std::abs(std::remainder(eqs_meq[i][5] - eqs_rt[i][5],
+                                                2 * kep3::pi)));
+  }
+  fmt::print("round trip {:.3f}s, propagate_meq {:.3f}s ({:.1f}x), max "
+             "difference on L {:.1e}\n",
+             t_rt, t_meq, t_rt / t_meq, err);
+}
+
+int main() {
+  fmt::print("\nComputes speed at different eccentricity ranges:\n");
+  perform_test_speed(0, 0.5, 1000000);
+  perform_test_speed(0.5, 0.9, 1000000);
+  perform_test_speed(0.9, 0.99, 1000000);
+}
@@ -11,6 +11,8 @@
 #define kep3_CONVERT_ANOMALIES_H
 
 #include <cmath>
+#include <cstddef>
+#include <span>
 #include <stdexcept>
 
 #include <boost/math/constants/constants.hpp>
@@ -192,5 +194,85 @@ inline double f2n(double f, double ecc) {
   return h2n(f2h(f, ecc), ecc);
 }
 
+// Batch versions of the conversions above. They write in out the conversion
+// of each element of the first argument with the corresponding eccentricity.
+// Either input can also have size one, in which case its value is used for all
+// the elements of out (as it is typically the case for the eccentricity).
+namespace detail {
+template <typename F>
+inline void anomaly_batch(const F &conversion, std::span<const double> anomaly,
+                          std::span<const double> ecc, std::span<double> out) {
+  const std::size_t n = out.size();
+  if ((anomaly.size() != n && anomaly.size() != 1u) ||
+      (ecc.size() != n && ecc.size() != 1u)) {
+    throw std::invalid_argument(
+        "Inconsistent sizes passed to a batch anomaly conversion: the inputs "
+        "must have either the same size as the output or size one.");
+  }
+  const std::size_t sa = (anomaly.size() == 1u) ? 0u : 1u;
+  const std::size_t se = (ecc.size() == 1u) ? 0u : 1u;
+  for (std::size_t i = 0u; i < n; ++i) {
+    out[i] = conversion(anomaly[i * sa], ecc[i * se]);
+  }
+}
+} // namespace detail
+
+inline void m2e_v(std::span<const double> M, std::span<const double> ecc,
+                  std::span<double> out) {
+  detail::anomaly_batch(m2e, M, ecc, out);
+}
+inline void e2m_v(std::span<const double> E, std::span<const double> ecc,
+                  std::span<double> out) {
+  detail::anomaly_batch(e2m, E, ecc, out);
+}
+inline void e2f_v(std::span<const double> E, std::span<const double> ecc,
+                  std::span<double> out) {
+  detail::anomaly_batch(e2f, E, ecc, out);
+}
+inline void f2e_v(std::span<const double> f, std::span<const double> ecc,
+                  std::span<double> out) {
+  detail::anomaly_batch(f2e, f, ecc, out);
+}
+inline void m2f_v(std::span<const double> M, std::span<const double> ecc,
+                  std::span<double> out) {
+  detail::anomaly_batch(m2f, M, ecc, out);
+}
+inline void f2m_v(std::span<const double> f, std::span<const double> ecc,
+                  std::span<double> out) {
+  detail::anomaly_batch(f2m, f, ecc, out);
+}
+inline void zeta2f_v(std::span<const double> zeta, std::span<const double> ecc,
+                     std::span<double> out) {
+  detail::anomaly_batch(zeta2f, zeta, ecc, out);
+}
+inline void f2zeta_v(std::span<const double> f, std::span<const double> ecc,
+                     std::span<double> out) {
+  detail::anomaly_batch(f2zeta, f, ecc, out);
+}
+inline void n2h_v(std::span<const double> N, std::span<const double> ecc,
+                  std::span<double> out) {
+  detail::anomaly_batch(n2h, N, ecc, out);
+}
+inline void h2n_v(std::span<const double> H, std::span<const double> ecc,
+                  std::span<double> out) {
+  detail::anomaly_batch(h2n, H, ecc, out);
+}
+inline void h2f_v(std::span<const double> H, std::span<const double> ecc,
+                  std::span<double> out) {
+  detail::anomaly_batch(h2f, H, ecc, out);
+}
+inline void f2h_v(std::span<const double> f, std::span<const double> ecc,
+                  std::span<double> out) {
+  detail::anomaly_batch(f2h, f, ecc, out);
+}
+inline void n2f_v(std::span<const double> N, std::span<const double> ecc,
+                  std::span<double> out) {
+  detail::anomaly_batch(n2f, N, ecc, out);
+}
+inline void f2n_v(std::span<const double> f, std::span<const double> ecc,
+                  std::span<double> out) {
+  detail::anomaly_batch(f2n, f, ecc, out);
+}
+
 } // namespace kep3
 #endif // kep3_TOOLBOX_M2E_H
@@ -0,0 +1,124 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef kep3_CONVERT_ELEMENTS_H
+#define kep3_CONVERT_ELEMENTS_H
+
+#include <array>
+
+#include <kep3/core_astro/constants.hpp>
+#include <kep3/core_astro/convert_anomalies.hpp>
+#include <kep3/core_astro/elements_batch.hpp>
+#include <kep3/core_astro/eq2par2eq.hpp>
+#include <kep3/core_astro/ic2eq2ic.hpp>
+#include <kep3/core_astro/ic2par2ic.hpp>
+#include <kep3/detail/visibility.hpp>
+
+namespace kep3 {
+
+namespace detail {
+inline std::array<std::array<double, 3>, 2>
+posvel_split(const std::array<double, 6> &x) {
+  return {{{x[0], x[1], x[2]}, {x[3], x[4], x[5]}}};
+}
+inline std::array<double, 6>
+posvel_flat(const std::array<std::array<double, 3>, 2> &pos_vel) {
+  return {pos_vel[0][0], pos_vel[0][1], pos_vel[0][2],
+          pos_vel[1][0], pos_vel[1][1], pos_vel[1][2]};
+}
+} // namespace detail
+
+/// Conversion between two element sets
+/**
+ * Converts x from the element set From to the element set To, the pair being
+ * selected at compile time. The position and velocity (POSVEL) are ordered as
+ * x, y, z, vx, vy, vz. Each pair is converted along the shortest closed form
+ * path: the Keplerian and equinoctial elements are converted into each other
+ * without computing the cartesian state, the prograde and retrograde
+ * equinoctial elements without computing the Keplerian ones and the mean and
+ * true anomalies without touching the other elements. The gravity parameter
+ * mu is only used by the conversions from and to POSVEL.
+ *
+ * It throws the same exceptions as the underlying conversions, in particular
+ * std::domain_error if the mean anomaly (KEP_M) is requested for, or given
+ * with, an orbit that is not an ellipse.
+ *
+ * \param[in] x the elements (or the state) to convert.
+ * \param[in] mu the gravity parameter.
+ *
+ * \return the converted elements (or state).
+ */
+template <elements_type From, elements_type To>
+inline std::array<double, 6> convert(const std::array<double, 6> &x,
+                                     double mu) {
+  static_assert(From >= KEP_M && From <= POSVEL && To >= KEP_M &&
+                    To <= POSVEL,
+                "convert: invalid element type");
+  if constexpr (From == To) {
+    return x;
+  } else if constexpr (From == KEP_M) {
+    auto par = x;
+    par[5] = m2f(x[5], x[1]);
+    return convert<KEP_F, To>(par, mu);
+  } else if constexpr (To == KEP_M) {
+    auto par = convert<From, KEP_F>(x, mu);
+    par[5] = f2m(par[5], par[1]);
+    return par;
+  } else if constexpr (From == POSVEL) {
+    if constexpr (To == KEP_F) {
+      return ic2par(detail::posvel_split(x), mu);
+    } else {
+      return ic2eq(detail::posvel_split(x), mu, To == MEQ_R);
+    }
+  } else if constexpr (To == POSVEL) {
+    if constexpr (From == KEP_F) {
+      return detail::posvel_flat(par2ic(x, mu));
+    } else {
+      return detail::posvel_flat(eq2ic(x, mu, From == MEQ_R));
+    }
+  } else if constexpr (From == KEP_F) {
+    return par2eq(x, To == MEQ_R);
+  } else if constexpr (To == KEP_F) {
+    return eq2par(x, From == MEQ_R);
+  } else if constexpr (From == MEQ) {
+    return eq2eq_r(x);
+  } else {
+    return eq_r2eq(x);
+  }
+}
+
+// Version of convert() with the element sets selected at runtime, through a
+// table of the compile time conversions. It also throws std::invalid_argument
+// if from or to is not a valid elements_type.
+kep3_DLL_PUBLIC std::array<double, 6> convert(const std::array<double, 6> &x,
+                                              elements_type from,
+                                              elements_type to, double mu);
+
+// Batch version of convert(), along the same paths as the scalar one but
+// through the conversions in elements_batch.hpp. As these, it never throws on
+// invalid states, returning NaNs instead (in particular for the mean anomaly
+// of an orbit that is not an ellipse). It throws std::invalid_argument if
+// from or to is not a valid elements_type or if the spans do not all have the
+// same size. The input and output spans can be the same.
+kep3_DLL_PUBLIC void convert_batch(const elements_batch_input &in,
+                                   elements_type from, elements_type to,
+                                   double mu, const elements_batch_output &out);
+
+template <elements_type From, elements_type To>
+inline void convert_batch(const elements_batch_input &in, double mu,
+                          const elements_batch_output &out) {
+  static_assert(From >= KEP_M && From <= POSVEL && To >= KEP_M &&
+                    To <= POSVEL,
+                "convert_batch: invalid element type");
+  convert_batch(in, From, To, mu, out);
+}
+
+} // namespace kep3
+
+#endif // kep3_CONVERT_ELEMENTS_H
@@ -0,0 +1,64 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef kep3_ELEMENTS_BATCH_H
+#define kep3_ELEMENTS_BATCH_H
+
+#include <array>
+#include <span>
+
+#include <kep3/detail/visibility.hpp>
+
+namespace kep3 {
+
+/// A batch of states or elements in SoA form (input)
+/**
+ * Six spans of the same size: the cartesian states (x, y, z, vx, vy, vz) or
+ * the six elements, in the same order as in the scalar conversions, each
+ * index identifying one state.
+ */
+using elements_batch_input = std::array<std::span<const double>, 6>;
+
+/// A batch of states or elements in SoA form (output)
+using elements_batch_output = std::array<std::span<double>, 6>;
+
+// Batch versions of ic2par(), par2ic(), ic2eq(), eq2ic(), par2eq() and
+// eq2par(), converting many states with the same central body at once. The
+// states are processed a few at a time with the branches of the scalar
+// conversions replaced by selections, so that the arithmetic can be mapped
+// onto SIMD instructions, and without the temporaries of the scalar
+// versions. The results agree with those of the scalar conversions to
+// within a few ulps. They never throw on invalid states: where the scalar
+// par2ic() throws std::domain_error the batch version returns NaNs. They
+// throw std::invalid_argument if the spans do not all have the same size.
+kep3_DLL_PUBLIC void ic2par_batch(const elements_batch_input &pos_vel,
+                                  double mu, const elements_batch_output &par);
+
+kep3_DLL_PUBLIC void par2ic_batch(const elements_batch_input &par, double mu,
+                                  const elements_batch_output &pos_vel);
+
+kep3_DLL_PUBLIC void ic2eq_batch(const elements_batch_input &pos_vel,
+                                 double mu, const elements_batch_output &eq,
+                                 bool retrogade = false);
+
+kep3_DLL_PUBLIC void eq2ic_batch(const elements_batch_input &eq, double mu,
+                                 const elements_batch_output &pos_vel,
+                                 bool retrogade = false);
+
+kep3_DLL_PUBLIC void par2eq_batch(const elements_batch_input &par,
+                                  const elements_batch_output &eq,
+                                  bool retrogade = false);
+
+kep3_DLL_PUBLIC void eq2par_batch(const elements_batch_input &eq,
+                                  const elements_batch_output &par,
+                                  bool retrogade = false);
+
+} // namespace kep3
+
+#endif // kep3_ELEMENTS_BATCH_H
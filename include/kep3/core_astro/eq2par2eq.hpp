@@ -17,6 +17,7 @@
 #define kep3_EQ2PAR2EQ_H
 
 #include <array>
+#include <utility>
 
 #include <kep3/detail/visibility.hpp>
 
@@ -28,5 +29,24 @@ kep3_DLL_PUBLIC std::array<double, 6> eq2par(const std::array<double, 6> &eq,
 kep3_DLL_PUBLIC std::array<double, 6> par2eq(const std::array<double, 6> &par,
                                              bool retrogade = false);
 
+// From prograde to retrograde modified equinoctial elements and back, in
+// closed form (without computing the Keplerian elements).
+kep3_DLL_PUBLIC std::array<double, 6> eq2eq_r(const std::array<double, 6> &eq);
+
+kep3_DLL_PUBLIC std::array<double, 6>
+eq_r2eq(const std::array<double, 6> &eq_r);
+
+// Versions of eq2par() and par2eq() also returning the Jacobian of the
+// conversion, element (i, j) being the derivative of the i-th output with
+// respect to the j-th input, computed exactly by forward mode automatic
+// differentiation.
+kep3_DLL_PUBLIC
+std::pair<std::array<double, 6>, std::array<std::array<double, 6>, 6>>
+eq2par_jac(const std::array<double, 6> &eq, bool retrogade = false);
+
+kep3_DLL_PUBLIC
+std::pair<std::array<double, 6>, std::array<std::array<double, 6>, 6>>
+par2eq_jac(const std::array<double, 6> &par, bool retrogade = false);
+
 } // namespace kep3
 #endif // kep3_EQ2PAR2EQ_H
\ No newline at end of file
@@ -0,0 +1,115 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef kep3_EVENT_TIMES_H
+#define kep3_EVENT_TIMES_H
+
+#include <array>
+#include <span>
+
+#include <kep3/core_astro/elements_batch.hpp>
+#include <kep3/detail/visibility.hpp>
+
+namespace kep3 {
+
+/// Time of flight between two true anomalies
+/**
+ * Computes, in closed form through the mean anomalies, the time taken by a
+ * body on a Keplerian orbit to go from the true anomaly f0 to the true
+ * anomaly f1. On ellipses (0 <= ecc < 1, sma > 0) the motion is periodic and
+ * the time returned is that of the next passage through f1, between zero and
+ * the orbital period. On hyperbolas (ecc > 1, sma < 0) it is NaN if
+ * f1 comes before f0 or if either anomaly lies outside the asymptotes, as
+ * the body then never gets there. Parabolas, and inconsistent values of sma
+ * and ecc, also give NaN.
+ *
+ * \param[in] f0 the initial true anomaly.
+ * \param[in] f1 the final true anomaly.
+ * \param[in] sma the semi-major axis.
+ * \param[in] ecc the eccentricity.
+ * \param[in] mu the gravity parameter.
+ *
+ * @return the time of flight.
+ */
+kep3_DLL_PUBLIC double time_of_flight(double f0, double f1, double sma,
+                                      double ecc, double mu);
+
+// Times from the cartesian state pos_vel to the next passage through an
+// event of its osculating orbit: the true anomaly f, the periapsis, the
+// apoapsis, the ascending and descending nodes on the reference plane, and
+// the radius R (the first of its two crossings). They are computed with
+// ic2par() and time_of_flight(), so that they are exact for Keplerian
+// motion and, as time_of_flight(), return NaN when the event never happens
+// (e.g. the apoapsis of a hyperbola, the nodes of an equatorial orbit or a
+// radius that is never reached). On (nearly) circular orbits the true
+// anomaly, and thus the times to the apsides, are ill-conditioned.
+kep3_DLL_PUBLIC double
+time_to_true_anomaly(const std::array<std::array<double, 3>, 2> &pos_vel,
+                     double f, double mu);
+
+kep3_DLL_PUBLIC double
+time_to_periapsis(const std::array<std::array<double, 3>, 2> &pos_vel,
+                  double mu);
+
+kep3_DLL_PUBLIC double
+time_to_apoapsis(const std::array<std::array<double, 3>, 2> &pos_vel,
+                 double mu);
+
+kep3_DLL_PUBLIC double
+time_to_ascending_node(const std::array<std::array<double, 3>, 2> &pos_vel,
+                       double mu);
+
+kep3_DLL_PUBLIC double
+time_to_descending_node(const std::array<std::array<double, 3>, 2> &pos_vel,
+                        double mu);
+
+kep3_DLL_PUBLIC double
+time_to_radius(const std::array<std::array<double, 3>, 2> &pos_vel, double R,
+               double mu);
+
+// Batch versions of the functions above, on many states with the same
+// central body. The states are in SoA form, as in elements_batch.hpp, and the
+// times are written in out. The osculating elements are computed with
+// ic2par_batch(). The other inputs (f, R, and f0, f1, sma and ecc in
+// time_of_flight_batch()) can either have the same size as out or size one,
+// in which case their value is used for all the states. They throw
+// std::invalid_argument on inconsistent sizes.
+kep3_DLL_PUBLIC void time_of_flight_batch(std::span<const double> f0,
+                                          std::span<const double> f1,
+                                          std::span<const double> sma,
+                                          std::span<const double> ecc,
+                                          double mu, std::span<double> out);
+
+kep3_DLL_PUBLIC void
+time_to_true_anomaly_batch(const elements_batch_input &pos_vel,
+                           std::span<const double> f, double mu,
+                           std::span<double> out);
+
+kep3_DLL_PUBLIC void
+time_to_periapsis_batch(const elements_batch_input &pos_vel, double mu,
+                        std::span<double> out);
+
+kep3_DLL_PUBLIC void time_to_apoapsis_batch(const elements_batch_input &pos_vel,
+                                            double mu, std::span<double> out);
+
+kep3_DLL_PUBLIC void
+time_to_ascending_node_batch(const elements_batch_input &pos_vel, double mu,
+                             std::span<double> out);
+
+kep3_DLL_PUBLIC void
+time_to_descending_node_batch(const elements_batch_input &pos_vel, double mu,
+                              std::span<double> out);
+
+kep3_DLL_PUBLIC void time_to_radius_batch(const elements_batch_input &pos_vel,
+                                          std::span<const double> R, double mu,
+                                          std::span<double> out);
+
+} // namespace kep3
+
+#endif // kep3_EVENT_TIMES_H
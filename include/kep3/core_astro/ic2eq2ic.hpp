@@ -17,6 +17,7 @@
 #define kep3_IC2EQ2IC_H
 
 #include <array>
+#include <utility>
 
 #include <kep3/detail/visibility.hpp>
 
@@ -29,5 +30,18 @@ ic2eq(const std::array<std::array<double, 3>, 2> &pos_vel, double mu,
 kep3_DLL_PUBLIC std::array<std::array<double, 3>, 2>
 eq2ic(const std::array<double, 6> &eq, double mu, bool retrogade = false);
 
+// Versions of ic2eq() and eq2ic() also returning the Jacobian of the
+// conversion, element (i, j) being the derivative of the i-th output with
+// respect to the j-th input (the cartesian states being ordered as x, y, z,
+// vx, vy, vz), computed exactly by forward mode automatic differentiation.
+kep3_DLL_PUBLIC
+std::pair<std::array<double, 6>, std::array<std::array<double, 6>, 6>>
+ic2eq_jac(const std::array<std::array<double, 3>, 2> &pos_vel, double mu,
+          bool retrogade = false);
+
+kep3_DLL_PUBLIC std::pair<std::array<std::array<double, 3>, 2>,
+                          std::array<std::array<double, 6>, 6>>
+eq2ic_jac(const std::array<double, 6> &eq, double mu, bool retrogade = false);
+
 } // namespace kep3
 #endif // kep3_IC2EQ2IC_H
\ No newline at end of file
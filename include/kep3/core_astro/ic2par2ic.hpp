@@ -17,6 +17,7 @@
 #define kep3_IC2PAR2IC_H
 
 #include <array>
+#include <utility>
 
 #include <kep3/detail/visibility.hpp>
 
@@ -26,5 +27,18 @@ ic2par(const std::array<std::array<double, 3>, 2> &pos_vel, double mu);
 
 kep3_DLL_PUBLIC std::array<std::array<double, 3>, 2>
 par2ic(const std::array<double, 6> &par, double mu);
+
+// Versions of ic2par() and par2ic() also returning the Jacobian of the
+// conversion, element (i, j) being the derivative of the i-th output with
+// respect to the j-th input (the cartesian states being ordered as x, y, z,
+// vx, vy, vz). The derivatives are exact, as they are computed in a single
+// evaluation of the conversion by forward mode automatic differentiation.
+kep3_DLL_PUBLIC
+std::pair<std::array<double, 6>, std::array<std::array<double, 6>, 6>>
+ic2par_jac(const std::array<std::array<double, 3>, 2> &pos_vel, double mu);
+
+kep3_DLL_PUBLIC std::pair<std::array<std::array<double, 3>, 2>,
+                          std::array<std::array<double, 6>, 6>>
+par2ic_jac(const std::array<double, 6> &par, double mu);
 } // namespace kep3
 #endif // kep3_IC2PAR2IC_H
\ No newline at end of file
@@ -0,0 +1,49 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef kep3_JIT_BATCH_H
+#define kep3_JIT_BATCH_H
+
+#include <span>
+
+#include <kep3/core_astro/elements_batch.hpp>
+#include <kep3/detail/visibility.hpp>
+
+namespace kep3 {
+
+// Batch versions of par2ic(), eq2ic() and, for ellipses, of
+// propagate_lagrangian(), JIT-compiled by heyoka from a symbolic description
+// of the scalar code (Kepler's equation being solved by heyoka's kepDE()).
+// The kernels are vectorised for the host CPU and the states are split among
+// threads. Each kernel is compiled on its first use and then cached for the
+// lifetime of the process, so that the first call is much slower than the
+// following ones. The calls to the same kernel from different threads are
+// serialised, each of them already using all the threads.
+//
+// The states are in SoA form, as in elements_batch.hpp. As the other batch
+// conversions, they never throw on invalid states (e.g. a hyperbola given to
+// propagate_lagrangian_jit_batch()), returning NaNs or meaningless values
+// instead, and throw std::invalid_argument if the spans do not all have the
+// same size.
+kep3_DLL_PUBLIC void par2ic_jit_batch(const elements_batch_input &par,
+                                      double mu,
+                                      const elements_batch_output &pos_vel);
+
+kep3_DLL_PUBLIC void eq2ic_jit_batch(const elements_batch_input &eq, double mu,
+                                     const elements_batch_output &pos_vel,
+                                     bool retrogade = false);
+
+kep3_DLL_PUBLIC void
+propagate_lagrangian_jit_batch(const elements_batch_input &pos_vel,
+                               std::span<const double> dt, double mu,
+                               const elements_batch_output &pos_vel_new);
+
+} // namespace kep3
+
+#endif // kep3_JIT_BATCH_H
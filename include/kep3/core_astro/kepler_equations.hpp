@@ -55,6 +55,21 @@ inline double dd_kepDE(double DE, double sigma0, double sqrta, double a,
   return sigma0 / sqrta * std::cos(DE) + (1 - R / a) * std::sin(DE);
 }
 
+// In terms of the eccentric longitude difference (DF), with
+// s0 = f sin(F0) - g cos(F0) and c0 = f cos(F0) + g sin(F0)
+// -------------------------------------------
+inline double kepDF(double DF, double DM, double s0, double c0) {
+  return -DM + DF + s0 * (1 - std::cos(DF)) - c0 * std::sin(DF);
+}
+
+inline double d_kepDF(double DF, double s0, double c0) {
+  return 1 + s0 * std::sin(DF) - c0 * std::cos(DF);
+}
+
+inline double dd_kepDF(double DF, double s0, double c0) {
+  return s0 * std::cos(DF) + c0 * std::sin(DF);
+}
+
 // In terms of the hyperbolic anomaly difference (DH)
 // -------------------------------------------
 inline double kepDH(double DH, double DN, double sigma0, double sqrta, double a,
@@ -0,0 +1,44 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef kep3_PROPAGATE_MEQ_H
+#define kep3_PROPAGATE_MEQ_H
+
+#include <array>
+
+#include <kep3/detail/visibility.hpp>
+
+namespace kep3 {
+
+/// Keplerian propagation of the modified equinoctial elements
+/**
+ * This function propagates the modified equinoctial elements (p, f, g, h, k,
+ * L) for a time dt assuming a central body and a keplerian motion, without
+ * passing through the cartesian state. Only the true longitude L changes: on
+ * ellipses it is computed by solving Kepler's equation in the eccentric
+ * longitude F, which is not singular for circular or equatorial orbits. L
+ * is advanced continuously, i.e. it is not reduced to [0, 2pi). On
+ * hyperbolas, where the eccentric longitude is not defined, the elements are
+ * propagated through the cartesian state with kep3::propagate_lagrangian().
+ * All units systems can be used, as long as the input parameters are all
+ * expressed in the same system.
+ *
+ * It throws std::domain_error if Kepler's equation cannot be solved.
+ *
+ * \param[in,out] eq the modified equinoctial elements.
+ * \param[in] dt the propagation time.
+ * \param[in] mu the gravity parameter.
+ * \param[in] retrogade whether the elements are the retrograde ones.
+ */
+kep3_DLL_PUBLIC void propagate_meq(std::array<double, 6> &eq, double dt,
+                                   double mu, bool retrogade = false);
+
+} // namespace kep3
+
+#endif // kep3_PROPAGATE_MEQ_H
@@ -0,0 +1,235 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef kep3_DETAIL_DUAL_HPP
+#define kep3_DETAIL_DUAL_HPP
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+
+// A minimal forward mode automatic differentiation number carrying the
+// derivatives with respect to N independent variables. It supports only the
+// operations needed to differentiate closed form kernels (arithmetic, sqrt,
+// abs and the trigonometric functions); comparisons act on the value only.
+namespace kep3::detail {
+
+template <std::size_t N> struct dual {
+  double v = 0.;
+  std::array<double, N> d{};
+
+  dual() = default;
+  // NOLINTNEXTLINE(google-explicit-constructor, hicpp-explicit-conversions)
+  dual(double value) : v(value) {}
+  dual(double value, const std::array<double, N> &der) : v(value), d(der) {}
+
+  // The i-th independent variable, with value value.
+  static dual variable(double value, std::size_t i) {
+    dual retval(value);
+    retval.d[i] = 1.;
+    return retval;
+  }
+
+  dual &operator+=(const dual &o) {
+    v += o.v;
+    for (std::size_t i = 0u; i < N; ++i) {
+      d[i] += o.d[i];
+    }
+    return *this;
+  }
+  dual &operator-=(const dual &o) {
+    v -= o.v;
+    for (std::size_t i = 0u; i < N; ++i) {
+      d[i] -= o.d[i];
+    }
+    return *this;
+  }
+  dual &operator*=(const dual &o) {
+    for (std::size_t i = 0u; i < N; ++i) {
+      d[i] = d[i] * o.v + v * o.d[i];
+    }
+    v *= o.v;
+    return *this;
+  }
+  // NOTE: the value is computed as in double arithmetic, so that evaluating a
+  // kernel on duals does not change its result.
+  dual &operator/=(const dual &o) {
+    const double inv = 1. / o.v;
+    v /= o.v;
+    for (std::size_t i = 0u; i < N; ++i) {
+      d[i] = (d[i] - v * o.d[i]) * inv;
+    }
+    return *this;
+  }
+};
+
+template <std::size_t N> inline dual<N> operator-(dual<N> a) {
+  a.v = -a.v;
+  for (auto &der : a.d) {
+    der = -der;
+  }
+  return a;
+}
+template <std::size_t N>
+inline dual<N> operator+(dual<N> a, const dual<N> &b) {
+  return a += b;
+}
+template <std::size_t N>
+inline dual<N> operator-(dual<N> a, const dual<N> &b) {
+  return a -= b;
+}
+template <std::size_t N>
+inline dual<N> operator*(dual<N> a, const dual<N> &b) {
+  return a *= b;
+}
+template <std::size_t N>
+inline dual<N> operator/(dual<N> a, const dual<N> &b) {
+  return a /= b;
+}
+template <std::size_t N> inline dual<N> operator+(dual<N> a, double b) {
+  a.v += b;
+  return a;
+}
+template <std::size_t N> inline dual<N> operator+(double a, dual<N> b) {
+  b.v += a;
+  return b;
+}
+template <std::size_t N> inline dual<N> operator-(dual<N> a, double b) {
+  a.v -= b;
+  return a;
+}
+template <std::size_t N> inline dual<N> operator-(double a, const dual<N> &b) {
+  return -b + a;
+}
+template <std::size_t N> inline dual<N> operator*(dual<N> a, double b) {
+  a.v *= b;
+  for (auto &der : a.d) {
+    der *= b;
+  }
+  return a;
+}
+template <std::size_t N> inline dual<N> operator*(double a, const dual<N> &b) {
+  return b * a;
+}
+template <std::size_t N> inline dual<N> operator/(dual<N> a, double b) {
+  a.v /= b;
+  for (auto &x : a.d) {
+    x /= b;
+  }
+  return a;
+}
+template <std::size_t N> inline dual<N> operator/(double a, const dual<N> &b) {
+  return dual<N>(a) / b;
+}
+
+template <std::size_t N> inline dual<N> sqrt(const dual<N> &a) {
+  const double r = std::sqrt(a.v);
+  const double k = 0.5 / r;
+  dual<N> retval(r);
+  for (std::size_t i = 0u; i < N; ++i) {
+    retval.d[i] = k * a.d[i];
+  }
+  return retval;
+}
+
+// The composition with a at a function of value f and derivative df.
+template <std::size_t N>
+inline dual<N> dual_chain(const dual<N> &a, double f, double df) {
+  dual<N> retval(f);
+  for (std::size_t i = 0u; i < N; ++i) {
+    retval.d[i] = df * a.d[i];
+  }
+  return retval;
+}
+
+template <std::size_t N> inline dual<N> abs(const dual<N> &a) {
+  return (a.v < 0) ? -a : a;
+}
+template <std::size_t N> inline dual<N> sin(const dual<N> &a) {
+  return dual_chain(a, std::sin(a.v), std::cos(a.v));
+}
+template <std::size_t N> inline dual<N> cos(const dual<N> &a) {
+  return dual_chain(a, std::cos(a.v), -std::sin(a.v));
+}
+template <std::size_t N> inline dual<N> tan(const dual<N> &a) {
+  const double t = std::tan(a.v);
+  return dual_chain(a, t, 1. + t * t);
+}
+template <std::size_t N> inline dual<N> acos(const dual<N> &a) {
+  return dual_chain(a, std::acos(a.v), -1. / std::sqrt(1. - a.v * a.v));
+}
+template <std::size_t N> inline dual<N> atan(const dual<N> &a) {
+  return dual_chain(a, std::atan(a.v), 1. / (1. + a.v * a.v));
+}
+template <std::size_t N>
+inline dual<N> atan2(const dual<N> &y, const dual<N> &x) {
+  const double r2 = x.v * x.v + y.v * y.v;
+  dual<N> retval(std::atan2(y.v, x.v));
+  for (std::size_t i = 0u; i < N; ++i) {
+    retval.d[i] = (x.v * y.d[i] - y.v * x.d[i]) / r2;
+  }
+  return retval;
+}
+
+template <std::size_t N> inline bool isfinite(const dual<N> &a) {
+  return std::isfinite(a.v);
+}
+
+template <std::size_t N> inline bool operator<(const dual<N> &a, double b) {
+  return a.v < b;
+}
+template <std::size_t N> inline bool operator>(const dual<N> &a, double b) {
+  return a.v > b;
+}
+template <std::size_t N>
+inline bool operator<(const dual<N> &a, const dual<N> &b) {
+  return a.v < b.v;
+}
+template <std::size_t N> inline bool operator==(const dual<N> &a, double b) {
+  return a.v == b;
+}
+template <std::size_t N>
+inline bool operator==(const dual<N> &a, const dual<N> &b) {
+  return a.v == b.v;
+}
+
+// The N independent variables, with values x.
+template <std::size_t N>
+inline std::array<dual<N>, N> dual_variables(const std::array<double, N> &x) {
+  std::array<dual<N>, N> retval;
+  for (std::size_t i = 0u; i < N; ++i) {
+    retval[i] = dual<N>::variable(x[i], i);
+  }
+  return retval;
+}
+
+// The values of N functions of the N independent variables and their
+// Jacobian (row i holding the derivatives of f[i]).
+template <std::size_t N>
+inline std::pair<std::array<double, N>, std::array<std::array<double, N>, N>>
+dual_jacobian(const std::array<dual<N>, N> &f) {
+  std::pair<std::array<double, N>, std::array<std::array<double, N>, N>>
+      retval;
+  for (std::size_t i = 0u; i < N; ++i) {
+    retval.first[i] = f[i].v;
+    retval.second[i] = f[i].d;
+  }
+  return retval;
+}
+
+// Value of a scalar, for code templated over double and dual.
+inline double value_of(double a) { return a; }
+template <std::size_t N> inline double value_of(const dual<N> &a) {
+  return a.v;
+}
+
+} // namespace kep3::detail
+
+#endif // kep3_DETAIL_DUAL_HPP
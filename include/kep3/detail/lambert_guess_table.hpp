@@ -0,0 +1,31 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef kep3_DETAIL_LAMBERT_GUESS_TABLE_HPP
+#define kep3_DETAIL_LAMBERT_GUESS_TABLE_HPP
+
+#include <kep3/detail/visibility.hpp>
+
+namespace kep3::detail {
+
+// Largest number of revolutions covered by the table.
+inline constexpr unsigned lambert_x_guess_table_N = 5u;
+
+// Looks up the tabulated solution x(lambda, T) of the Lambert problem on the
+// branch with N revolutions (left or right for N > 0), to be used as initial
+// guess of the Householder iterations. The table is built on first use.
+// Returns false (writing nothing) if N is larger than lambert_x_guess_table_N
+// or if (lambda, T) is outside the tabulated domain, in which case the
+// analytic guesses should be used.
+kep3_DLL_PUBLIC bool lambert_x_guess_lookup(double T, double lambda,
+                                            unsigned N, bool right, double &x);
+
+} // namespace kep3::detail
+
+#endif // kep3_DETAIL_LAMBERT_GUESS_TABLE_HPP
@@ -0,0 +1,596 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef kep3_DETAIL_LAMBERT_KERNELS_HPP
+#define kep3_DETAIL_LAMBERT_KERNELS_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <utility>
+
+#include <kep3/core_astro/constants.hpp>
+#include <kep3/detail/dual.hpp>
+#include <kep3/detail/lambert_guess_table.hpp>
+#include <kep3/detail/lambert_tmin_table.hpp>
+#include <kep3/detail/vec3.hpp>
+#include <kep3/lambert_accuracy.hpp>
+
+// The building blocks of the Lambert solver described in:
+//
+// Izzo, Dario. "Revisiting Lambert’s problem." Celestial Mechanics and
+// Dynamical Astronomy 121 (2015): 1-15.
+//
+// They are shared by kep3::lambert_problem and by the batch solvers, and are
+// written as free functions of the non dimensional problem (lambda, T) so that
+// they never allocate nor throw.
+namespace kep3::detail {
+
+// Default tolerances used by the solvers.
+inline constexpr double lambert_eps_zero_rev = 1e-5;
+inline constexpr double lambert_eps_multi_rev = 1e-8;
+inline constexpr unsigned lambert_iter_max = 15u;
+inline constexpr double lambert_hypergeometric_tol = 1e-11;
+
+// Tolerances of the solvers, defaulting to the values above (i.e. to
+// lambert_accuracy::standard).
+struct lambert_tolerances {
+  // Convergence criteria on the Householder step, for N = 0 and N > 0.
+  double eps_zero_rev = lambert_eps_zero_rev;
+  double eps_multi_rev = lambert_eps_multi_rev;
+  unsigned iter_max = lambert_iter_max;
+  // Truncation of the hypergeometric series in the Battin expression.
+  double hypergeometric_tol = lambert_hypergeometric_tol;
+
+  [[nodiscard]] double eps(unsigned N) const {
+    return N == 0u ? eps_zero_rev : eps_multi_rev;
+  }
+};
+
+// Tolerances of the accuracy profiles. As the Householder iterations converge
+// with third order, stopping on a step smaller than eps leaves an error in x
+// of order eps^3: the fast profile thus stops one iteration earlier than the
+// standard one in most cases, while the precise profile makes one more
+// iteration and sums the hypergeometric series to machine precision.
+inline constexpr lambert_tolerances
+lambert_tolerances_of(lambert_accuracy accuracy) {
+  switch (accuracy) {
+  case lambert_accuracy::fast:
+    return {1e-2, 1e-3, 8u, 1e-7};
+  case lambert_accuracy::precise:
+    return {1e-10, 1e-12, 30u, 1e-16};
+  default:
+    return {};
+  }
+}
+
+inline double lambert_hypergeometricF(double z, double tol) { // NOLINT
+  double Sj = 1.0;
+  double Cj = 1.0;
+  double err = 1.0;
+  double Cj1 = 0.0;
+  double Sj1 = 0.0;
+  int j = 0;
+  while (err > tol) {
+    Cj1 = Cj * (3.0 + j) * (1.0 + j) / (2.5 + j) * z / (j + 1);
+    Sj1 = Sj + Cj1;
+    err = std::abs(Cj1);
+    Sj = Sj1;
+    Cj = Cj1;
+    j = j + 1;
+  }
+  return Sj;
+}
+
+inline void lambert_dTdx(double &DT, double &DDT, double &DDDT, double x,
+                         double T, double lambda) {
+  double l2 = lambda * lambda;
+  double l3 = l2 * lambda;
+  double umx2 = 1.0 - x * x;
+  double y = std::sqrt(1.0 - l2 * umx2);
+  double y2 = y * y;
+  double y3 = y2 * y;
+  DT = 1.0 / umx2 * (3.0 * T * x - 2.0 + 2.0 * l3 * x / y);
+  DDT = 1.0 / umx2 * (3.0 * T + 5.0 * x * DT + 2.0 * (1.0 - l2) * l3 / y3);
+  DDDT = 1.0 / umx2 *
+         (7.0 * x * DDT + 8.0 * DT - 6.0 * (1.0 - l2) * l2 * l3 * x / y3 / y2);
+}
+
+// Lagrange expression of the time of flight.
+inline void lambert_x2tof2(double &tof, double x, // NOLINT
+                           unsigned N, double lambda) {
+  double a = 1.0 / (1.0 - x * x);
+  if (a > 0) // ellipse
+  {
+    double alfa = 2.0 * std::acos(x);
+    double beta = 2.0 * std::asin(std::sqrt(lambda * lambda / a));
+    if (lambda < 0.0) {
+      beta = -beta;
+    }
+    tof = ((a * std::sqrt(a) *
+            ((alfa - std::sin(alfa)) - (beta - std::sin(beta)) +
+             2.0 * kep3::pi * N)) /
+           2.0);
+  } else {
+    double alfa = 2.0 * std::acosh(x);
+    double beta = 2.0 * std::asinh(std::sqrt(-lambda * lambda / a));
+    if (lambda < 0.0) {
+      beta = -beta;
+    }
+    tof = (-a * std::sqrt(-a) *
+           ((beta - std::sinh(beta)) - (alfa - std::sinh(alfa))) / 2.0);
+  }
+}
+
+// Time of flight as a function of x, switching between the Battin series, the
+// Lagrange and the Lancaster expressions depending on the distance from x = 1.
+inline void
+lambert_x2tof(double &tof, double x, unsigned N, double lambda,
+              double hypergeometric_tol = lambert_hypergeometric_tol) {
+  double battin = 0.01;
+  double lagrange = 0.2;
+  double dist = std::abs(x - 1);
+  if (dist < lagrange && dist > battin) { // We use Lagrange tof expression
+    lambert_x2tof2(tof, x, N, lambda);
+    return;
+  }
+  double K = lambda * lambda;
+  double E = x * x - 1.0;
+  double rho = std::abs(E);
+  double z = std::sqrt(1 + K * E);
+  if (dist < battin) { // We use Battin series tof expression
+    double eta = z - lambda * x;
+    double S1 = 0.5 * (1.0 - lambda - x * eta);
+    double Q = lambert_hypergeometricF(S1, hypergeometric_tol);
+    Q = 4.0 / 3.0 * Q;
+    tof = (eta * eta * eta * Q + 4.0 * lambda * eta) / 2.0 +
+          N * kep3::pi / std::pow(rho, 1.5);
+    return;
+  } else { // We use Lancaster tof expresion
+    double y = std::sqrt(rho);
+    double g = x * z - lambda * E;
+    double d = 0.0;
+    if (E < 0) {
+      double l = std::acos(g);
+      d = N * kep3::pi + l;
+    } else {
+      double f = y * (z - lambda * x);
+      d = std::log(f + g);
+    }
+    tof = (x - lambda * z - d / y) / E;
+    return;
+  }
+}
+
+// Outcome of the Householder iterations: the number of iterations performed
+// and whether the last one met the convergence criterion. NOTE: the iterations
+// may converge on the last allowed step, so that iters == iter_max does not
+// by itself signal a failure.
+struct lambert_iterations {
+  unsigned iters = 0u;
+  bool converged = false;
+};
+
+// Householder iterations solving T(x) = T starting from x0.
+inline lambert_iterations lambert_householder(
+    double T, double &x0, unsigned N, // NOLINT
+    double eps, unsigned iter_max, double lambda,
+    double hypergeometric_tol = lambert_hypergeometric_tol) {
+  unsigned it = 0;
+  double err = 1.0;
+  double xnew = 0.0;
+  double tof = 0.0, delta = 0.0, DT = 0.0, DDT = 0.0, DDDT = 0.0;
+  while ((err > eps) && (it < iter_max)) {
+    lambert_x2tof(tof, x0, N, lambda, hypergeometric_tol);
+    lambert_dTdx(DT, DDT, DDDT, x0, tof, lambda);
+    delta = tof - T;
+    double DT2 = DT * DT;
+    xnew = x0 - delta * (DT2 - delta * DDT / 2.0) /
+                    (DT * (DT2 - delta * DDT) + DDDT * delta * delta / 6.0);
+    err = std::abs(x0 - xnew);
+    x0 = xnew;
+    it++;
+  }
+  // NOTE: a NaN error is not converged.
+  return {it, err <= eps};
+}
+
+// Non dimensional time of flight of the minimum energy transfer (x = 0) with
+// zero revolutions.
+inline double lambert_T00(double lambda) {
+  return std::acos(lambda) + lambda * std::sqrt(1.0 - lambda * lambda);
+}
+
+// Minimum non dimensional time of flight allowing N > 0 full revolutions, i.e.
+// the minimum of T(x) in (-1, 1), found via Halley iterations on dT/dx = 0
+// started from x0. As T(x) has a single minimum, the sign of dT/dx brackets it
+// and the iterations fall back to bisection whenever they leave the bracket.
+// Returns T_min and writes the corresponding x in x_min. NOTE: the tolerance
+// and the maximum number of iterations are fixed and do not follow the
+// accuracy profile (lambert_tolerances): T_min decides which branches exist,
+// so that N_max, and thus the set of solutions, must not depend on the
+// profile. The cost is small, as T_min is mostly read off the tabulated
+// curve (see lambert_T_min_feasible()).
+inline double lambert_T_min_from(double lambda, unsigned N, double x0,
+                                 double &x_min) {
+  double DT = 0.0, DDT = 0.0, DDDT = 0.0;
+  double T_min = 0.0;
+  double lb = -1.0, ub = 1.0;
+  double x_old = x0;
+  for (int it = 0; it < 100; ++it) {
+    lambert_x2tof(T_min, x_old, N, lambda);
+    lambert_dTdx(DT, DDT, DDDT, x_old, T_min, lambda);
+    if (DT < 0.0) {
+      lb = x_old;
+    } else {
+      ub = x_old;
+    }
+    double x_new = x_old - DT * DDT / (DDT * DDT - DT * DDDT / 2.0);
+    if (!(x_new > lb && x_new < ub)) {
+      x_new = (lb + ub) / 2.0;
+    }
+    const double err = std::abs(x_old - x_new);
+    x_old = x_new;
+    if (err < 1e-13) {
+      break;
+    }
+  }
+  lambert_x2tof(T_min, x_old, N, lambda);
+  x_min = x_old;
+  return T_min;
+}
+
+// Minimum non dimensional time of flight allowing N > 0 full revolutions,
+// refined from the starting point provided by the tabulated minimum time
+// curve (when available).
+inline double lambert_T_min(double lambda, unsigned N) {
+  double T_tab = 0.0, x_tab = 0.0, err = 0.0, x_min = 0.0;
+  if (!lambert_T_min_lookup(lambda, N, T_tab, x_tab, err)) {
+    x_tab = 0.0;
+  }
+  return lambert_T_min_from(lambda, N, x_tab, x_min);
+}
+
+// Whether T >= T_min(lambda, N), i.e. whether a solution with N > 0
+// revolutions exists. The tabulated minimum time curve decides all but the
+// cases falling within its error bound, for which T_min is refined.
+inline bool lambert_T_min_feasible(double T, double lambda, unsigned N) {
+  double T_tab = 0.0, x_tab = 0.0, err = 0.0, x_min = 0.0;
+  if (lambert_T_min_lookup(lambda, N, T_tab, x_tab, err)) {
+    if (T > T_tab + err) {
+      return true;
+    }
+    if (T < T_tab - err) {
+      return false;
+    }
+  } else {
+    x_tab = 0.0;
+  }
+  return !(lambert_T_min_from(lambda, N, x_tab, x_min) > T);
+}
+
+// Maximum number of revolutions (capped to multi_revs) for which a solution
+// exists.
+inline unsigned lambert_Nmax(double T, double lambda, unsigned multi_revs) {
+  auto Nmax = static_cast<unsigned>(T / kep3::pi);
+  Nmax = std::min(multi_revs, Nmax);
+  if (Nmax > 0) {
+    // When T >= T0 a solution certainly exists, otherwise we need to compare
+    // T with the minimum of T(x).
+    if (T < lambert_T00(lambda) + Nmax * kep3::pi) {
+      if (!lambert_T_min_feasible(T, lambda, Nmax)) {
+        Nmax -= 1;
+      }
+    }
+  }
+  return Nmax;
+}
+
+// Initial guess for the zero revolution solution.
+inline double lambert_x0_guess(double T, double lambda) {
+  double lambda2 = lambda * lambda;
+  double lambda3 = lambda * lambda2;
+  double T00 = lambert_T00(lambda);
+  double T1 = 2.0 / 3.0 * (1.0 - lambda3);
+  if (T >= T00) {
+    return -(T - T00) / (T - T00 + 4);
+  } else if (T <= T1) {
+    return T1 * (T1 - T) / (2.0 / 5.0 * (1 - lambda2 * lambda3) * T) + 1;
+  } else {
+    return std::pow((T / T00), 0.69314718055994529 / std::log(T1 / T00)) -
+           1.0;
+  }
+}
+
+// Initial guesses for the left and right solutions with N > 0 revolutions.
+inline double lambert_x0_guess_left(double T, unsigned N) {
+  double tmp = std::pow(
+      (static_cast<double>(N) * kep3::pi + kep3::pi) / (8.0 * T), 2.0 / 3.0);
+  return (tmp - 1) / (tmp + 1);
+}
+
+inline double lambert_x0_guess_right(double T, unsigned N) {
+  double tmp =
+      std::pow((8.0 * T) / (static_cast<double>(N) * kep3::pi), 2.0 / 3.0);
+  return (tmp - 1) / (tmp + 1);
+}
+
+// Initial guess for a single branch (N = 0, or left/right with N > 0
+// revolutions). When tabulated is true the tabulated solution surface is used
+// wherever it is available, typically leaving a single Householder iteration
+// to be made, otherwise the analytic guesses above are used.
+inline double lambert_x0_guess_branch(double T, double lambda, unsigned N,
+                                      bool right, bool tabulated) {
+  double x = 0.0;
+  if (tabulated && lambert_x_guess_lookup(T, lambda, N, right, x)) {
+    return x;
+  }
+  if (N == 0u) {
+    return lambert_x0_guess(T, lambda);
+  }
+  return right ? lambert_x0_guess_right(T, N) : lambert_x0_guess_left(T, N);
+}
+
+// Solves for x on a single branch (N = 0, or left/right with N > 0 revolutions),
+// assuming it exists.
+inline lambert_iterations
+lambert_solve_branch(double T, double lambda, unsigned N, bool right,
+                     double &x, bool tabulated_guess = false,
+                     const lambert_tolerances &tol = {}) {
+  x = lambert_x0_guess_branch(T, lambda, N, right, tabulated_guess);
+  return lambert_householder(T, x, N, tol.eps(N), tol.iter_max, lambda,
+                             tol.hypergeometric_tol);
+}
+
+// Partial derivative of the non dimensional time of flight with respect to
+// lambda at constant x. It does not depend on the number of revolutions.
+inline double lambert_dTdlambda(double x, double lambda) {
+  double l2 = lambda * lambda;
+  double y = std::sqrt(1.0 - l2 * (1.0 - x * x));
+  return -2.0 * l2 / y;
+}
+
+// Geometry of a Lambert problem: norms, chord, semiperimeter, lambda and the
+// radial/tangential unit vectors at both ends. The geometry functions are
+// templated over the floating point type so that they can also be evaluated
+// on dual numbers (see dual.hpp) to obtain the sensitivities.
+template <typename F> struct lambert_geometry_t {
+  F R1, R2, c, s, lambda;
+  std::array<F, 3> ir1, ir2, it1, it2;
+};
+
+using lambert_geometry = lambert_geometry_t<double>;
+
+// Sets the quantities of the geometry depending on r1 only, so that they can
+// be reused for many arrival positions (see lambert_geometry_set_r2()).
+template <typename F>
+inline void lambert_geometry_set_r1(lambert_geometry_t<F> &geo,
+                                    const std::array<F, 3> &r1) {
+  geo.R1 = vec3_norm(r1);
+  geo.ir1 = vec3_div(r1, geo.R1);
+}
+
+// Completes the geometry after lambert_geometry_set_r1(). Returns false
+// (leaving geo in an unspecified state) when the plane of the transfer has no
+// z component in its normal (which includes the degenerate case of collinear
+// position vectors), as it is then impossible to define clockwise or
+// counterclockwise motion.
+template <typename F>
+inline bool lambert_geometry_set_r2(lambert_geometry_t<F> &geo,
+                                    const std::array<F, 3> &r1,
+                                    const std::array<F, 3> &r2, bool cw) {
+  using std::isfinite;
+  using std::sqrt;
+  geo.c = vec3_norm(vec3_sub(r2, r1));
+  geo.R2 = vec3_norm(r2);
+  geo.s = (geo.c + geo.R1 + geo.R2) / 2.0;
+
+  geo.ir2 = vec3_div(r2, geo.R2);
+  auto ih = vec3_cross(geo.ir1, geo.ir2);
+  ih = vec3_div(ih, vec3_norm(ih));
+  if (ih[2] == 0 || !isfinite(ih[2])) {
+    return false;
+  }
+  geo.lambda = sqrt(1.0 - geo.c / geo.s);
+
+  auto &it1 = geo.it1;
+  auto &it2 = geo.it2;
+  it1 = vec3_cross(ih, geo.ir1);
+  it2 = vec3_cross(ih, geo.ir2);
+  const F IT1 = vec3_norm(it1);
+  const F IT2 = vec3_norm(it2);
+  // Transfer angle is larger than 180 degrees as seen from above the z axis
+  // (first sign flip) and/or retrograde motion (second sign flip).
+  double sign = 1.;
+  if (ih[2] < 0.0) {
+    sign = -sign;
+  }
+  if (cw) {
+    sign = -sign;
+  }
+  geo.lambda *= sign;
+  for (auto j = 0u; j < 3u; ++j) {
+    it1[j] *= sign / IT1;
+    it2[j] *= sign / IT2;
+  }
+  return true;
+}
+
+// Computes the geometry. Returns false when the direction of motion cannot be
+// defined (see lambert_geometry_set_r2()).
+template <typename F>
+inline bool lambert_geometry_init(lambert_geometry_t<F> &geo,
+                                  const std::array<F, 3> &r1,
+                                  const std::array<F, 3> &r2, bool cw) {
+  lambert_geometry_set_r1(geo, r1);
+  return lambert_geometry_set_r2(geo, r1, r2, cw);
+}
+
+// Non dimensional time of flight.
+template <typename F>
+inline F lambert_T(const lambert_geometry_t<F> &geo, const F &tof, double mu) {
+  using std::sqrt;
+  return sqrt(2.0 * mu / geo.s / geo.s / geo.s) * tof;
+}
+
+// Terminal velocities corresponding to the solution x.
+template <typename F>
+inline void lambert_velocities(const lambert_geometry_t<F> &geo, const F &x,
+                               double mu, std::array<F, 3> &v1,
+                               std::array<F, 3> &v2) {
+  using std::sqrt;
+  const F lambda = geo.lambda;
+  const F lambda2 = lambda * lambda;
+  F gamma = sqrt(mu * geo.s / 2.0);
+  F rho = (geo.R1 - geo.R2) / geo.c;
+  F sigma = sqrt(1 - rho * rho);
+  F y = sqrt(1.0 - lambda2 + lambda2 * x * x);
+  F vr1 = gamma * ((lambda * y - x) - rho * (lambda * y + x)) / geo.R1;
+  F vr2 = -gamma * ((lambda * y - x) + rho * (lambda * y + x)) / geo.R2;
+  F vt = gamma * sigma * (y + lambda * x);
+  F vt1 = vt / geo.R1;
+  F vt2 = vt / geo.R2;
+  for (auto j = 0u; j < 3u; ++j) {
+    v1[j] = vr1 * geo.ir1[j] + vt1 * geo.it1[j];
+    v2[j] = vr2 * geo.ir2[j] + vt2 * geo.it2[j];
+  }
+}
+
+// Range [xl, xm] of |x| for the elliptic solutions with N revolutions. As the
+// transfer lasts between N and N + 1 periods, N P <= tof < (N + 1) P, the
+// semi-major axis a = s / 2 / (1 - x^2) is bounded and so is |x| (with N = 0
+// there is no upper bound on a and xm = 1).
+inline void lambert_x_abs_range(const lambert_geometry &geo, double tof,
+                                double mu, unsigned N, double &xl,
+                                double &xm) {
+  xm = 1.;
+  if (N > 0u) {
+    const double P_max = tof / (2. * kep3::pi * N);
+    const double a_max = std::cbrt(mu * P_max * P_max);
+    xm = std::sqrt(std::max(1. - geo.s / (2. * a_max), 0.));
+  }
+  const double P_min = tof / (2. * kep3::pi * (N + 1u));
+  const double a_min = std::cbrt(mu * P_min * P_min);
+  xl = std::min(std::sqrt(std::max(1. - geo.s / (2. * a_min), 0.)), xm);
+}
+
+// Range of A y(x) + B x for x in [xa, xb], with y(x) = sqrt(1 - lambda^2 (1 -
+// x^2)). As x/y is monotonic the function has at most one stationary point, so
+// the extrema are attained at the ends of the interval or there.
+inline std::pair<double, double> lambert_h_range(double A, double B,
+                                                 double lambda, double xa,
+                                                 double xb) {
+  const double l2 = lambda * lambda;
+  auto h = [A, B, l2](double x) {
+    return A * std::sqrt(1.0 - l2 * (1.0 - x * x)) + B * x;
+  };
+  double lb = std::min(h(xa), h(xb));
+  double ub = std::max(h(xa), h(xb));
+  if (A != 0. && l2 != 0.) {
+    // Stationary point: x/y = k.
+    const double k = -B / (A * l2);
+    if (k * k * l2 < 1.) {
+      const double xc = k * std::sqrt((1.0 - l2) / (1.0 - k * k * l2));
+      if (xc > xa && xc < xb) {
+        lb = std::min(lb, h(xc));
+        ub = std::max(ub, h(xc));
+      }
+    }
+  }
+  return {lb, ub};
+}
+
+// Lower bound of the DV at both ends of the transfer for the solutions with x
+// in [xa, xb]. The radial and tangential components of the velocities
+// (see lambert_velocities()) are bounded over the interval, and the DV is
+// bounded by the distance of v_dep and v_arr from the resulting boxes in the
+// plane of the transfer. An empty interval (xa > xb) bounds only the out of
+// plane components, which no solution can avoid.
+inline double lambert_dv_lower_bound(const lambert_geometry &geo, double mu,
+                                     double xa, double xb,
+                                     const std::array<double, 3> &v_dep,
+                                     const std::array<double, 3> &v_arr) {
+  // Components of v in the plane of the transfer and squared norm of the out
+  // of plane one.
+  auto split = [](const vec3 &v, const vec3 &ir, const vec3 &it, double &vr,
+                  double &vt) {
+    vr = vec3_dot(v, ir);
+    vt = vec3_dot(v, it);
+    return std::max(vec3_dot(v, v) - vr * vr - vt * vt, 0.);
+  };
+  double vr1 = 0., vt1 = 0., vr2 = 0., vt2 = 0.;
+  const double v1_out2 = split(v_dep, geo.ir1, geo.it1, vr1, vt1);
+  const double v2_out2 = split(v_arr, geo.ir2, geo.it2, vr2, vt2);
+  if (xa > xb) {
+    return std::sqrt(v1_out2) + std::sqrt(v2_out2);
+  }
+  const double lambda = geo.lambda;
+  const double gamma = std::sqrt(mu * geo.s / 2.0);
+  const double rho = (geo.R1 - geo.R2) / geo.c;
+  const double sigma = std::sqrt(1 - rho * rho);
+  const auto [h1_lb, h1_ub] =
+      lambert_h_range((1. - rho) * lambda, -(1. + rho), lambda, xa, xb);
+  const auto [h2_lb, h2_ub] =
+      lambert_h_range(-(1. + rho) * lambda, 1. - rho, lambda, xa, xb);
+  const auto [ht_lb, ht_ub] = lambert_h_range(1., lambda, lambda, xa, xb);
+  auto box_distance = [](double v_out2, double vr, double vt, double k_r,
+                         double k_t, double r_lb, double r_ub, double t_lb,
+                         double t_ub) {
+    const double dr = std::max({k_r * r_lb - vr, vr - k_r * r_ub, 0.});
+    const double dt = std::max({k_t * t_lb - vt, vt - k_t * t_ub, 0.});
+    return std::sqrt(v_out2 + dr * dr + dt * dt);
+  };
+  return box_distance(v1_out2, vr1, vt1, gamma / geo.R1,
+                      gamma * sigma / geo.R1, h1_lb, h1_ub, ht_lb, ht_ub) +
+         box_distance(v2_out2, vr2, vt2, gamma / geo.R2,
+                      gamma * sigma / geo.R2, h2_lb, h2_ub, ht_lb, ht_ub);
+}
+
+// Jacobians of the terminal velocities with respect to r1, r2 and tof (columns
+// 0-2, 3-5 and 6) at the solution x with N revolutions. The geometry and the
+// velocities are differentiated in forward mode, while the sensitivity of x
+// follows from the implicit function theorem applied to T(x, lambda) = T:
+// dx = (dT - dT/dlambda dlambda) / (dT/dx). The Jacobians are singular where
+// dT/dx = 0, i.e. at the minimum time of flight of a multi revolution branch.
+inline void lambert_sensitivities(const std::array<double, 3> &r1,
+                                  const std::array<double, 3> &r2, double tof,
+                                  double mu, bool cw, double x, unsigned N,
+                                  std::array<std::array<double, 7>, 3> &dv1,
+                                  std::array<std::array<double, 7>, 3> &dv2) {
+  using d7 = dual<7>;
+  std::array<d7, 3> r1d, r2d;
+  for (auto j = 0u; j < 3u; ++j) {
+    r1d[j] = d7::variable(r1[j], j);
+    r2d[j] = d7::variable(r2[j], 3u + j);
+  }
+  lambert_geometry_t<d7> geo{};
+  lambert_geometry_init(geo, r1d, r2d, cw);
+  const d7 T = lambert_T(geo, d7::variable(tof, 6u), mu);
+
+  const double lambda = geo.lambda.v;
+  double Tx = 0.0, DT = 0.0, DDT = 0.0, DDDT = 0.0;
+  lambert_x2tof(Tx, x, N, lambda);
+  lambert_dTdx(DT, DDT, DDDT, x, Tx, lambda);
+  const double DTl = lambert_dTdlambda(x, lambda);
+  d7 xd(x);
+  for (auto i = 0u; i < 7u; ++i) {
+    xd.d[i] = (T.d[i] - DTl * geo.lambda.d[i]) / DT;
+  }
+
+  std::array<d7, 3> v1d, v2d;
+  lambert_velocities(geo, xd, mu, v1d, v2d);
+  for (auto j = 0u; j < 3u; ++j) {
+    dv1[j] = v1d[j].d;
+    dv2[j] = v2d[j].d;
+  }
+}
+
+} // namespace kep3::detail
+
+#endif // kep3_DETAIL_LAMBERT_KERNELS_HPP
@@ -0,0 +1,164 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef kep3_DETAIL_LAMBERT_LANES_HPP
+#define kep3_DETAIL_LAMBERT_LANES_HPP
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+#include <kep3/core_astro/constants.hpp>
+#include <kep3/detail/lambert_kernels.hpp>
+
+// Versions of the kernels in lambert_kernels.hpp operating on W independent
+// Householder iterations at once (one per lane), stored as plain arrays. The
+// lanes are batched, not vectorized: the math functions are the scalar ones,
+// called lane by lane, and the Battin, Lagrange or Lancaster expression of the
+// time of flight is chosen per lane with ordinary branches. Running the
+// iterations in lockstep amortizes the loop and setup overhead over the
+// lanes. Each lane performs exactly the same floating point operations as the
+// scalar kernels, hence the results are the same.
+namespace kep3::detail {
+
+template <std::size_t W> using lambert_lanes = std::array<double, W>;
+template <std::size_t W> using lambert_mask = std::array<bool, W>;
+template <std::size_t W> using lambert_ulanes = std::array<unsigned, W>;
+
+template <std::size_t W> inline bool lambert_any(const lambert_mask<W> &m) {
+  bool retval = false;
+  for (std::size_t k = 0u; k < W; ++k) {
+    retval = retval || m[k];
+  }
+  return retval;
+}
+
+template <std::size_t W>
+inline void lambert_dTdx_lanes(lambert_lanes<W> &DT, lambert_lanes<W> &DDT,
+                               lambert_lanes<W> &DDDT,
+                               const lambert_lanes<W> &x,
+                               const lambert_lanes<W> &T,
+                               const lambert_lanes<W> &lambda) {
+  for (std::size_t k = 0u; k < W; ++k) {
+    double l2 = lambda[k] * lambda[k];
+    double l3 = l2 * lambda[k];
+    double umx2 = 1.0 - x[k] * x[k];
+    double y = std::sqrt(1.0 - l2 * umx2);
+    double y2 = y * y;
+    double y3 = y2 * y;
+    DT[k] = 1.0 / umx2 * (3.0 * T[k] * x[k] - 2.0 + 2.0 * l3 * x[k] / y);
+    DDT[k] = 1.0 / umx2 *
+             (3.0 * T[k] + 5.0 * x[k] * DT[k] + 2.0 * (1.0 - l2) * l3 / y3);
+    DDDT[k] = 1.0 / umx2 *
+              (7.0 * x[k] * DDT[k] + 8.0 * DT[k] -
+               6.0 * (1.0 - l2) * l2 * l3 * x[k] / y3 / y2);
+  }
+}
+
+template <std::size_t W>
+inline void lambert_x2tof_lanes(lambert_lanes<W> &tof,
+                                const lambert_lanes<W> &x,
+                                const lambert_ulanes<W> &N,
+                                const lambert_lanes<W> &lambda,
+                                double hypergeometric_tol) {
+  constexpr double battin = 0.01;
+  constexpr double lagrange = 0.2;
+  lambert_mask<W> use_battin{}, use_lagrange{};
+  lambert_lanes<W> E{}, rho{}, z{}, y{}, g{}, d{};
+  // Lancaster expression (computed in all lanes).
+  for (std::size_t k = 0u; k < W; ++k) {
+    double dist = std::abs(x[k] - 1);
+    use_lagrange[k] = dist < lagrange && dist > battin;
+    use_battin[k] = dist < battin;
+    E[k] = x[k] * x[k] - 1.0;
+    rho[k] = std::abs(E[k]);
+    z[k] = std::sqrt(1 + lambda[k] * lambda[k] * E[k]);
+    y[k] = std::sqrt(rho[k]);
+    g[k] = x[k] * z[k] - lambda[k] * E[k];
+  }
+  for (std::size_t k = 0u; k < W; ++k) {
+    d[k] = (E[k] < 0) ? N[k] * kep3::pi + std::acos(g[k])
+                      : std::log(y[k] * (z[k] - lambda[k] * x[k]) + g[k]);
+  }
+  for (std::size_t k = 0u; k < W; ++k) {
+    tof[k] = (x[k] - lambda[k] * z[k] - d[k] / y[k]) / E[k];
+  }
+  // Battin series, with the hypergeometric function summed in all the lanes
+  // needing it until each of them has converged.
+  if (lambert_any(use_battin)) {
+    lambert_lanes<W> eta{}, S1{}, Sj{}, Cj{};
+    lambert_mask<W> active(use_battin);
+    for (std::size_t k = 0u; k < W; ++k) {
+      eta[k] = z[k] - lambda[k] * x[k];
+      S1[k] = 0.5 * (1.0 - lambda[k] - x[k] * eta[k]);
+      Sj[k] = 1.0;
+      Cj[k] = 1.0;
+    }
+    for (int j = 0; lambert_any(active); ++j) {
+      for (std::size_t k = 0u; k < W; ++k) {
+        double Cj1 = Cj[k] * (3.0 + j) * (1.0 + j) / (2.5 + j) * S1[k] / (j + 1);
+        Sj[k] = active[k] ? Sj[k] + Cj1 : Sj[k];
+        Cj[k] = active[k] ? Cj1 : Cj[k];
+        active[k] = active[k] && (std::abs(Cj1) > hypergeometric_tol);
+      }
+    }
+    for (std::size_t k = 0u; k < W; ++k) {
+      if (use_battin[k]) {
+        double Q = 4.0 / 3.0 * Sj[k];
+        tof[k] = (eta[k] * eta[k] * eta[k] * Q + 4.0 * lambda[k] * eta[k]) /
+                     2.0 +
+                 N[k] * kep3::pi / std::pow(rho[k], 1.5);
+      }
+    }
+  }
+  // Lagrange expression.
+  for (std::size_t k = 0u; k < W; ++k) {
+    if (use_lagrange[k]) {
+      lambert_x2tof2(tof[k], x[k], N[k], lambda[k]);
+    }
+  }
+}
+
+// Householder iterations in the lanes flagged in active. Each lane stops
+// iterating as soon as its own convergence criterion is met (or the iterations
+// limit is reached). iters returns the iterations made in each lane and
+// converged whether its last iteration met the criterion, as in
+// lambert_iterations.
+template <std::size_t W>
+inline void lambert_householder_lanes(
+    const lambert_lanes<W> &T, lambert_lanes<W> &x, const lambert_ulanes<W> &N,
+    const lambert_lanes<W> &eps, unsigned iter_max,
+    const lambert_lanes<W> &lambda, lambert_mask<W> active,
+    lambert_ulanes<W> &iters, lambert_mask<W> &converged,
+    double hypergeometric_tol) {
+  lambert_lanes<W> tof{}, DT{}, DDT{}, DDDT{};
+  iters.fill(0u);
+  converged.fill(false);
+  for (unsigned it = 0u; it < iter_max && lambert_any(active); ++it) {
+    lambert_x2tof_lanes(tof, x, N, lambda, hypergeometric_tol);
+    lambert_dTdx_lanes(DT, DDT, DDDT, x, tof, lambda);
+    for (std::size_t k = 0u; k < W; ++k) {
+      double delta = tof[k] - T[k];
+      double DT2 = DT[k] * DT[k];
+      double xnew =
+          x[k] - delta * (DT2 - delta * DDT[k] / 2.0) /
+                     (DT[k] * (DT2 - delta * DDT[k]) +
+                      DDDT[k] * delta * delta / 6.0);
+      double err = std::abs(x[k] - xnew);
+      x[k] = active[k] ? xnew : x[k];
+      iters[k] += active[k] ? 1u : 0u;
+      converged[k] = active[k] ? err <= eps[k] : converged[k];
+      active[k] = active[k] && (err > eps[k]);
+    }
+  }
+}
+
+} // namespace kep3::detail
+
+#endif // kep3_DETAIL_LAMBERT_LANES_HPP
@@ -0,0 +1,75 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef kep3_DETAIL_LAMBERT_SETUP_HPP
+#define kep3_DETAIL_LAMBERT_SETUP_HPP
+
+#include <array>
+
+#include <kep3/detail/lambert_kernels.hpp>
+#include <kep3/lambert_solve.hpp>
+
+// Input checks and setup shared by the Lambert solvers reporting a
+// kep3::lambert_status (lambert_solve(), the batch solvers and the sweeps).
+namespace kep3::detail {
+
+// Checks the time of flight and the gravity parameter of a problem.
+inline lambert_status lambert_check_inputs(double tof, double mu) {
+  // NOTE: the negated comparisons also catch NaNs.
+  if (!(tof > 0)) {
+    return lambert_status::invalid_tof;
+  }
+  if (!(mu > 0)) {
+    return lambert_status::invalid_mu;
+  }
+  return lambert_status::success;
+}
+
+// Checks the inputs of a problem whose geometry already has its departure
+// part (see lambert_geometry_set_r1()), completes the geometry and computes
+// the non dimensional time of flight T. Whenever the status returned is not
+// success, geo and T are unspecified.
+inline lambert_status lambert_setup_r2(lambert_geometry &geo,
+                                       const std::array<double, 3> &r1,
+                                       const std::array<double, 3> &r2,
+                                       double tof, double mu, bool cw,
+                                       double &T) {
+  if (const auto status = lambert_check_inputs(tof, mu);
+      status != lambert_status::success) {
+    return status;
+  }
+  if (!lambert_geometry_set_r2(geo, r1, r2, cw)) {
+    return lambert_status::degenerate_geometry;
+  }
+  T = lambert_T(geo, tof, mu);
+  return lambert_status::success;
+}
+
+// As lambert_setup_r2(), computing the whole geometry.
+inline lambert_status lambert_setup(lambert_geometry &geo,
+                                    const std::array<double, 3> &r1,
+                                    const std::array<double, 3> &r2,
+                                    double tof, double mu, bool cw,
+                                    double &T) {
+  lambert_geometry_set_r1(geo, r1);
+  return lambert_setup_r2(geo, r1, r2, tof, mu, cw, T);
+}
+
+// Status of the branch with N revolutions of a problem set up by
+// lambert_setup(): no_solution when it does not exist, success otherwise.
+inline lambert_status lambert_branch_status(double T, double lambda,
+                                            unsigned N) {
+  return (N > 0u && lambert_Nmax(T, lambda, N) < N)
+             ? lambert_status::no_solution
+             : lambert_status::success;
+}
+
+} // namespace kep3::detail
+
+#endif // kep3_DETAIL_LAMBERT_SETUP_HPP
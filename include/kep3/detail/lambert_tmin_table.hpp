@@ -0,0 +1,31 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef kep3_DETAIL_LAMBERT_TMIN_TABLE_HPP
+#define kep3_DETAIL_LAMBERT_TMIN_TABLE_HPP
+
+#include <kep3/detail/visibility.hpp>
+
+namespace kep3::detail {
+
+// Largest number of revolutions covered by the table.
+inline constexpr unsigned lambert_T_min_table_N = 32u;
+
+// Looks up the tabulated minimum non dimensional time of flight T_min(lambda,
+// N) of the Lambert problem, writing its interpolated value, the
+// corresponding x and a bound on the interpolation error of T_min. The table
+// is built on first use. Returns false (writing nothing) if N is zero or
+// larger than lambert_T_min_table_N, or if lambda is not in [-1, 1].
+kep3_DLL_PUBLIC bool lambert_T_min_lookup(double lambda, unsigned N,
+                                          double &T_min, double &x_min,
+                                          double &err);
+
+} // namespace kep3::detail
+
+#endif // kep3_DETAIL_LAMBERT_TMIN_TABLE_HPP
@@ -0,0 +1,305 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef kep3_DETAIL_LAMBERT_UNIVERSAL_HPP
+#define kep3_DETAIL_LAMBERT_UNIVERSAL_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+#include <kep3/core_astro/constants.hpp>
+#include <kep3/core_astro/special_functions.hpp>
+#include <kep3/detail/lambert_kernels.hpp>
+#include <kep3/detail/vec3.hpp>
+#include <kep3/lambert_solve.hpp>
+
+// A Lambert solver based on the universal variable psi = DE^2 (DE being the
+// difference of eccentric anomalies, or its hyperbolic counterpart for
+// psi < 0), as described in:
+//
+// Bate, Mueller, White. "Fundamentals of Astrodynamics." Dover (1971), ch. 5.
+// Vallado, David. "Fundamentals of Astrodynamics and Applications."
+// Microcosm Press (2013), algorithm 58.
+//
+// The time of flight is solved for by safeguarded Newton iterations. It is
+// kept as an alternative to the solver of lambert_kernels.hpp, with which it
+// shares the geometry and the tolerances, to compare the two on the same
+// problems (see lambert_engine).
+namespace kep3::detail {
+
+// Stumpff functions C(psi), S(psi) and their derivatives. Close to psi = 0
+// the closed forms of special_functions.hpp lose all accuracy to
+// cancellation and the Taylor series are used instead.
+inline void lambert_universal_stumpff(double psi, double &C, double &S,
+                                      double &dC, double &dS) {
+  if (std::abs(psi) < 0.1) {
+    C = 1. / 2. +
+        psi * (-1. / 24. +
+               psi * (1. / 720. +
+                      psi * (-1. / 40320. +
+                             psi * (1. / 3628800. - psi / 479001600.))));
+    S = 1. / 6. +
+        psi * (-1. / 120. +
+               psi * (1. / 5040. +
+                      psi * (-1. / 362880. +
+                             psi * (1. / 39916800. - psi / 6227020800.))));
+    dC = -1. / 24. +
+         psi * (2. / 720. +
+                psi * (-3. / 40320. +
+                       psi * (4. / 3628800. - 5. * psi / 479001600.)));
+    dS = -1. / 120. +
+         psi * (2. / 5040. +
+                psi * (-3. / 362880. +
+                       psi * (4. / 39916800. - 5. * psi / 6227020800.)));
+    return;
+  }
+  C = kep3::stumpff_c(psi);
+  S = kep3::stumpff_s(psi);
+  dC = (1. - psi * S - 2. * C) / (2. * psi);
+  dS = (C - 3. * S) / (2. * psi);
+}
+
+// Scaled time of flight sqrt(mu) * t(psi) and its derivative, for the
+// geometry parameters R = r1 + r2 and A = sin(dnu) sqrt(r1 r2 / (1 -
+// cos(dnu))). Returns false where y(psi) is not positive, i.e. where no
+// transfer exists (only possible for A > 0, below the values of psi of
+// interest).
+inline bool lambert_universal_tof(double psi, double R, double A, double &t,
+                                  double &dt, double &y) {
+  double C = 0., S = 0., dC = 0., dS = 0.;
+  lambert_universal_stumpff(psi, C, S, dC, dS);
+  const double sqrtC = std::sqrt(C);
+  y = R + A * (psi * S - 1.) / sqrtC;
+  if (!(y > 0.)) {
+    return false;
+  }
+  const double dy =
+      A * ((S + psi * dS) / sqrtC - (psi * S - 1.) * dC / (2. * C * sqrtC));
+  const double chi = std::sqrt(y / C);
+  const double chi3 = chi * chi * chi;
+  const double sqrty = std::sqrt(y);
+  t = chi3 * S + A * sqrty;
+  dt = 1.5 * chi * (dy * C - y * dC) / (C * C) * S + chi3 * dS +
+       A * dy / (2. * sqrty);
+  return true;
+}
+
+// Maximum number of evaluations of the time of flight. Far from the
+// solution the Newton iterations on psi converge slowly, and are replaced by
+// bisections.
+inline unsigned lambert_universal_iter_max(const lambert_tolerances &tol) {
+  return 4u * tol.iter_max;
+}
+
+// Relative residual of the time of flight at which the iterations stop. The
+// Householder iterations stopping on a step eps leave an error of order
+// eps^3, which is matched here.
+inline double lambert_universal_rtol(const lambert_tolerances &tol) {
+  return std::max(tol.eps_zero_rev * tol.eps_zero_rev * tol.eps_zero_rev,
+                  4. * std::numeric_limits<double>::epsilon());
+}
+
+// Safeguarded Newton iterations solving t(psi) = tau in (lo, hi), where t is
+// monotonic with the sign of dir, with at most iter_max evaluations of t and
+// stopping on a relative residual rtol. Returns the number of evaluations and
+// whether the iterations stopped on the residual or on the step, rather than
+// on the iterations limit.
+inline lambert_iterations lambert_universal_newton(double tau, double R,
+                                                   double A, double lo,
+                                                   double hi, double dir,
+                                                   double &psi,
+                                                   unsigned iter_max,
+                                                   double rtol) {
+  const double eps = 4. * std::numeric_limits<double>::epsilon();
+  unsigned it = 0u;
+  double t = 0., dt = 0., y = 0.;
+  while (it < iter_max) {
+    ++it;
+    double psi_new = 0.;
+    if (!lambert_universal_tof(psi, R, A, t, dt, y)) {
+      // No transfer: the time of flight is (formally) zero.
+      lo = psi;
+      psi_new = (lo + hi) / 2.;
+    } else {
+      const double res = t - tau;
+      if (std::abs(res) <= rtol * tau) {
+        return {it, true};
+      }
+      if (dir * res < 0.) {
+        lo = psi;
+      } else {
+        hi = psi;
+      }
+      // NOTE: the Newton step is taken on log(t), which is much closer to
+      // linear than t close to the singularities at the multiples of
+      // 4 pi^2.
+      psi_new = psi - std::log(t / tau) * t / dt;
+      // NOTE: the negated comparison also catches NaNs.
+      if (!(psi_new > lo && psi_new < hi)) {
+        psi_new = (lo + hi) / 2.;
+      }
+    }
+    if (std::abs(psi_new - psi) <= eps * std::abs(psi)) {
+      psi = psi_new;
+      return {it, true};
+    }
+    psi = psi_new;
+  }
+  return {it, false};
+}
+
+// Lower end of the bracketing of the hyperbolic transfers (psi < 0). NOTE:
+// for psi < 0 the time of flight is the difference of terms growing as
+// exp(sqrt(-psi)), and below about -5e3 (differences of the hyperbolic
+// anomalies of about 70) nothing but the rounding errors is left of it.
+inline constexpr double lambert_universal_psi_min = -2e3;
+
+// Solves the branch (N, right) of a Lambert problem with the universal
+// variable. The branches are those of lambert_solve_branch(): for N > 0 the
+// right one (x > x_min) has the smaller psi. iters returns the number of
+// evaluations of the time of flight. On success x is set to the corresponding
+// value of the variable of lambert_kernels.hpp. The status returned is
+// no_solution, leaving x, v1 and v2 untouched, if the branch does not exist.
+// It is bracket_not_found if a zero revolutions transfer is too fast to be
+// bracketed above lambert_universal_psi_min, and not_converged if the
+// iterations limit is hit. In both cases x, v1 and v2 are set to NaN.
+inline lambert_status lambert_universal_solve(
+    const lambert_geometry &geo, double tof, double mu, unsigned N, bool right,
+    double &x, std::array<double, 3> &v1, std::array<double, 3> &v2,
+    unsigned &iters, const lambert_tolerances &tol = {}) {
+  const double tau = std::sqrt(mu) * tof;
+  const double R = geo.R1 + geo.R2;
+  const double cos_dnu = vec3_dot(geo.ir1, geo.ir2);
+  // NOTE: the sign of lambda already accounts for transfers longer than half
+  // a revolution.
+  const double A = std::copysign(
+      std::sqrt(std::max(0., geo.R1 * geo.R2 * (1. + cos_dnu))), geo.lambda);
+  const double twopi2 = 4. * kep3::pi * kep3::pi;
+  const auto fail = [&](lambert_status status) {
+    x = std::numeric_limits<double>::quiet_NaN();
+    v1.fill(x);
+    v2 = v1;
+    return status;
+  };
+  iters = 0u;
+  double psi = 0., lo = 0., hi = 0., dir = 1.;
+  double t = 0., dt = 0., y = 0.;
+  if (N == 0u) {
+    // t(psi) grows from zero (or from the value where y vanishes) to
+    // infinity at psi = 4 pi^2. Hyperbolic transfers (psi < 0) are bracketed
+    // by doubling.
+    hi = twopi2;
+    lo = -twopi2;
+    while (lambert_universal_tof(lo, R, A, t, dt, y) && t > tau) {
+      if (!(lo > lambert_universal_psi_min)) {
+        return fail(lambert_status::bracket_not_found);
+      }
+      ++iters;
+      hi = lo;
+      lo *= 2.;
+    }
+    psi = std::clamp(0., lo, hi);
+    if (psi == hi) {
+      psi = (lo + hi) / 2.;
+    }
+  } else {
+    // t(psi) goes to infinity at both ends of (4 N^2 pi^2, 4 (N + 1)^2 pi^2)
+    // and has a single minimum, where d log(t) / dpsi is zeroed by regula
+    // falsi (Illinois) steps.
+    const double a = twopi2 * N * N, b = twopi2 * (N + 1u) * (N + 1u);
+    double l = a + 1e-3 * (b - a), h = b - 1e-3 * (b - a);
+    double dl = 0., dh = 0.;
+    lambert_universal_tof(l, R, A, t, dl, y);
+    dl /= t;
+    lambert_universal_tof(h, R, A, t, dh, y);
+    dh /= t;
+    iters += 2u;
+    int side = 0;
+    while (h - l > 1e-7 * (b - a)) {
+      ++iters;
+      psi = l - dl * (h - l) / (dh - dl);
+      // NOTE: the negated comparison also catches NaNs.
+      if (!(psi > l && psi < h)) {
+        psi = (l + h) / 2.;
+      }
+      lambert_universal_tof(psi, R, A, t, dt, y);
+      dt /= t;
+      if (std::abs(dt) * (b - a) < 1e-10) {
+        break;
+      }
+      if (dt < 0.) {
+        l = psi;
+        dl = dt;
+        if (side == -1) {
+          dh /= 2.;
+        }
+        side = -1;
+      } else {
+        h = psi;
+        dh = dt;
+        if (side == 1) {
+          dl /= 2.;
+        }
+        side = 1;
+      }
+    }
+    lambert_universal_tof(psi, R, A, t, dt, y);
+    if (t > tau) {
+      return lambert_status::no_solution;
+    }
+    if (right) {
+      lo = a;
+      hi = psi;
+      dir = -1.;
+    } else {
+      lo = psi;
+      hi = b;
+    }
+    psi = lo + (hi - lo) / 2.;
+  }
+  const auto its =
+      lambert_universal_newton(tau, R, A, lo, hi, dir, psi,
+                               lambert_universal_iter_max(tol),
+                               lambert_universal_rtol(tol));
+  iters += its.iters;
+  if (!its.converged || !lambert_universal_tof(psi, R, A, t, dt, y)) {
+    return fail(lambert_status::not_converged);
+  }
+
+  // 2 - Variable x of lambert_kernels.hpp: x^2 = 1 - s / (2a), and for
+  // elliptic transfers x = cos(alpha / 2), where DE = 2 N pi + alpha - beta
+  // and sin(beta / 2) = lambda sqrt(1 - x^2) (Lagrange).
+  double C = 0., S = 0., dC = 0., dS = 0.;
+  lambert_universal_stumpff(psi, C, S, dC, dS);
+  const double x2 = 1. - geo.s * psi * C / (2. * y);
+  x = std::sqrt(std::max(0., x2));
+  if (psi > 0.) {
+    const double half_beta = std::asin(geo.lambda * std::sqrt(1. - x2));
+    const double half_alpha =
+        (std::sqrt(psi) - 2. * kep3::pi * N) / 2. + half_beta;
+    x = std::copysign(x, std::cos(half_alpha));
+  }
+
+  // 3 - Velocities from the Lagrange coefficients.
+  const double f = 1. - y / geo.R1;
+  const double g = A * std::sqrt(y / mu);
+  const double gdot = 1. - y / geo.R2;
+  for (auto j = 0u; j < 3u; ++j) {
+    const double r1 = geo.R1 * geo.ir1[j], r2 = geo.R2 * geo.ir2[j];
+    v1[j] = (r2 - f * r1) / g;
+    v2[j] = (gdot * r2 - r1) / g;
+  }
+  return lambert_status::success;
+}
+
+} // namespace kep3::detail
+
+#endif // kep3_DETAIL_LAMBERT_UNIVERSAL_HPP
@@ -0,0 +1,64 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef kep3_DETAIL_NPY_HPP
+#define kep3_DETAIL_NPY_HPP
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <ostream>
+#include <span>
+#include <string>
+
+// Minimal writer of the .npy format (version 1.0) for C ordered float64
+// arrays, readable with numpy.load(). The header is written first, given the
+// shape, after which the data can be streamed in one or more calls to
+// npy_write_data().
+namespace kep3::detail {
+
+inline void npy_write_header(std::ostream &os,
+                             std::initializer_list<std::size_t> shape) {
+  std::string dict = "{'descr': '";
+  dict += (std::endian::native == std::endian::little) ? "<f8" : ">f8";
+  dict += "', 'fortran_order': False, 'shape': (";
+  for (auto n : shape) {
+    if (dict.back() != '(') {
+      dict += ", ";
+    }
+    dict += std::to_string(n);
+  }
+  // NOTE: one dimensional shapes need a trailing comma, as in (n,), while
+  // scalars have the empty shape ().
+  if (shape.size() == 1u) {
+    dict += ',';
+  }
+  dict += "), }";
+  // The header (magic string, version, length and dictionary) is padded with
+  // spaces and terminated by a newline so that the data is 64 bytes aligned.
+  const std::size_t unpadded = 10u + dict.size() + 1u;
+  dict.append((64u - unpadded % 64u) % 64u, ' ');
+  dict += '\n';
+  const auto len = static_cast<std::uint16_t>(dict.size());
+  os.write("\x93NUMPY\x01\x00", 8);
+  const char len_le[2] = {static_cast<char>(len & 0xffu),
+                          static_cast<char>(len >> 8u)};
+  os.write(len_le, 2);
+  os.write(dict.data(), static_cast<std::streamsize>(dict.size()));
+}
+
+inline void npy_write_data(std::ostream &os, std::span<const double> data) {
+  os.write(reinterpret_cast<const char *>(data.data()),
+           static_cast<std::streamsize>(data.size() * sizeof(double)));
+}
+
+} // namespace kep3::detail
+
+#endif // kep3_DETAIL_NPY_HPP
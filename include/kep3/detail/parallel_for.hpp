@@ -0,0 +1,80 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef kep3_DETAIL_PARALLEL_FOR_HPP
+#define kep3_DETAIL_PARALLEL_FOR_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace kep3::detail {
+
+// Splits the index range [0, n) into contiguous chunks of at least grain
+// elements and calls f(begin, end) on each of them, one chunk per hardware
+// thread. The calling thread processes the first chunk. If any invocation of f
+// throws, the first exception caught is rethrown in the calling thread after
+// all workers have been joined.
+template <typename F>
+inline void parallel_for(std::size_t n, std::size_t grain, const F &f) {
+  const std::size_t n_hw =
+      std::max(static_cast<std::size_t>(std::thread::hardware_concurrency()),
+               std::size_t(1));
+  const std::size_t n_chunks =
+      std::min(n_hw, std::max(n / std::max(grain, std::size_t(1)),
+                              std::size_t(1)));
+  if (n_chunks == 1u) {
+    f(std::size_t(0), n);
+    return;
+  }
+
+  std::exception_ptr eptr;
+  std::mutex eptr_mutex;
+  auto run_chunk = [&](std::size_t k) {
+    const std::size_t begin = n * k / n_chunks;
+    const std::size_t end = n * (k + 1u) / n_chunks;
+    try {
+      f(begin, end);
+    } catch (...) {
+      const std::lock_guard<std::mutex> lock(eptr_mutex);
+      if (!eptr) {
+        eptr = std::current_exception();
+      }
+    }
+  };
+
+  std::vector<std::thread> workers;
+  workers.reserve(n_chunks - 1u);
+  std::size_t k = 1u;
+  try {
+    for (; k < n_chunks; ++k) {
+      workers.emplace_back(run_chunk, k);
+    }
+  } catch (...) {
+    // Thread creation failed: the remaining chunks are processed below by the
+    // calling thread.
+  }
+  run_chunk(0u);
+  for (; k < n_chunks; ++k) {
+    run_chunk(k);
+  }
+  for (auto &w : workers) {
+    w.join();
+  }
+  if (eptr) {
+    std::rethrow_exception(eptr);
+  }
+}
+
+} // namespace kep3::detail
+
+#endif // kep3_DETAIL_PARALLEL_FOR_HPP
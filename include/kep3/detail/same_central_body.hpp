@@ -0,0 +1,32 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef kep3_DETAIL_SAME_CENTRAL_BODY_HPP
+#define kep3_DETAIL_SAME_CENTRAL_BODY_HPP
+
+#include <cmath>
+
+namespace kep3::detail {
+
+// Relative tolerance on the gravity parameters of planets orbiting the same
+// central body.
+inline constexpr double same_central_body_rtol = 1e-12;
+
+// Whether two gravity parameters belong to the same central body. NOTE: the
+// comparison is not exact as the same parameter can come out of different
+// computations (e.g. G times the mass, or a conversion of units) a few ulps
+// apart, while the constants of different ephemerides of a body differ at
+// the 1e-9 level or more, and are thus still told apart.
+inline bool same_central_body(double mu1, double mu2) {
+  return std::abs(mu1 - mu2) <= same_central_body_rtol * std::abs(mu1);
+}
+
+} // namespace kep3::detail
+
+#endif // kep3_DETAIL_SAME_CENTRAL_BODY_HPP
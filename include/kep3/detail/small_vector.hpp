@@ -0,0 +1,131 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef kep3_DETAIL_SMALL_VECTOR_HPP
+#define kep3_DETAIL_SMALL_VECTOR_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include <boost/serialization/split_member.hpp>
+
+// A vector of trivially copyable elements storing up to N of them inline, and
+// falling back to a heap buffer for larger sizes. The inline buffer is in use
+// whenever the heap pointer is null. A moved-from vector is empty and inline.
+namespace kep3::detail {
+
+template <typename T, std::size_t N> class small_vector {
+  static_assert(std::is_trivially_copyable_v<T>);
+
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using iterator = T *;
+  using const_iterator = const T *;
+
+  small_vector() = default;
+  explicit small_vector(size_type n) { resize(n); }
+  small_vector(const small_vector &other) { *this = other; }
+  small_vector(small_vector &&other) noexcept { *this = std::move(other); }
+  ~small_vector() = default;
+
+  // NOTE: the buffer of the copy is sized for the elements of other, so that
+  // a heap buffer larger than needed is released (and not reused) here.
+  small_vector &operator=(const small_vector &other) {
+    if (this != &other) {
+      m_heap.reset();
+      m_capacity = N;
+      m_size = 0u;
+      resize(other.m_size);
+      std::copy(other.begin(), other.end(), begin());
+    }
+    return *this;
+  }
+  small_vector &operator=(small_vector &&other) noexcept {
+    if (this != &other) {
+      m_heap = std::move(other.m_heap);
+      m_capacity = other.m_capacity;
+      m_size = other.m_size;
+      if (!m_heap) {
+        std::copy(other.m_inline.begin(), other.m_inline.begin() + m_size,
+                  m_inline.begin());
+      }
+      other.m_capacity = N;
+      other.m_size = 0u;
+    }
+    return *this;
+  }
+
+  // Resizes the vector, preserving the existing elements. The new elements
+  // are value initialised.
+  void resize(size_type n) {
+    if (n > m_capacity) {
+      auto heap = std::make_unique<T[]>(n);
+      std::copy(begin(), end(), heap.get());
+      m_heap = std::move(heap);
+      m_capacity = n;
+    } else {
+      std::fill(begin() + std::min(n, m_size), begin() + n, T{});
+    }
+    m_size = n;
+  }
+
+  [[nodiscard]] size_type size() const { return m_size; }
+  [[nodiscard]] size_type capacity() const { return m_capacity; }
+  [[nodiscard]] bool empty() const { return m_size == 0u; }
+  // Whether the elements are stored inline.
+  [[nodiscard]] bool is_inline() const { return !m_heap; }
+
+  T *data() { return m_heap ? m_heap.get() : m_inline.data(); }
+  [[nodiscard]] const T *data() const {
+    return m_heap ? m_heap.get() : m_inline.data();
+  }
+  T &operator[](size_type i) { return data()[i]; }
+  const T &operator[](size_type i) const { return data()[i]; }
+  iterator begin() { return data(); }
+  iterator end() { return data() + m_size; }
+  [[nodiscard]] const_iterator begin() const { return data(); }
+  [[nodiscard]] const_iterator end() const { return data() + m_size; }
+
+  friend bool operator==(const small_vector &a, const small_vector &b) {
+    return std::equal(a.begin(), a.end(), b.begin(), b.end());
+  }
+
+private:
+  friend class boost::serialization::access;
+  template <class Archive> void save(Archive &ar, unsigned) const {
+    ar << m_size;
+    for (const auto &val : *this) {
+      ar << val;
+    }
+  }
+  template <class Archive> void load(Archive &ar, unsigned) {
+    size_type size = 0u;
+    ar >> size;
+    m_size = 0u;
+    resize(size);
+    for (auto &val : *this) {
+      ar >> val;
+    }
+  }
+  BOOST_SERIALIZATION_SPLIT_MEMBER()
+
+  std::array<T, N> m_inline{};
+  std::unique_ptr<T[]> m_heap;
+  size_type m_capacity = N;
+  size_type m_size = 0u;
+};
+
+} // namespace kep3::detail
+
+#endif // kep3_DETAIL_SMALL_VECTOR_HPP
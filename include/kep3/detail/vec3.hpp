@@ -0,0 +1,65 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef kep3_DETAIL_VEC3_HPP
+#define kep3_DETAIL_VEC3_HPP
+
+#include <array>
+#include <cmath>
+
+// Minimal toolkit of operations on 3-vectors stored in std::array, used in
+// place of xtensor expressions in the hot paths. The functions are templated
+// on the scalar type so that they also work on dual numbers, and everything
+// but the norm is constexpr. Each operation is written out component by
+// component in the same order as the expressions it replaces, hence the
+// results do not depend on the compiler's choice of evaluation order.
+namespace kep3::detail {
+
+template <typename F> using vec3_t = std::array<F, 3>;
+using vec3 = vec3_t<double>;
+
+template <typename F>
+constexpr vec3_t<F> vec3_add(const vec3_t<F> &a, const vec3_t<F> &b) {
+  return {a[0] + b[0], a[1] + b[1], a[2] + b[2]};
+}
+
+template <typename F>
+constexpr vec3_t<F> vec3_sub(const vec3_t<F> &a, const vec3_t<F> &b) {
+  return {a[0] - b[0], a[1] - b[1], a[2] - b[2]};
+}
+
+template <typename F, typename S>
+constexpr vec3_t<F> vec3_mul(const vec3_t<F> &a, const S &s) {
+  return {a[0] * s, a[1] * s, a[2] * s};
+}
+
+template <typename F, typename S>
+constexpr vec3_t<F> vec3_div(const vec3_t<F> &a, const S &s) {
+  return {a[0] / s, a[1] / s, a[2] / s};
+}
+
+template <typename F>
+constexpr F vec3_dot(const vec3_t<F> &a, const vec3_t<F> &b) {
+  return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+template <typename F>
+constexpr vec3_t<F> vec3_cross(const vec3_t<F> &a, const vec3_t<F> &b) {
+  return {a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2],
+          a[0] * b[1] - a[1] * b[0]};
+}
+
+template <typename F> inline F vec3_norm(const vec3_t<F> &a) {
+  using std::sqrt;
+  return sqrt(vec3_dot(a, a));
+}
+
+} // namespace kep3::detail
+
+#endif // kep3_DETAIL_VEC3_HPP
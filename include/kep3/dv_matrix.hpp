@@ -0,0 +1,95 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef kep3_DV_MATRIX_H
+#define kep3_DV_MATRIX_H
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <kep3/detail/visibility.hpp>
+#include <kep3/lambert_solve.hpp>
+#include <kep3/planet.hpp>
+
+namespace kep3 {
+
+/// Result of an all-pairs DV computation
+/**
+ * The DVs are stored in row major order as an array of shape (n_dep, n_tof,
+ * n_targets, n_targets), element (k, l, i, j) being the total DV of the
+ * transfer leaving target i at the departure epoch k and reaching target j
+ * after the time of flight l. They are NaN where no transfer was found.
+ */
+struct dv_matrix_result {
+  std::size_t n_dep = 0u;
+  std::size_t n_tof = 0u;
+  std::size_t n_targets = 0u;
+  std::vector<double> dv;
+};
+
+/// All-pairs DV matrix between a set of planets
+/**
+ * Computes the Lambert transfers between all the ordered pairs of targets
+ * (including each target with itself), for all the departure epochs and
+ * times of flight, choosing for each pair the solution with minimum total DV
+ * (departure plus arrival excess velocity) among those with up to multi_revs
+ * revolutions. The ephemerides of the targets are evaluated once per
+ * departure and arrival epoch, and each matrix is then split in square tiles
+ * solved in parallel, so that the states used by a tile stay in cache. The
+ * gravity parameter is the one of the central body of the first target. It
+ * throws std::domain_error if this gravity parameter is not positive and
+ * std::invalid_argument if the targets do not all orbit the same central
+ * body (as in kep3::porkchop()).
+ *
+ * The result holds n_dep * n_tof * n_targets^2 values: for large catalogs
+ * kep3::dv_matrix_save_npy() should be used instead.
+ *
+ * \param[in] targets the planets.
+ * \param[in] t_dep the departure epochs (MJD2000).
+ * \param[in] tof the times of flight (days).
+ * \param[in] cw when true a retrograde orbit is assumed.
+ * \param[in] multi_revs maximum number of revolutions to consider.
+ * \param[in] accuracy the accuracy profile.
+ *
+ * \return the DV matrices.
+ */
+kep3_DLL_PUBLIC dv_matrix_result
+dv_matrix(std::vector<planet> targets, std::span<const double> t_dep,
+          std::span<const double> tof, bool cw = false,
+          unsigned multi_revs = 0u,
+          lambert_accuracy accuracy = lambert_accuracy::standard);
+
+/// All-pairs DV matrix streamed to a .npy file
+/**
+ * Computes the same values as kep3::dv_matrix(), writing them to filename as
+ * a float64 array of shape (n_dep, n_tof, n_targets, n_targets) as soon as
+ * each band of rows is complete. Only one band of rows is held in memory, so
+ * that matrices larger than the available RAM can be computed and later read
+ * with numpy.load(..., mmap_mode='r'). It throws the same exceptions as
+ * kep3::dv_matrix(), and std::runtime_error if the file cannot be written.
+ *
+ * \param[in] targets the planets.
+ * \param[in] t_dep the departure epochs (MJD2000).
+ * \param[in] tof the times of flight (days).
+ * \param[in] filename the file to write.
+ * \param[in] cw when true a retrograde orbit is assumed.
+ * \param[in] multi_revs maximum number of revolutions to consider.
+ * \param[in] accuracy the accuracy profile.
+ */
+kep3_DLL_PUBLIC void
+dv_matrix_save_npy(std::vector<planet> targets, std::span<const double> t_dep,
+                   std::span<const double> tof, const std::string &filename,
+                   bool cw = false, unsigned multi_revs = 0u,
+                   lambert_accuracy accuracy = lambert_accuracy::standard);
+
+} // namespace kep3
+
+#endif // kep3_DV_MATRIX_H
@@ -0,0 +1,31 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef kep3_LAMBERT_ACCURACY_H
+#define kep3_LAMBERT_ACCURACY_H
+
+namespace kep3 {
+
+/// Accuracy profiles of the Lambert solvers
+/**
+ * Select the convergence tolerances of the Householder iterations, their
+ * maximum number and the truncation of the hypergeometric series used close
+ * to the parabola. The standard profile corresponds to the settings
+ * historically used by kep3::lambert_problem (relative velocity errors
+ * below 1e-12). The fast profile saves most of one iteration per solution at
+ * the price of rare errors up to ~1e-4, which is adequate for coarse
+ * screening (e.g. porkchop plots). The precise profile makes one more
+ * iteration and sums the hypergeometric series to machine precision, for the
+ * final refinement of the solutions.
+ */
+enum class lambert_accuracy : unsigned char { fast, standard, precise };
+
+} // namespace kep3
+
+#endif // kep3_LAMBERT_ACCURACY_H
@@ -0,0 +1,139 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef kep3_LAMBERT_BATCH_H
+#define kep3_LAMBERT_BATCH_H
+
+#include <array>
+#include <span>
+
+#include <kep3/detail/visibility.hpp>
+#include <kep3/lambert_solve.hpp>
+
+namespace kep3 {
+
+/// Inputs of a batch of Lambert problems in SoA form
+/**
+ * All spans must have the same size with the exception of mu, which can also
+ * contain one element only, used for all problems.
+ */
+struct lambert_batch_input {
+  std::span<const double> r1x, r1y, r1z;
+  std::span<const double> r2x, r2y, r2z;
+  std::span<const double> tof;
+  std::span<const double> mu;
+};
+
+/// Outputs of a batch of Lambert problems in SoA form
+/**
+ * The velocities and the status must have the same size as the inputs. x and
+ * iters are optional and are only written when not empty. Whenever the status
+ * is not lambert_status::success the velocities of the problem are set to NaN.
+ */
+struct lambert_batch_output {
+  std::span<double> v1x, v1y, v1z;
+  std::span<double> v2x, v2y, v2z;
+  std::span<lambert_status> status;
+  std::span<double> x = {};
+  std::span<unsigned> iters = {};
+};
+
+/// Batch Lambert solver
+/**
+ * Solves many Lambert problems for the same branch, writing the results in
+ * caller-provided storage. It never allocates nor throws on degenerate
+ * problems: a status for each problem is returned instead. It throws
+ * std::invalid_argument only if the spans have inconsistent sizes.
+ *
+ * \param[in] in the problems (r1, r2, tof, mu).
+ * \param[out] out the velocities at r1 and r2 and the status of each problem.
+ * \param[in] cw when true a retrograde orbit is assumed.
+ * \param[in] branch the solution to compute.
+ * \param[in] accuracy the accuracy profile.
+ */
+kep3_DLL_PUBLIC void
+lambert_batch(const lambert_batch_input &in, const lambert_batch_output &out,
+              bool cw = false, lambert_branch branch = {},
+              lambert_accuracy accuracy = lambert_accuracy::standard);
+
+/// Batch Lambert solver in lanes (zero revolutions)
+/**
+ * Same as lambert_batch for the zero revolutions branch, but solves
+ * lanes problems at once running their Householder iterations in
+ * lockstep, one problem per lane. Lanes converge independently and the
+ * time of flight expression (Battin, Lagrange or Lancaster) is selected per
+ * lane, so the results are the same as those of lambert_batch.
+ *
+ * \param[in] in the problems (r1, r2, tof, mu).
+ * \param[out] out the velocities at r1 and r2 and the status of each problem.
+ * \param[in] cw when true a retrograde orbit is assumed.
+ * \param[in] lanes the number of problems solved at once (4 or 8).
+ * \param[in] accuracy the accuracy profile.
+ */
+kep3_DLL_PUBLIC void
+lambert_batch_lanes(const lambert_batch_input &in,
+                    const lambert_batch_output &out, bool cw = false,
+                    unsigned lanes = 4u,
+                    lambert_accuracy accuracy = lambert_accuracy::standard);
+
+/// Lambert solver sweeping the time of flight between fixed positions
+/**
+ * Solves the Lambert problems from r1 to r2 for all the times of flight in
+ * tof, as found for instance along a column of a porkchop plot. The geometry
+ * (and, for N > 0, the minimum time of flight of the branch) is computed only
+ * once, and each solution is warm started from the previous one via a second
+ * order Taylor predictor of x(T) built from the derivatives of T(x), so that
+ * typically one or two Householder iterations per point are needed when tof is
+ * sorted (unsorted values are still solved correctly, only less efficiently).
+ * Like lambert_batch, it never throws on degenerate problems.
+ *
+ * \param[in] r1 first cartesian position.
+ * \param[in] r2 second cartesian position.
+ * \param[in] tof the times of flight.
+ * \param[in] mu gravity parameter.
+ * \param[out] out the velocities at r1 and r2 and the status for each tof.
+ * \param[in] cw when true a retrograde orbit is assumed.
+ * \param[in] branch the solution to compute.
+ * \param[in] accuracy the accuracy profile.
+ */
+kep3_DLL_PUBLIC void
+lambert_sweep(const std::array<double, 3> &r1, const std::array<double, 3> &r2,
+              std::span<const double> tof, double mu,
+              const lambert_batch_output &out, bool cw = false,
+              lambert_branch branch = {},
+              lambert_accuracy accuracy = lambert_accuracy::standard);
+
+/// One-to-many Lambert solver
+/**
+ * Solves the Lambert problems from a single departure position r1 to many
+ * arrival positions, given in SoA form, for the same branch. The quantities
+ * depending on r1 only (its norm and direction) are computed once, and the
+ * solutions are written in caller-provided storage as in lambert_batch, ready
+ * for the computation of the DV at departure and arrival.
+ *
+ * \param[in] r1 departure position.
+ * \param[in] r2x, r2y, r2z arrival positions.
+ * \param[in] tof the times of flight (one per arrival position, or a single
+ * one used for all).
+ * \param[in] mu gravity parameter.
+ * \param[out] out the velocities at r1 and r2 and the status of each problem.
+ * \param[in] cw when true a retrograde orbit is assumed.
+ * \param[in] branch the solution to compute.
+ * \param[in] accuracy the accuracy profile.
+ */
+kep3_DLL_PUBLIC void lambert_one_to_many(
+    const std::array<double, 3> &r1, std::span<const double> r2x,
+    std::span<const double> r2y, std::span<const double> r2z,
+    std::span<const double> tof, double mu, const lambert_batch_output &out,
+    bool cw = false, lambert_branch branch = {},
+    lambert_accuracy accuracy = lambert_accuracy::standard);
+
+} // namespace kep3
+
+#endif // kep3_LAMBERT_BATCH_H
@@ -0,0 +1,125 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef kep3_LAMBERT_BOUNDS_H
+#define kep3_LAMBERT_BOUNDS_H
+
+#include <array>
+
+#include <kep3/detail/visibility.hpp>
+
+// Quantities of a Lambert problem which can be computed without solving it,
+// from the non dimensional geometry (lambda) and time of flight (T) only.
+// They are meant for pruning in combinatorial searches, before paying for a
+// solution. As kep3::lambert_problem, they throw std::domain_error if the
+// gravity parameter is not positive, if the time of flight is negative or if
+// the direction of motion cannot be defined.
+namespace kep3 {
+
+/// Time of flight of the parabolic transfer
+/**
+ * Solutions with zero revolutions are hyperbolic for shorter times of flight
+ * and elliptic for longer ones.
+ *
+ * \param[in] r1 first cartesian position.
+ * \param[in] r2 second cartesian position.
+ * \param[in] mu gravity parameter.
+ * \param[in] cw when true a retrograde orbit is assumed.
+ *
+ * \return the time of flight.
+ */
+kep3_DLL_PUBLIC double lambert_tof_parabolic(const std::array<double, 3> &r1,
+                                             const std::array<double, 3> &r2,
+                                             double mu, bool cw = false);
+
+/// Time of flight of the minimum energy transfer
+/**
+ * The minimum energy transfer (x = 0) has semi-major axis s / 2, where s is
+ * the semiperimeter of the triangle formed by r1, r2 and the chord.
+ *
+ * \param[in] r1 first cartesian position.
+ * \param[in] r2 second cartesian position.
+ * \param[in] mu gravity parameter.
+ * \param[in] cw when true a retrograde orbit is assumed.
+ * \param[in] N number of revolutions.
+ *
+ * \return the time of flight.
+ */
+kep3_DLL_PUBLIC double
+lambert_tof_min_energy(const std::array<double, 3> &r1,
+                       const std::array<double, 3> &r2, double mu,
+                       bool cw = false, unsigned N = 0u);
+
+/// Minimum time of flight allowing N revolutions
+/**
+ * Solutions with N > 0 revolutions exist only for times of flight not smaller
+ * than this value, which is zero for N = 0.
+ *
+ * \param[in] r1 first cartesian position.
+ * \param[in] r2 second cartesian position.
+ * \param[in] mu gravity parameter.
+ * \param[in] cw when true a retrograde orbit is assumed.
+ * \param[in] N number of revolutions.
+ *
+ * \return the minimum time of flight.
+ */
+kep3_DLL_PUBLIC double lambert_tof_min(const std::array<double, 3> &r1,
+                                       const std::array<double, 3> &r2,
+                                       double mu, bool cw, unsigned N);
+
+/// Maximum number of revolutions of a Lambert problem
+/**
+ * The same value returned by kep3::lambert_problem::get_Nmax().
+ *
+ * \param[in] r1 first cartesian position.
+ * \param[in] r2 second cartesian position.
+ * \param[in] tof time of flight.
+ * \param[in] mu gravity parameter.
+ * \param[in] cw when true a retrograde orbit is assumed.
+ * \param[in] multi_revs maximum number of revolutions to consider.
+ *
+ * \return the maximum number of revolutions for which solutions exist.
+ */
+kep3_DLL_PUBLIC unsigned lambert_Nmax(const std::array<double, 3> &r1,
+                                      const std::array<double, 3> &r2,
+                                      double tof, double mu, bool cw = false,
+                                      unsigned multi_revs = 5u);
+
+/// Lower bound of the DV of a Lambert transfer
+/**
+ * Bounds from below |v1 - v_dep| + |v2 - v_arr| over all the solutions with
+ * up to multi_revs revolutions, where v_dep and v_arr are the velocities of
+ * the departure and arrival bodies. The solution x of each branch is bracketed
+ * without iterations: the transfer lasts between N and N + 1 periods, which
+ * bounds the semi-major axis, and for zero revolutions T(x) is monotonic,
+ * which places x with respect to the parabolic and minimum energy transfers.
+ * The radial and tangential components of the velocities are then bounded
+ * over the bracket. Only the components of v_dep and v_arr out of the plane of
+ * the transfer are accounted for with hyperbolic transfers.
+ *
+ * \param[in] r1 first cartesian position.
+ * \param[in] r2 second cartesian position.
+ * \param[in] tof time of flight.
+ * \param[in] mu gravity parameter.
+ * \param[in] v_dep velocity of the departure body.
+ * \param[in] v_arr velocity of the arrival body.
+ * \param[in] cw when true a retrograde orbit is assumed.
+ * \param[in] multi_revs maximum number of revolutions to consider.
+ *
+ * \return the lower bound of the DV.
+ */
+kep3_DLL_PUBLIC double lambert_dv_lower_bound(
+    const std::array<double, 3> &r1, const std::array<double, 3> &r2,
+    double tof, double mu, const std::array<double, 3> &v_dep,
+    const std::array<double, 3> &v_arr, bool cw = false,
+    unsigned multi_revs = 5u);
+
+} // namespace kep3
+
+#endif // kep3_LAMBERT_BOUNDS_H
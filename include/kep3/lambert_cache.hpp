@@ -0,0 +1,85 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef kep3_LAMBERT_CACHE_H
+#define kep3_LAMBERT_CACHE_H
+
+#include <array>
+#include <cstddef>
+#include <memory>
+
+#include <kep3/detail/visibility.hpp>
+#include <kep3/lambert_problem.hpp>
+
+namespace kep3 {
+
+/// Memoization cache of Lambert problems
+/**
+ * Stores the solved kep3::lambert_problem objects keyed on their inputs (r1,
+ * r2, tof, mu, cw, multi_revs and the kep3::lambert_options), so that
+ * optimizers evaluating the same legs over and over solve each of them once.
+ * Each floating point input is quantized to a relative precision of rel_tol
+ * before being used as a key: problems whose inputs agree to about rel_tol
+ * share the same solution, that of the first one solved, at the price of an
+ * error in the velocities of the same relative order. With rel_tol equal to
+ * zero only identical inputs match.
+ *
+ * The cache holds at most capacity problems, evicting the least recently used
+ * ones. It is safe to call get() from several threads: the entries are split
+ * in independently locked shards, and the Lambert problems are solved outside
+ * the locks. The counters of hits and misses allow to tune rel_tol.
+ *
+ * A moved-from cache can only be destroyed or assigned to: any other member
+ * function but is_valid() throws std::logic_error.
+ */
+class kep3_DLL_PUBLIC lambert_cache {
+  struct impl;
+  std::unique_ptr<impl> m_impl;
+
+  [[nodiscard]] impl &get_impl() const;
+
+public:
+  // It throws std::invalid_argument if capacity or n_shards are zero, or if
+  // rel_tol is not zero nor in [1e-15, 1).
+  explicit lambert_cache(std::size_t capacity = 1u << 16u,
+                         double rel_tol = 1e-12, unsigned n_shards = 16u);
+  lambert_cache(const lambert_cache &) = delete;
+  lambert_cache(lambert_cache &&) noexcept;
+  lambert_cache &operator=(const lambert_cache &) = delete;
+  lambert_cache &operator=(lambert_cache &&) noexcept;
+  ~lambert_cache();
+
+  // Check if the cache is valid (i.e. has not been moved from)
+  [[nodiscard]] bool is_valid() const;
+
+  // The solved problem, from the cache if possible. It throws the same
+  // exceptions as the constructor of kep3::lambert_problem, in which case
+  // nothing is cached.
+  [[nodiscard]] lambert_problem get(const std::array<double, 3> &r1,
+                                    const std::array<double, 3> &r2,
+                                    double tof, double mu, bool cw = false,
+                                    unsigned multi_revs = 5u,
+                                    const lambert_options &options = {});
+
+  [[nodiscard]] std::size_t get_capacity() const;
+  [[nodiscard]] double get_rel_tol() const;
+  // Number of problems currently cached.
+  [[nodiscard]] std::size_t size() const;
+  [[nodiscard]] unsigned long long get_hits() const;
+  [[nodiscard]] unsigned long long get_misses() const;
+  // Fraction of the calls to get() served from the cache (zero if none).
+  [[nodiscard]] double get_hit_rate() const;
+  // Empties the cache, leaving the counters untouched.
+  void clear();
+  void reset_counters();
+};
+
+} // namespace kep3
+
+#endif // kep3_LAMBERT_CACHE_H
@@ -10,16 +10,38 @@
 #ifndef kep3_LAMBERT_PROBLEM_H
 #define kep3_LAMBERT_PROBLEM_H
 
+#include <algorithm>
 #include <array>
 #include <cmath>
+#include <cstddef>
+#include <span>
 #include <vector>
 
 #include <kep3/core_astro/constants.hpp>
 #include <kep3/detail/s11n.hpp>
+#include <kep3/detail/small_vector.hpp>
 #include <kep3/detail/visibility.hpp>
+#include <kep3/lambert_accuracy.hpp>
 
 namespace kep3 {
 
+/// Options of the Lambert problem
+/**
+ * Optional settings of kep3::lambert_problem (and of kep3::lambert_cache),
+ * to be given by name, e.g. lambert_options{.tabulated_guess = true}.
+ */
+struct lambert_options {
+  // When true the Jacobians of the velocities with respect to r1, r2 and tof
+  // are also computed (see lambert_problem::get_dv1_dp()).
+  bool sensitivities = false;
+  // When true the Householder iterations are started from a precomputed
+  // table of the solutions (available up to 5 revolutions), rather than from
+  // the analytic initial guesses, saving most iterations.
+  bool tabulated_guess = false;
+  // The tolerances and maximum number of the Householder iterations.
+  lambert_accuracy accuracy = lambert_accuracy::standard;
+};
+
 /// Lambert Problem
 /**
  * This class represent a Lambert's problem. When instantiated it assumes a
@@ -51,59 +73,125 @@ class kep3_DLL_PUBLIC lambert_problem {
   static const std::array<double, 3> default_r1;
   static const std::array<double, 3> default_r2;
 
+  // Number of solutions stored inline, i.e. without allocations (up to 5
+  // revolutions).
+  static constexpr std::size_t inline_solutions = 11u;
+  // Container of the solutions.
+  template <typename T>
+  using solutions_vector = detail::small_vector<T, inline_solutions>;
+
 public:
   friend kep3_DLL_PUBLIC std::ostream &operator<<(std::ostream &,
                                                   const lambert_problem &);
   explicit lambert_problem(const std::array<double, 3> &r1 = default_r1,
                            const std::array<double, 3> &r2 = default_r2,
                            double tof = kep3::pi / 2, double mu = 1.,
-                           bool cw = false, unsigned multi_revs = 5);
-  [[nodiscard]] const std::vector<std::array<double, 3>> &get_v1() const;
-  [[nodiscard]] const std::vector<std::array<double, 3>> &get_v2() const;
+                           bool cw = false, unsigned multi_revs = 5,
+                           const lambert_options &options = {});
+  // NOTE: get_v1(), get_v2(), get_x() and get_iters() return copies of the
+  // solutions, allocating a std::vector at each call. Loops calling them
+  // repeatedly should use the views get_*_span() below instead.
+  [[nodiscard]] std::vector<std::array<double, 3>> get_v1() const;
+  [[nodiscard]] std::vector<std::array<double, 3>> get_v2() const;
   [[nodiscard]] const std::array<double, 3> &get_r1() const;
   [[nodiscard]] const std::array<double, 3> &get_r2() const;
   [[nodiscard]] const double &get_tof() const;
   [[nodiscard]] const double &get_mu() const;
-  [[nodiscard]] const std::vector<double> &get_x() const;
-  [[nodiscard]] const std::vector<unsigned> &get_iters() const;
+  [[nodiscard]] std::vector<double> get_x() const;
+  [[nodiscard]] std::vector<unsigned> get_iters() const;
+  // Views of the solutions, as get_v1(), get_v2(), get_x() and get_iters()
+  // but without copying them. They are valid as long as the object is alive
+  // and not assigned to.
+  [[nodiscard]] std::span<const std::array<double, 3>> get_v1_span() const;
+  [[nodiscard]] std::span<const std::array<double, 3>> get_v2_span() const;
+  [[nodiscard]] std::span<const double> get_x_span() const;
+  [[nodiscard]] std::span<const unsigned> get_iters_span() const;
   [[nodiscard]] unsigned get_Nmax() const;
+  [[nodiscard]] bool get_converged() const;
+  [[nodiscard]] const std::vector<std::array<std::array<double, 7>, 3>> &
+  get_dv1_dp() const;
+  [[nodiscard]] const std::vector<std::array<std::array<double, 7>, 3>> &
+  get_dv2_dp() const;
 
 private:
-  unsigned householder(double, double &, unsigned, double, unsigned) const;
-  void dTdx(double &, double &, double &, double, double) const;
-  void x2tof(double &tof, double x0, unsigned N) const;
-  void x2tof2(double &tof, double x0, unsigned N) const ;
-  [[nodiscard]] double hypergeometricF(double z, double tol) const;
   friend class boost::serialization::access;
-  template <class Archive> void serialize(Archive &ar, const unsigned int) {
-    ar &m_r1;
-    ar &m_r2;
-    ar &m_tof;
-    ar &m_mu;
-    ar &m_v1;
-    ar &m_v2;
-    ar &m_iters;
-    ar &m_x;
-    ar &m_s;
-    ar &m_c;
-    ar &m_lambda;
-    ar &m_iters;
-    ar &m_Nmax;
-    ar &m_has_converged;
-    ar &m_multi_revs;
+  template <class Archive> void save(Archive &ar, const unsigned int) const {
+    ar << m_r1;
+    ar << m_r2;
+    ar << m_tof;
+    ar << m_mu;
+    ar << m_v1;
+    ar << m_v2;
+    ar << m_iters;
+    ar << m_x;
+    ar << m_s;
+    ar << m_c;
+    ar << m_lambda;
+    ar << m_Nmax;
+    ar << m_has_converged;
+    ar << m_multi_revs;
+    ar << m_dv1_dp;
+    ar << m_dv2_dp;
+  }
+  template <class Archive> void load(Archive &ar, const unsigned int version) {
+    ar >> m_r1;
+    ar >> m_r2;
+    ar >> m_tof;
+    ar >> m_mu;
+    if (version == 0u) {
+      // NOTE: version 0 stored the solutions in std::vector, m_iters twice
+      // and no sensitivities.
+      load_solutions_v0(ar, m_v1);
+      load_solutions_v0(ar, m_v2);
+      load_solutions_v0(ar, m_iters);
+      load_solutions_v0(ar, m_x);
+      ar >> m_s;
+      ar >> m_c;
+      ar >> m_lambda;
+      load_solutions_v0(ar, m_iters);
+      ar >> m_Nmax;
+      ar >> m_has_converged;
+      ar >> m_multi_revs;
+      m_dv1_dp.clear();
+      m_dv2_dp.clear();
+      return;
+    }
+    ar >> m_v1;
+    ar >> m_v2;
+    ar >> m_iters;
+    ar >> m_x;
+    ar >> m_s;
+    ar >> m_c;
+    ar >> m_lambda;
+    ar >> m_Nmax;
+    ar >> m_has_converged;
+    ar >> m_multi_revs;
+    ar >> m_dv1_dp;
+    ar >> m_dv2_dp;
+  }
+  BOOST_SERIALIZATION_SPLIT_MEMBER()
+
+  template <class Archive, typename T>
+  static void load_solutions_v0(Archive &ar, solutions_vector<T> &out) {
+    std::vector<T> tmp;
+    ar >> tmp;
+    out.resize(tmp.size());
+    std::copy(tmp.begin(), tmp.end(), out.begin());
   }
 
   std::array<double, 3> m_r1, m_r2;
   double m_tof;
   double m_mu;
-  std::vector<std::array<double, 3>> m_v1;
-  std::vector<std::array<double, 3>> m_v2;
-  std::vector<unsigned> m_iters;
-  std::vector<double> m_x;
+  solutions_vector<std::array<double, 3>> m_v1;
+  solutions_vector<std::array<double, 3>> m_v2;
+  solutions_vector<unsigned> m_iters;
+  solutions_vector<double> m_x;
   double m_s, m_c, m_lambda;
   unsigned m_Nmax;
   bool m_has_converged;
   unsigned m_multi_revs;
+  std::vector<std::array<std::array<double, 7>, 3>> m_dv1_dp;
+  std::vector<std::array<std::array<double, 7>, 3>> m_dv2_dp;
 };
 
 // Streaming operator for the class kep3::lambert_problem.
@@ -112,4 +200,7 @@ kep3_DLL_PUBLIC std::ostream &operator<<(std::ostream &,
 
 } // namespace kep3
 
+// Version 1 stores the solutions in solutions_vector and the sensitivities.
+BOOST_CLASS_VERSION(kep3::lambert_problem, 1)
+
 #endif // kep3_LAMBERT_PROBLEM_H
\ No newline at end of file
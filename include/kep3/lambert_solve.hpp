@@ -0,0 +1,132 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef kep3_LAMBERT_SOLVE_H
+#define kep3_LAMBERT_SOLVE_H
+
+#include <array>
+#include <limits>
+
+#include <kep3/detail/visibility.hpp>
+#include <kep3/lambert_accuracy.hpp>
+
+namespace kep3 {
+
+/// Outcome of the solution of one Lambert problem.
+enum class lambert_status : unsigned char {
+  success,             // the solution was found
+  invalid_tof,         // the time of flight is not positive
+  invalid_mu,          // the gravity parameter is not positive
+  degenerate_geometry, // the transfer plane has no z component in its normal
+  no_solution,         // the requested number of revolutions is not feasible
+  not_converged,       // the iterations limit was hit before converging
+  bracket_not_found    // the solution could not be bracketed (universal
+                       // engine, extremely fast hyperbolic transfers)
+};
+
+/// Algorithms solving the Lambert problem
+/**
+ * izzo is the algorithm of kep3::lambert_problem (Izzo, 2015), iterating on
+ * the non dimensional variable x with Householder steps. universal iterates
+ * with safeguarded Newton steps on the universal variable psi = DE^2 (Bate,
+ * Mueller and White, 1971), a classical formulation kept as a reference to
+ * compare against: it needs several times more evaluations of the time of
+ * flight, and it is singular for transfer angles of exactly 180 degrees. It
+ * also loses accuracy on extremely fast hyperbolic transfers, for which it
+ * may return lambert_status::bracket_not_found.
+ */
+enum class lambert_engine : unsigned char { izzo, universal };
+
+/// Branch of the Lambert solutions
+/**
+ * Selects one of the 2N_max+1 solutions of a Lambert problem: the zero
+ * revolutions one (N = 0) or, for N > 0, the left or right one. With the
+ * ordering used by kep3::lambert_problem this is the solution with index 0
+ * for N = 0 and 2N-1 (left) or 2N (right) otherwise.
+ */
+struct lambert_branch {
+  unsigned N = 0u;
+  bool right = false;
+};
+
+/// A single solution of a Lambert problem
+/**
+ * Whenever status is not lambert_status::success the velocities are NaN.
+ */
+struct lambert_solution {
+  std::array<double, 3> v1 = {std::numeric_limits<double>::quiet_NaN(),
+                              std::numeric_limits<double>::quiet_NaN(),
+                              std::numeric_limits<double>::quiet_NaN()};
+  std::array<double, 3> v2 = v1;
+  double x = std::numeric_limits<double>::quiet_NaN();
+  unsigned iters = 0u;
+  lambert_branch branch = {};
+  lambert_status status = lambert_status::no_solution;
+};
+
+/// Solves one branch of a Lambert problem
+/**
+ * Contrary to kep3::lambert_problem, which computes all the 2N_max+1
+ * solutions, only the requested branch is iterated upon. It never throws:
+ * problems that cannot be solved are signalled by the status of the
+ * returned solution.
+ *
+ * \param[in] r1 first cartesian position.
+ * \param[in] r2 second cartesian position.
+ * \param[in] tof time of flight.
+ * \param[in] mu gravity parameter.
+ * \param[in] cw when true a retrograde orbit is assumed.
+ * \param[in] branch the solution to compute.
+ * \param[in] accuracy the accuracy profile.
+ * \param[in] engine the algorithm used. With lambert_engine::universal, the
+ * iters member of the solution counts the evaluations of the time of flight
+ * (including those locating its minimum for N > 0), and x is the variable of
+ * lambert_engine::izzo corresponding to the solution found.
+ *
+ * \return the solution.
+ */
+kep3_DLL_PUBLIC lambert_solution
+lambert_solve(const std::array<double, 3> &r1, const std::array<double, 3> &r2,
+              double tof, double mu, bool cw = false, lambert_branch branch = {},
+              lambert_accuracy accuracy = lambert_accuracy::standard,
+              lambert_engine engine = lambert_engine::izzo);
+
+/// Solves a Lambert problem for the branch with minimum DV
+/**
+ * Finds, among the solutions with up to multi_revs revolutions, the one
+ * minimizing |v1 - v_dep| + |v2 - v_arr|, where v_dep and v_arr are the
+ * velocities of the departure and arrival bodies. The branches are solved
+ * in order of increasing DV lower bound, and the search stops as soon as the
+ * bound exceeds the best DV found. For N > 0 the transfer lasts between N
+ * and N + 1 periods, which bounds the semi-major axis and hence x: the
+ * radial and tangential components of the velocities are then bounded over
+ * the admissible x, giving the DV lower bound at a negligible cost.
+ *
+ * \param[in] r1 first cartesian position.
+ * \param[in] r2 second cartesian position.
+ * \param[in] tof time of flight.
+ * \param[in] mu gravity parameter.
+ * \param[in] v_dep velocity of the departure body.
+ * \param[in] v_arr velocity of the arrival body.
+ * \param[in] cw when true a retrograde orbit is assumed.
+ * \param[in] multi_revs maximum number of revolutions to consider.
+ * \param[in] accuracy the accuracy profile.
+ *
+ * \return the solution with minimum DV.
+ */
+kep3_DLL_PUBLIC lambert_solution lambert_solve_min_dv(
+    const std::array<double, 3> &r1, const std::array<double, 3> &r2,
+    double tof, double mu, const std::array<double, 3> &v_dep,
+    const std::array<double, 3> &v_arr, bool cw = false,
+    unsigned multi_revs = 5u,
+    lambert_accuracy accuracy = lambert_accuracy::standard);
+
+} // namespace kep3
+
+#endif // kep3_LAMBERT_SOLVE_H
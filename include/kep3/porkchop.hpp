@@ -0,0 +1,86 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef kep3_PORKCHOP_H
+#define kep3_PORKCHOP_H
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <kep3/detail/visibility.hpp>
+#include <kep3/lambert_solve.hpp>
+#include <kep3/planet.hpp>
+
+namespace kep3 {
+
+/// Result of a porkchop computation
+/**
+ * The matrices are stored in row major order, element (i, j) referring to the
+ * departure epoch i and the arrival epoch j. They are NaN where no transfer
+ * was found (e.g. when the arrival precedes the departure).
+ */
+struct porkchop_result {
+  std::size_t n_dep = 0u;
+  std::size_t n_arr = 0u;
+  // Departure C3, i.e. the square of the departure hyperbolic excess velocity.
+  std::vector<double> c3;
+  // Arrival hyperbolic excess velocity.
+  std::vector<double> vinf_arr;
+  // Total DV, i.e. the sum of the departure and arrival excess velocities.
+  std::vector<double> dv;
+};
+
+/// Porkchop plot between two planets
+/**
+ * Computes the Lambert transfers between dep and arr for all the pairs of
+ * departure and arrival epochs, choosing for each pair the solution with
+ * minimum total DV among those with up to multi_revs revolutions (see
+ * kep3::lambert_solve_min_dv()). The ephemerides of each planet are evaluated
+ * once per grid epoch, and the grid is then split in square tiles solved in
+ * parallel, each tile reusing the same few positions and velocities. The
+ * gravity parameter is the one of the central body of dep. Units are those of
+ * the planets' ephemerides. It throws std::domain_error if this gravity
+ * parameter is not positive and std::invalid_argument if arr does not orbit
+ * the same central body (i.e. if the gravity parameters differ by more than
+ * one part in 1e12).
+ *
+ * \param[in] dep departure planet.
+ * \param[in] arr arrival planet.
+ * \param[in] t_dep the departure epochs (MJD2000).
+ * \param[in] t_arr the arrival epochs (MJD2000).
+ * \param[in] cw when true a retrograde orbit is assumed.
+ * \param[in] multi_revs maximum number of revolutions to consider.
+ * \param[in] accuracy the accuracy profile.
+ *
+ * \return the C3, arrival excess velocity and total DV matrices.
+ */
+kep3_DLL_PUBLIC porkchop_result
+porkchop(planet dep, planet arr, std::span<const double> t_dep,
+         std::span<const double> t_arr, bool cw = false,
+         unsigned multi_revs = 0u,
+         lambert_accuracy accuracy = lambert_accuracy::standard);
+
+/// Saves a porkchop in the .npy format
+/**
+ * Writes a float64 array of shape (3, n_dep, n_arr) holding, in this order,
+ * the C3, the arrival excess velocity and the total DV, which can be read
+ * with numpy.load(). It throws std::runtime_error if the file cannot be
+ * written.
+ *
+ * \param[in] res the porkchop.
+ * \param[in] filename the file to write.
+ */
+kep3_DLL_PUBLIC void porkchop_save_npy(const porkchop_result &res,
+                                       const std::string &filename);
+
+} // namespace kep3
+
+#endif // kep3_PORKCHOP_H
@@ -0,0 +1,83 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef kep3_WINDOW_SEARCH_H
+#define kep3_WINDOW_SEARCH_H
+
+#include <array>
+#include <vector>
+
+#include <kep3/detail/visibility.hpp>
+#include <kep3/planet.hpp>
+
+namespace kep3 {
+
+/// A launch window, i.e. a local minimum of the DV
+struct launch_window {
+  // Departure epoch (MJD2000) and time of flight (days).
+  double t_dep = 0.;
+  double tof = 0.;
+  // Departure C3, arrival hyperbolic excess velocity and total DV.
+  double c3 = 0.;
+  double vinf_arr = 0.;
+  double dv = 0.;
+};
+
+/// Result of an adaptive launch window search
+struct window_search_result {
+  // The windows found, sorted by increasing DV.
+  std::vector<launch_window> windows;
+  // Number of Lambert problems solved.
+  unsigned long n_lambert = 0u;
+};
+
+/// Adaptive search of the launch windows between two planets
+/**
+ * Looks for the local minima of the total DV (departure plus arrival excess
+ * velocity) of the transfers between dep and arr, as functions of the
+ * departure epoch and of the time of flight, without computing a dense
+ * porkchop plot. The DV is first evaluated on a coarse grid_size x grid_size
+ * grid, and each local minimum of the grid is then refined by a pattern
+ * search: the eight neighbours at distance h of the best point are
+ * evaluated, moving to the best of them if it improves the DV and halving h
+ * otherwise, until h is smaller than tol. As the minima are only located to
+ * within tol, those ending up within merge_factor * tol of each other, in
+ * both the departure epoch and the time of flight, are taken to be the same
+ * window and merged, keeping the best one. Each evaluation solves the Lambert
+ * problem as kep3::porkchop(), keeping the solution with minimum DV among
+ * those with up to multi_revs revolutions. The gravity parameter is the one
+ * of the central body of dep.
+ *
+ * It throws std::invalid_argument if the bounds are not ordered, if the
+ * minimum time of flight or tol are not positive, if grid_size is smaller
+ * than 3 or if merge_factor is negative, and the same exceptions as
+ * kep3::porkchop() on the planets.
+ *
+ * \param[in] dep departure planet.
+ * \param[in] arr arrival planet.
+ * \param[in] t_dep_bounds the bounds of the departure epoch (MJD2000).
+ * \param[in] tof_bounds the bounds of the time of flight (days).
+ * \param[in] grid_size the size of the initial grid along each dimension.
+ * \param[in] tol the resolution (days) of the windows.
+ * \param[in] cw when true a retrograde orbit is assumed.
+ * \param[in] multi_revs maximum number of revolutions to consider.
+ * \param[in] merge_factor the distance, in units of tol, within which the
+ * windows are merged.
+ *
+ * \return the windows found and the number of Lambert problems solved.
+ */
+kep3_DLL_PUBLIC window_search_result
+window_search(planet dep, planet arr, const std::array<double, 2> &t_dep_bounds,
+              const std::array<double, 2> &tof_bounds,
+              unsigned grid_size = 32u, double tol = 1e-3, bool cw = false,
+              unsigned multi_revs = 0u, double merge_factor = 2.);
+
+} // namespace kep3
+
+#endif // kep3_WINDOW_SEARCH_H
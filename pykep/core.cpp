@@ -7,15 +7,20 @@
 // Public License v. 2.0. If a copy of the MPL was not distributed
 // with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
 
+#include <algorithm>
 #include <cmath>
+#include <cstddef>
 #include <iostream>
 #include <random>
+#include <span>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
 #include <boost/optional.hpp>
 #include <kep3/core_astro/constants.hpp>
 #include <kep3/core_astro/convert_anomalies.hpp>
+#include <kep3/detail/parallel_for.hpp>
 #include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
@@ -25,6 +30,57 @@
 namespace py = pybind11;
 namespace pk = pykep;
 
+namespace {
+
+// Contiguous float64 numpy arrays (other dtypes and layouts get converted).
+using dbl_array = py::array_t<double, py::array::c_style | py::array::forcecast>;
+
+// Below this number of elements per thread, splitting the work is not worth
+// the cost of spawning threads.
+constexpr std::size_t anomaly_grain = 16384u;
+
+// Wraps a kep3 batch anomaly conversion into a numpy function. Either input can
+// be a scalar (typically the eccentricity), otherwise they must have the same
+// shape. Unlike py::vectorize, no other numpy broadcasting is done. The GIL is
+// released during the computation and large arrays are split across threads.
+template <typename F> auto vectorize_anomaly(F kernel) {
+  return [kernel](const dbl_array &anomaly, const dbl_array &ecc) -> py::object {
+    const bool anomaly_is_scalar = anomaly.ndim() == 0;
+    const auto &shaped = anomaly_is_scalar ? ecc : anomaly;
+    if (!anomaly_is_scalar && ecc.ndim() != 0 &&
+        !std::equal(anomaly.shape(), anomaly.shape() + anomaly.ndim(),
+                    ecc.shape(), ecc.shape() + ecc.ndim())) {
+      throw std::invalid_argument(
+          "The anomalies and the eccentricities must have the same shape, or "
+          "one of the two must be a scalar.");
+    }
+    dbl_array out(std::vector<py::ssize_t>(shaped.shape(),
+                                           shaped.shape() + shaped.ndim()));
+    const auto n = static_cast<std::size_t>(out.size());
+    const std::span<const double> a_s(anomaly.data(),
+                                      static_cast<std::size_t>(anomaly.size()));
+    const std::span<const double> e_s(ecc.data(),
+                                      static_cast<std::size_t>(ecc.size()));
+    const std::span<double> o_s(out.mutable_data(), n);
+    {
+      py::gil_scoped_release release;
+      kep3::detail::parallel_for(
+          n, anomaly_grain, [&](std::size_t begin, std::size_t end) {
+            kernel(a_s.size() == 1u ? a_s : a_s.subspan(begin, end - begin),
+                   e_s.size() == 1u ? e_s : e_s.subspan(begin, end - begin),
+                   o_s.subspan(begin, end - begin));
+          });
+    }
+    // Scalar inputs give back a scalar, as it was the case with py::vectorize.
+    if (anomaly.ndim() == 0 && ecc.ndim() == 0) {
+      return py::float_(*out.data());
+    }
+    return out;
+  };
+}
+
+} // namespace
+
 PYBIND11_MODULE(core, m) {
   py::options options;
   options.disable_function_signatures();
@@ -74,19 +130,19 @@ PYBIND11_MODULE(core, m) {
   m.def("zeta2f", &kep3::zeta2f, pk::zeta2f_doc().c_str());
   m.def("f2zeta", &kep3::f2zeta, pk::f2zeta_doc().c_str());
 
-  // And their vectorized versions
-  m.def("m2e_v", py::vectorize(kep3::m2e), pk::m2e_v_doc().c_str());
-  m.def("e2m_v", py::vectorize(kep3::e2m), pk::e2m_v_doc().c_str());
-  m.def("m2f_v", py::vectorize(kep3::m2f), pk::m2f_v_doc().c_str());
-  m.def("f2m_v", py::vectorize(kep3::f2m), pk::f2m_v_doc().c_str());
-  m.def("e2f_v", py::vectorize(kep3::e2f), pk::e2f_v_doc().c_str());
-  m.def("f2e_v", py::vectorize(kep3::f2e), pk::f2e_v_doc().c_str());
-  m.def("n2h_v", py::vectorize(kep3::n2h), pk::n2h_v_doc().c_str());
-  m.def("h2n_v", py::vectorize(kep3::h2n), pk::h2n_v_doc().c_str());
-  m.def("n2f_v", py::vectorize(kep3::n2f), pk::n2f_v_doc().c_str());
-  m.def("f2n_v", py::vectorize(kep3::f2n), pk::f2n_v_doc().c_str());
-  m.def("h2f_v", py::vectorize(kep3::h2f), pk::h2f_v_doc().c_str());
-  m.def("f2h_v", py::vectorize(kep3::f2h), pk::f2h_v_doc().c_str());
-  m.def("zeta2f_v", py::vectorize(kep3::zeta2f), pk::zeta2f_v_doc().c_str());
-  m.def("f2zeta_v", py::vectorize(kep3::f2zeta), pk::f2zeta_v_doc().c_str());
+  // And their vectorized versions (multithreaded, the GIL is released)
+  m.def("m2e_v", vectorize_anomaly(&kep3::m2e_v), pk::m2e_v_doc().c_str());
+  m.def("e2m_v", vectorize_anomaly(&kep3::e2m_v), pk::e2m_v_doc().c_str());
+  m.def("m2f_v", vectorize_anomaly(&kep3::m2f_v), pk::m2f_v_doc().c_str());
+  m.def("f2m_v", vectorize_anomaly(&kep3::f2m_v), pk::f2m_v_doc().c_str());
+  m.def("e2f_v", vectorize_anomaly(&kep3::e2f_v), pk::e2f_v_doc().c_str());
+  m.def("f2e_v", vectorize_anomaly(&kep3::f2e_v), pk::f2e_v_doc().c_str());
+  m.def("n2h_v", vectorize_anomaly(&kep3::n2h_v), pk::n2h_v_doc().c_str());
+  m.def("h2n_v", vectorize_anomaly(&kep3::h2n_v), pk::h2n_v_doc().c_str());
+  m.def("n2f_v", vectorize_anomaly(&kep3::n2f_v), pk::n2f_v_doc().c_str());
+  m.def("f2n_v", vectorize_anomaly(&kep3::f2n_v), pk::f2n_v_doc().c_str());
+  m.def("h2f_v", vectorize_anomaly(&kep3::h2f_v), pk::h2f_v_doc().c_str());
+  m.def("f2h_v", vectorize_anomaly(&kep3::f2h_v), pk::f2h_v_doc().c_str());
+  m.def("zeta2f_v", vectorize_anomaly(&kep3::zeta2f_v), pk::zeta2f_v_doc().c_str());
+  m.def("f2zeta_v", vectorize_anomaly(&kep3::f2zeta_v), pk::f2zeta_v_doc().c_str());
 }
\ No newline at end of file
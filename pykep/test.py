@@ -49,6 +49,34 @@ class anomaly_conversions_tests(_ut.TestCase):
 
         self.assertTrue(float_abs_error(pk.f2zeta(pk.zeta2f(0.1, 10.1), 10.1), 0.1) < 1e-14)
 
+    def test_vectorized(self):
+        import pykep as pk
+        import numpy as np
+
+        # Large enough to be split across threads.
+        Ms = np.linspace(-10, 10, 100000)
+        eccs = np.linspace(0, 0.99, 100000)
+        Es = pk.m2e_v(Ms, eccs)
+        self.assertEqual(Es.shape, Ms.shape)
+        self.assertTrue(np.max(np.abs(pk.e2m_v(Es, eccs) - Ms)) < 1e-12)
+        # The eccentricity can be a scalar.
+        fs = pk.m2f_v(Ms, 0.3)
+        self.assertTrue(float_abs_error(fs[123], pk.m2f(Ms[123], 0.3)) < 1e-14)
+        # Shapes are preserved and scalars give back scalars.
+        self.assertEqual(pk.n2h_v(Ms.reshape(1000, 100), 3.2).shape, (1000, 100))
+        self.assertTrue(isinstance(pk.m2e_v(0.1, 0.1), float))
+        # Errors are propagated.
+        with self.assertRaises(ValueError):
+            pk.m2e_v(Ms, 1.1)
+        with self.assertRaises(ValueError):
+            pk.m2e_v(Ms, eccs[:10])
+        # Only a scalar is broadcast: same sizes with different shapes, and
+        # one-element arrays, are rejected.
+        with self.assertRaises(ValueError):
+            pk.m2e_v(Ms.reshape(1000, 100), eccs)
+        with self.assertRaises(ValueError):
+            pk.m2e_v(Ms, np.array([0.3]))
+
 
 def run_test_suite():
     suite = _ut.TestSuite()
@@ -59,5 +87,6 @@ def run_test_suite():
     suite.addTest(anomaly_conversions_tests("test_n2f"))
     suite.addTest(anomaly_conversions_tests("test_f2h"))
     suite.addTest(anomaly_conversions_tests("test_f2zeta"))
+    suite.addTest(anomaly_conversions_tests("test_vectorized"))
 
     test_result = _ut.TextTestRunner(verbosity=2).run(suite)
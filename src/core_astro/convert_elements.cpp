@@ -0,0 +1,132 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <utility>
+
+#include <fmt/core.h>
+
+#include <kep3/core_astro/constants.hpp>
+#include <kep3/core_astro/convert_anomalies.hpp>
+#include <kep3/core_astro/convert_elements.hpp>
+#include <kep3/core_astro/elements_batch.hpp>
+#include <kep3/core_astro/eq2par2eq.hpp>
+
+namespace kep3 {
+
+namespace {
+
+constexpr std::size_t n_elements_types = POSVEL + 1u;
+
+void check_elements_type(const char *func, elements_type t) {
+  if (t < KEP_M || t > POSVEL) {
+    throw std::invalid_argument(
+        fmt::format("{}: Invalid element type {}", func, static_cast<int>(t)));
+  }
+}
+
+using convert_t = std::array<double, 6> (*)(const std::array<double, 6> &,
+                                            double);
+
+// The table of the compile time conversions, indexed by n_elements_types *
+// from + to.
+template <std::size_t... I>
+constexpr std::array<convert_t, sizeof...(I)>
+make_convert_table(std::index_sequence<I...>) {
+  return {&convert<static_cast<elements_type>(I / n_elements_types),
+                   static_cast<elements_type>(I % n_elements_types)>...};
+}
+
+constexpr auto convert_table = make_convert_table(
+    std::make_index_sequence<n_elements_types * n_elements_types>{});
+
+// The anomaly conversions of the batches, returning NaN where the scalar
+// ones throw.
+double m2f_or_nan(double M, double ecc) {
+  // NOTE: the negated comparison also catches NaNs.
+  return !(ecc < 1) ? std::numeric_limits<double>::quiet_NaN() : m2f(M, ecc);
+}
+
+double f2m_or_nan(double f, double ecc) {
+  return !(ecc < 1) ? std::numeric_limits<double>::quiet_NaN() : f2m(f, ecc);
+}
+
+} // namespace
+
+std::array<double, 6> convert(const std::array<double, 6> &x,
+                              elements_type from, elements_type to,
+                              double mu) {
+  check_elements_type("convert", from);
+  check_elements_type("convert", to);
+  return convert_table[n_elements_types * from + to](x, mu);
+}
+
+void convert_batch(const elements_batch_input &in, elements_type from,
+                   elements_type to, double mu,
+                   const elements_batch_output &out) {
+  check_elements_type("convert_batch", from);
+  check_elements_type("convert_batch", to);
+  const std::size_t n = in[0].size();
+  for (std::size_t c = 0u; c < 6u; ++c) {
+    if (in[c].size() != n || out[c].size() != n) {
+      throw std::invalid_argument(
+          "convert_batch: inconsistent sizes of the input/output spans.");
+    }
+  }
+
+  if (from == to) {
+    for (std::size_t c = 0u; c < 6u; ++c) {
+      if (in[c].data() != out[c].data()) {
+        std::copy(in[c].begin(), in[c].end(), out[c].begin());
+      }
+    }
+  } else if (from == KEP_M) {
+    // NOTE: the true anomaly is written in the output, which then acts as the
+    // input of the conversion from KEP_F.
+    detail::anomaly_batch(m2f_or_nan, in[5], in[1], out[5]);
+    convert_batch({in[0], in[1], in[2], in[3], in[4], out[5]}, KEP_F, to, mu,
+                  out);
+  } else if (to == KEP_M) {
+    convert_batch(in, from, KEP_F, mu, out);
+    detail::anomaly_batch(f2m_or_nan, out[5], out[1], out[5]);
+  } else if (from == POSVEL) {
+    if (to == KEP_F) {
+      ic2par_batch(in, mu, out);
+    } else {
+      ic2eq_batch(in, mu, out, to == MEQ_R);
+    }
+  } else if (to == POSVEL) {
+    if (from == KEP_F) {
+      par2ic_batch(in, mu, out);
+    } else {
+      eq2ic_batch(in, mu, out, from == MEQ_R);
+    }
+  } else if (from == KEP_F) {
+    par2eq_batch(in, out, to == MEQ_R);
+  } else if (to == KEP_F) {
+    eq2par_batch(in, out, from == MEQ_R);
+  } else {
+    // Between prograde and retrograde equinoctial elements.
+    const auto swap = (from == MEQ) ? &eq2eq_r : &eq_r2eq;
+    for (std::size_t i = 0u; i < n; ++i) {
+      const auto eq = swap(
+          {in[0][i], in[1][i], in[2][i], in[3][i], in[4][i], in[5][i]});
+      for (std::size_t c = 0u; c < 6u; ++c) {
+        out[c][i] = eq[c];
+      }
+    }
+  }
+}
+
+} // namespace kep3
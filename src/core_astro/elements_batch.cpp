@@ -0,0 +1,301 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+
+#include <fmt/core.h>
+
+#include <kep3/core_astro/constants.hpp>
+#include <kep3/core_astro/elements_batch.hpp>
+
+namespace kep3 {
+
+namespace {
+
+// Number of states converted at once. Within a block each step of a
+// conversion is a loop over the lanes: the arithmetic loops are free of
+// branches and can be mapped onto SIMD instructions, while the calls to the
+// trigonometric functions are grouped in loops of their own.
+constexpr std::size_t elements_lanes = 4u;
+
+using lanes = std::array<double, elements_lanes>;
+using block = std::array<lanes, 6>;
+
+// Loads the states of in block by block (the last block being padded by
+// repeating its last state), calls kernel(in_block, out_block) and stores
+// the results in out.
+template <typename Kernel>
+void for_each_block(const char *func, const elements_batch_input &in,
+                    const elements_batch_output &out, const Kernel &kernel) {
+  const std::size_t n = in[0].size();
+  for (std::size_t c = 0u; c < 6u; ++c) {
+    if (in[c].size() != n || out[c].size() != n) {
+      throw std::invalid_argument(fmt::format(
+          "{}: inconsistent sizes of the input/output spans.", func));
+    }
+  }
+  block bin{}, bout{};
+  for (std::size_t i0 = 0u; i0 < n; i0 += elements_lanes) {
+    const std::size_t w = std::min(elements_lanes, n - i0);
+    for (std::size_t c = 0u; c < 6u; ++c) {
+      for (std::size_t k = 0u; k < elements_lanes; ++k) {
+        bin[c][k] = in[c][i0 + std::min(k, w - 1u)];
+      }
+    }
+    kernel(bin, bout);
+    for (std::size_t c = 0u; c < 6u; ++c) {
+      for (std::size_t k = 0u; k < w; ++k) {
+        out[c][i0 + k] = bout[c][k];
+      }
+    }
+  }
+}
+
+} // namespace
+
+void ic2par_batch(const elements_batch_input &pos_vel, double mu,
+                  const elements_batch_output &par) {
+  for_each_block("ic2par_batch", pos_vel, par, [mu](const block &s, block &p) {
+    // Arguments of the arc cosines of i, w, W and f.
+    lanes cos_i{}, cos_w{}, cos_W{}, cos_f{}, ny{}, ez{}, rv{};
+    for (std::size_t k = 0u; k < elements_lanes; ++k) {
+      const double rx = s[0][k], ry = s[1][k], rz = s[2][k];
+      const double vx = s[3][k], vy = s[4][k], vz = s[5][k];
+      // Angular momentum, node line and eccentricity vector.
+      const double hx = ry * vz - rz * vy;
+      const double hy = rz * vx - rx * vz;
+      const double hz = rx * vy - ry * vx;
+      const double h2 = hx * hx + hy * hy + hz * hz;
+      const double nn = std::sqrt(hx * hx + hy * hy);
+      const double nx = -hy / nn;
+      ny[k] = hx / nn;
+      const double R = std::sqrt(rx * rx + ry * ry + rz * rz);
+      const double ex = (vy * hz - vz * hy) / mu - rx / R;
+      const double ey = (vz * hx - vx * hz) / mu - ry / R;
+      ez[k] = (vx * hy - vy * hx) / mu - rz / R;
+      const double ecc = std::sqrt(ex * ex + ey * ey + ez[k] * ez[k]);
+      p[1][k] = ecc;
+      p[0][k] = h2 / mu / (1 - ecc * ecc);
+      cos_i[k] = hz / std::sqrt(h2);
+      cos_w[k] = (nx * ex + ny[k] * ey) / ecc;
+      cos_W[k] = nx;
+      cos_f[k] = (ex * rx + ey * ry + ez[k] * rz) / ecc / R;
+      rv[k] = rx * vx + ry * vy + rz * vz;
+    }
+    for (std::size_t k = 0u; k < elements_lanes; ++k) {
+      p[2][k] = std::acos(cos_i[k]);
+      p[3][k] = std::acos(cos_W[k]);
+      p[4][k] = std::acos(cos_w[k]);
+      p[5][k] = std::acos(cos_f[k]);
+    }
+    for (std::size_t k = 0u; k < elements_lanes; ++k) {
+      p[3][k] = (ny[k] < 0) ? 2 * pi - p[3][k] : p[3][k];
+      p[4][k] = (ez[k] < 0) ? 2 * pi - p[4][k] : p[4][k];
+      p[5][k] = (rv[k] < 0.0) ? 2 * pi - p[5][k] : p[5][k];
+    }
+  });
+}
+
+void par2ic_batch(const elements_batch_input &par, double mu,
+                  const elements_batch_output &pos_vel) {
+  for_each_block("par2ic_batch", par, pos_vel, [mu](const block &p, block &s) {
+    lanes cosf{}, sinf{}, cosomg{}, sinomg{}, cosomp{}, sinomp{}, cosi{},
+        sini{};
+    for (std::size_t k = 0u; k < elements_lanes; ++k) {
+      cosf[k] = std::cos(p[5][k]);
+      sinf[k] = std::sin(p[5][k]);
+      cosomg[k] = std::cos(p[3][k]);
+      sinomg[k] = std::sin(p[3][k]);
+      cosomp[k] = std::cos(p[4][k]);
+      sinomp[k] = std::sin(p[4][k]);
+      cosi[k] = std::cos(p[2][k]);
+      sini[k] = std::sin(p[2][k]);
+    }
+    for (std::size_t k = 0u; k < elements_lanes; ++k) {
+      const double sma = p[0][k], ecc = p[1][k];
+      // The cases in which par2ic() throws.
+      const bool invalid =
+          sma * (1 - ecc) < 0 || (ecc > 1 && cosf[k] < -1 / ecc);
+      // Position and velocity in the perifocal reference frame.
+      const double pp = sma * (1.0 - ecc * ecc);
+      const double r = pp / (1.0 + ecc * cosf[k]);
+      const double h = std::sqrt(pp * mu);
+      const double x_per = r * cosf[k];
+      const double y_per = r * sinf[k];
+      const double xdot_per = -mu / h * sinf[k];
+      const double ydot_per = mu / h * (ecc + cosf[k]);
+      // Rotation to the inertial frame.
+      const double R00 =
+          cosomg[k] * cosomp[k] - sinomg[k] * sinomp[k] * cosi[k];
+      const double R01 =
+          -cosomg[k] * sinomp[k] - sinomg[k] * cosomp[k] * cosi[k];
+      const double R10 =
+          sinomg[k] * cosomp[k] + cosomg[k] * sinomp[k] * cosi[k];
+      const double R11 =
+          -sinomg[k] * sinomp[k] + cosomg[k] * cosomp[k] * cosi[k];
+      const double R20 = sinomp[k] * sini[k];
+      const double R21 = cosomp[k] * sini[k];
+      constexpr double nan = std::numeric_limits<double>::quiet_NaN();
+      s[0][k] = invalid ? nan : R00 * x_per + R01 * y_per;
+      s[1][k] = invalid ? nan : R10 * x_per + R11 * y_per;
+      s[2][k] = invalid ? nan : R20 * x_per + R21 * y_per;
+      s[3][k] = invalid ? nan : R00 * xdot_per + R01 * ydot_per;
+      s[4][k] = invalid ? nan : R10 * xdot_per + R11 * ydot_per;
+      s[5][k] = invalid ? nan : R20 * xdot_per + R21 * ydot_per;
+    }
+  });
+}
+
+void ic2eq_batch(const elements_batch_input &pos_vel, double mu,
+                 const elements_batch_output &eq, bool retrogade) {
+  const double I = retrogade ? -1. : 1.;
+  for_each_block("ic2eq_batch", pos_vel, eq, [mu, I](const block &s,
+                                                     block &e) {
+    // Coordinates of the position in the equinoctial frame.
+    lanes X{}, Y{};
+    for (std::size_t k = 0u; k < elements_lanes; ++k) {
+      const double rx = s[0][k], ry = s[1][k], rz = s[2][k];
+      const double vx = s[3][k], vy = s[4][k], vz = s[5][k];
+      const double hx = ry * vz - rz * vy;
+      const double hy = rz * vx - rx * vz;
+      const double hz = rx * vy - ry * vx;
+      const double R = std::sqrt(rx * rx + ry * ry + rz * rz);
+      const double V2 = vx * vx + vy * vy + vz * vz;
+      const double sma = 1. / (2. / R - V2 / mu);
+      // The equinoctial reference frame.
+      const double hn = std::sqrt(hx * hx + hy * hy + hz * hz);
+      const double wx = hx / hn, wy = hy / hn, wz = hz / hn;
+      const double kk = wx / (1. + I * wz);
+      const double hh = -wy / (1. + I * wz);
+      const double den = kk * kk + hh * hh + 1;
+      const double fx = (1. - kk * kk + hh * hh) / den;
+      const double fy = (2. * kk * hh) / den;
+      const double fz = (-2. * I * kk) / den;
+      const double gx = (2. * I * kk * hh) / den;
+      const double gy = (1. + kk * kk - hh * hh) * I / den;
+      const double gz = (2. * hh) / den;
+      // The eccentricity vector.
+      const double ex = (vy * hz - vz * hy) / mu - rx / R;
+      const double ey = (vz * hx - vx * hz) / mu - ry / R;
+      const double ez = (vx * hy - vy * hx) / mu - rz / R;
+      const double ecc2 = ex * ex + ey * ey + ez * ez;
+      e[0][k] = sma * (1. - ecc2);
+      e[1][k] = ex * fx + ey * fy + ez * fz;
+      e[2][k] = ex * gx + ey * gy + ez * gz;
+      e[3][k] = hh;
+      e[4][k] = kk;
+      // NOTE: f and g are orthonormal and r lies in their plane, so its
+      // coordinates are plain projections.
+      X[k] = (rx * fx + ry * fy + rz * fz) / R;
+      Y[k] = (rx * gx + ry * gy + rz * gz) / R;
+    }
+    for (std::size_t k = 0u; k < elements_lanes; ++k) {
+      e[5][k] = std::atan2(Y[k], X[k]);
+    }
+  });
+}
+
+void eq2ic_batch(const elements_batch_input &eq, double mu,
+                 const elements_batch_output &pos_vel, bool retrogade) {
+  const double I = retrogade ? -1. : 1.;
+  for_each_block("eq2ic_batch", eq, pos_vel, [mu, I](const block &e,
+                                                     block &s) {
+    lanes sinL{}, cosL{};
+    for (std::size_t k = 0u; k < elements_lanes; ++k) {
+      sinL[k] = std::sin(e[5][k]);
+      cosL[k] = std::cos(e[5][k]);
+    }
+    for (std::size_t k = 0u; k < elements_lanes; ++k) {
+      // p = a (1-e^2) is negative for hyperbolae.
+      const double par = std::abs(e[0][k]);
+      const double f = e[1][k], g = e[2][k], h = e[3][k], kk = e[4][k];
+      // The equinoctial reference frame.
+      const double den = kk * kk + h * h + 1;
+      const double fx = (1 - kk * kk + h * h) / den;
+      const double fy = (2 * kk * h) / den;
+      const double fz = (-2 * I * kk) / den;
+      const double gx = (2 * I * kk * h) / den;
+      const double gy = (1 + kk * kk - h * h) * I / den;
+      const double gz = (2 * h) / den;
+      // Position and velocity in the equinoctial reference frame.
+      const double radius = par / (1 + g * sinL[k] + f * cosL[k]);
+      const double X = radius * cosL[k];
+      const double Y = radius * sinL[k];
+      const double VX = -std::sqrt(mu / par) * (g + sinL[k]);
+      const double VY = std::sqrt(mu / par) * (f + cosL[k]);
+      s[0][k] = X * fx + Y * gx;
+      s[1][k] = X * fy + Y * gy;
+      s[2][k] = X * fz + Y * gz;
+      s[3][k] = VX * fx + VY * gx;
+      s[4][k] = VX * fy + VY * gy;
+      s[5][k] = VX * fz + VY * gz;
+    }
+  });
+}
+
+void par2eq_batch(const elements_batch_input &par,
+                  const elements_batch_output &eq, bool retrogade) {
+  const double I = retrogade ? -1. : 1.;
+  for_each_block("par2eq_batch", par, eq, [I, retrogade](const block &p,
+                                                         block &e) {
+    lanes tani2{}, cosW{}, sinW{}, cosz{}, sinz{};
+    for (std::size_t k = 0u; k < elements_lanes; ++k) {
+      tani2[k] = std::tan(p[2][k] / 2);
+      cosW[k] = std::cos(p[3][k]);
+      sinW[k] = std::sin(p[3][k]);
+      cosz[k] = std::cos(p[4][k] + I * p[3][k]);
+      sinz[k] = std::sin(p[4][k] + I * p[3][k]);
+    }
+    for (std::size_t k = 0u; k < elements_lanes; ++k) {
+      const double t = retrogade ? 1. / tani2[k] : tani2[k];
+      e[0][k] = p[0][k] * (1 - p[1][k] * p[1][k]);
+      e[1][k] = p[1][k] * cosz[k];
+      e[2][k] = p[1][k] * sinz[k];
+      e[3][k] = t * cosW[k];
+      e[4][k] = t * sinW[k];
+      e[5][k] = p[5][k] + p[4][k] + I * p[3][k];
+    }
+  });
+}
+
+void eq2par_batch(const elements_batch_input &eq,
+                  const elements_batch_output &par, bool retrogade) {
+  const double I = retrogade ? -1. : 1.;
+  for_each_block("eq2par_batch", eq, par, [I](const block &e, block &p) {
+    lanes ecc{}, tmp{}, zita{}, atan_tmp{};
+    for (std::size_t k = 0u; k < elements_lanes; ++k) {
+      ecc[k] = std::sqrt(e[1][k] * e[1][k] + e[2][k] * e[2][k]);
+      tmp[k] = std::sqrt(e[3][k] * e[3][k] + e[4][k] * e[4][k]);
+    }
+    for (std::size_t k = 0u; k < elements_lanes; ++k) {
+      zita[k] = std::atan2(e[2][k] / ecc[k], e[1][k] / ecc[k]);
+      atan_tmp[k] = std::atan(tmp[k]);
+      p[3][k] = std::atan2(e[4][k] / tmp[k], e[3][k] / tmp[k]);
+    }
+    for (std::size_t k = 0u; k < elements_lanes; ++k) {
+      // From [-pi, pi] to [0, 2pi].
+      zita[k] = (zita[k] < 0) ? zita[k] + 2 * pi : zita[k];
+      p[3][k] = (p[3][k] < 0) ? p[3][k] + 2 * pi : p[3][k];
+      p[0][k] = e[0][k] / (1. - ecc[k] * ecc[k]);
+      p[1][k] = ecc[k];
+      p[2][k] = half_pi * (1. - I) + 2. * I * atan_tmp[k];
+      double w = zita[k] - I * p[3][k];
+      w = (w < 0) ? w + 2 * pi : ((w > 2 * pi) ? w - 2 * pi : w);
+      p[4][k] = w;
+      p[5][k] = e[5][k] - I * p[3][k] - w;
+    }
+  });
+}
+
+} // namespace kep3
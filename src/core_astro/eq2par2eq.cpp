@@ -12,26 +12,36 @@
 
 #include <kep3/core_astro/constants.hpp>
 #include <kep3/core_astro/eq2par2eq.hpp>
+#include <kep3/detail/dual.hpp>
 
 namespace kep3 {
 
-std::array<double, 6> eq2par(const std::array<double, 6> &eq, bool retrogade) {
-  std::array<double, 6> retval{};
+namespace {
+
+// NOTE: the conversions are templated on the scalar type so that their
+// Jacobians can be computed by evaluating them on dual numbers.
+
+template <typename F>
+std::array<F, 6> eq2par_impl(const std::array<F, 6> &eq, bool retrogade) {
+  using std::atan;
+  using std::atan2;
+  using std::sqrt;
+  std::array<F, 6> retval{};
   int I = 1;
   if (retrogade) {
     I = -1;
   }
-  double ecc = std::sqrt(eq[1] * eq[1] + eq[2] * eq[2]);
-  double tmp = std::sqrt(eq[3] * eq[3] + eq[4] * eq[4]);
-  double zita = std::atan2(eq[2] / ecc, eq[1] / ecc); // [-pi, pi]
+  F ecc = sqrt(eq[1] * eq[1] + eq[2] * eq[2]);
+  F tmp = sqrt(eq[3] * eq[3] + eq[4] * eq[4]);
+  F zita = atan2(eq[2] / ecc, eq[1] / ecc); // [-pi, pi]
   if (zita < 0) {
     zita += 2 * pi; // [0, 2*pi]
   }
 
   retval[1] = ecc;
   retval[0] = eq[0] / (1. - ecc * ecc);
-  retval[2] = half_pi * (1. - I) + 2. * I * std::atan(tmp);
-  retval[3] = std::atan2(eq[4] / tmp, eq[3] / tmp); // [-pi, pi]
+  retval[2] = half_pi * (1. - I) + 2. * I * atan(tmp);
+  retval[3] = atan2(eq[4] / tmp, eq[3] / tmp); // [-pi, pi]
   if (retval[3] < 0) {
     retval[3] += 2 * pi; // [0, 2*pi]
   }
@@ -45,22 +55,74 @@ std::array<double, 6> eq2par(const std::array<double, 6> &eq, bool retrogade) {
   return retval;
 }
 
-std::array<double, 6> par2eq(const std::array<double, 6> &par, bool retrogade) {
-  std::array<double, 6> eq{};
+template <typename F>
+std::array<F, 6> par2eq_impl(const std::array<F, 6> &par, bool retrogade) {
+  using std::cos;
+  using std::sin;
+  using std::tan;
+  std::array<F, 6> eq{};
   int I = 0;
   if (retrogade) {
     I = -1;
-    eq[3] = 1. / std::tan(par[2] / 2) * std::cos(par[3]);
-    eq[4] = 1. / std::tan(par[2] / 2) * std::sin(par[3]);
+    eq[3] = 1. / tan(par[2] / 2) * cos(par[3]);
+    eq[4] = 1. / tan(par[2] / 2) * sin(par[3]);
   } else {
     I = 1;
-    eq[3] = std::tan(par[2] / 2) * std::cos(par[3]);
-    eq[4] = std::tan(par[2] / 2) * std::sin(par[3]);
+    eq[3] = tan(par[2] / 2) * cos(par[3]);
+    eq[4] = tan(par[2] / 2) * sin(par[3]);
   }
   eq[0] = par[0] * (1 - par[1] * par[1]);
-  eq[1] = par[1] * std::cos(par[4] + I * par[3]);
-  eq[2] = par[1] * std::sin(par[4] + I * par[3]);
+  eq[1] = par[1] * cos(par[4] + I * par[3]);
+  eq[2] = par[1] * sin(par[4] + I * par[3]);
   eq[5] = par[5] + par[4] + I * par[3];
   return eq;
 }
-} // namespace kep3
\ No newline at end of file
+
+// The prograde and retrograde forms share p and the eccentricity, while with
+// W the longitude of the ascending node (h, k) is divided by h^2 + k^2, (f, g)
+// is rotated by -2W and 2W is subtracted from L. This applies the change with
+// a = -2W (sign = -1) or its inverse with a = 2W (sign = 1).
+std::array<double, 6> eq_swap(const std::array<double, 6> &eq, double sign) {
+  const double s2 = eq[3] * eq[3] + eq[4] * eq[4];
+  const double a = sign * 2. * std::atan2(eq[4], eq[3]);
+  const double cos_a = std::cos(a);
+  const double sin_a = std::sin(a);
+  return {eq[0],
+          eq[1] * cos_a - eq[2] * sin_a,
+          eq[1] * sin_a + eq[2] * cos_a,
+          eq[3] / s2,
+          eq[4] / s2,
+          eq[5] + a};
+}
+
+} // namespace
+
+std::array<double, 6> eq2eq_r(const std::array<double, 6> &eq) {
+  return eq_swap(eq, -1.);
+}
+
+std::array<double, 6> eq_r2eq(const std::array<double, 6> &eq_r) {
+  return eq_swap(eq_r, 1.);
+}
+
+std::array<double, 6> eq2par(const std::array<double, 6> &eq, bool retrogade) {
+  return eq2par_impl(eq, retrogade);
+}
+
+std::array<double, 6> par2eq(const std::array<double, 6> &par, bool retrogade) {
+  return par2eq_impl(par, retrogade);
+}
+
+std::pair<std::array<double, 6>, std::array<std::array<double, 6>, 6>>
+eq2par_jac(const std::array<double, 6> &eq, bool retrogade) {
+  return detail::dual_jacobian(
+      eq2par_impl(detail::dual_variables(eq), retrogade));
+}
+
+std::pair<std::array<double, 6>, std::array<std::array<double, 6>, 6>>
+par2eq_jac(const std::array<double, 6> &par, bool retrogade) {
+  return detail::dual_jacobian(
+      par2eq_impl(detail::dual_variables(par), retrogade));
+}
+
+} // namespace kep3
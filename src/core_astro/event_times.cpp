@@ -0,0 +1,291 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <stdexcept>
+
+#include <fmt/core.h>
+
+#include <kep3/core_astro/constants.hpp>
+#include <kep3/core_astro/convert_anomalies.hpp>
+#include <kep3/core_astro/elements_batch.hpp>
+#include <kep3/core_astro/event_times.hpp>
+#include <kep3/core_astro/ic2par2ic.hpp>
+
+namespace kep3 {
+
+namespace {
+
+constexpr double nan = std::numeric_limits<double>::quiet_NaN();
+
+// A cartesian state (x, y, z, vx, vy, vz) or its osculating elements.
+using state6 = std::array<double, 6>;
+
+// Angular momentum of the state s.
+std::array<double, 3> angular_momentum(const state6 &s) {
+  return {s[1] * s[5] - s[2] * s[4], s[2] * s[3] - s[0] * s[5],
+          s[0] * s[4] - s[1] * s[3]};
+}
+
+// True anomaly of the state s. NOTE: ic2par() computes it with an acos(),
+// which loses about half of the digits close to the apsides, so that here we
+// use e cos(f) = p / r - 1 and e sin(f) = sqrt(p / mu) r.v / r instead.
+double true_anomaly(const state6 &s, double mu) {
+  const auto h = angular_momentum(s);
+  const double p = (h[0] * h[0] + h[1] * h[1] + h[2] * h[2]) / mu;
+  const double r = std::sqrt(s[0] * s[0] + s[1] * s[1] + s[2] * s[2]);
+  const double rv = s[0] * s[3] + s[1] * s[4] + s[2] * s[5];
+  return std::atan2(std::sqrt(p / mu) * rv / r, p / r - 1.);
+}
+
+// Argument of latitude of the state s, i.e. the angle from the ascending node
+// to the position, or NaN if the orbit lies in the reference plane. NOTE:
+// with n = k x h the node vector, cos(u) = r.n / (r |n|) and, as
+// z = r sin(i) sin(u) with sin(i) = |n| / |h|, sin(u) = z |h| / (r |n|).
+double argument_of_latitude(const state6 &s) {
+  const auto h = angular_momentum(s);
+  if (h[0] == 0. && h[1] == 0.) {
+    return nan;
+  }
+  return std::atan2(s[2] * std::sqrt(h[0] * h[0] + h[1] * h[1] + h[2] * h[2]),
+                    h[0] * s[1] - h[1] * s[0]);
+}
+
+// The events, as functions of the state s, of its true anomaly f, of its
+// osculating elements par (of which only sma and ecc are used) and of the
+// target value (true anomaly or radius) where there is one.
+double true_anomaly_event(const state6 &, double f, const state6 &par,
+                          double target, double mu) {
+  return time_of_flight(f, target, par[0], par[1], mu);
+}
+
+double periapsis_event(const state6 &, double f, const state6 &par, double,
+                       double mu) {
+  return time_of_flight(f, 0., par[0], par[1], mu);
+}
+
+double apoapsis_event(const state6 &, double f, const state6 &par, double,
+                      double mu) {
+  return time_of_flight(f, pi, par[0], par[1], mu);
+}
+
+// The ascending node is at u = 0, that is at f - u.
+double ascending_node_event(const state6 &s, double f, const state6 &par,
+                            double, double mu) {
+  return time_of_flight(f, f - argument_of_latitude(s), par[0], par[1], mu);
+}
+
+double descending_node_event(const state6 &s, double f, const state6 &par,
+                             double, double mu) {
+  return time_of_flight(f, f - argument_of_latitude(s) + pi, par[0], par[1],
+                        mu);
+}
+
+// The radius R is crossed at the true anomalies +-acos((p / R - 1) / ecc):
+// the first of the two crossings is returned. NOTE: std::fmin() ignores the
+// NaN of a crossing that never happens (on hyperbolas).
+double radius_event(const state6 &, double f, const state6 &par, double R,
+                    double mu) {
+  const double sma = par[0], ecc = par[1];
+  const double cosfR = (sma * (1. - ecc * ecc) / R - 1.) / ecc;
+  // NOTE: the negated comparison also catches NaNs.
+  if (!(std::abs(cosfR) <= 1.)) {
+    return nan;
+  }
+  const double fR = std::acos(cosfR);
+  return std::fmin(time_of_flight(f, fR, sma, ecc, mu),
+                   time_of_flight(f, -fR, sma, ecc, mu));
+}
+
+// Whether an input of a batch function has either size n or size one.
+bool consistent_size(std::span<const double> x, std::size_t n) {
+  return x.size() == n || x.size() == 1u;
+}
+
+// Number of states whose elements are computed at once by for_each_state(),
+// so that they stay in cache.
+constexpr std::size_t chunk_size = 256u;
+
+// Writes in out, for each state of pos_vel, event(s, f, par, target, mu)
+// with par the osculating elements of s computed by ic2par_batch().
+template <typename Event>
+void for_each_state(const char *func, const elements_batch_input &pos_vel,
+                    std::span<const double> target, double mu,
+                    std::span<double> out, const Event &event) {
+  const std::size_t n = out.size();
+  for (std::size_t c = 0u; c < 6u; ++c) {
+    if (pos_vel[c].size() != n) {
+      throw std::invalid_argument(fmt::format(
+          "{}: inconsistent sizes of the input/output spans.", func));
+    }
+  }
+  if (!consistent_size(target, n)) {
+    throw std::invalid_argument(
+        fmt::format("{}: the targets must have either the same size as the "
+                    "output or size one.",
+                    func));
+  }
+  const std::size_t st = (target.size() == 1u) ? 0u : 1u;
+  std::array<std::array<double, chunk_size>, 6> par_buf{};
+  for (std::size_t i0 = 0u; i0 < n; i0 += chunk_size) {
+    const std::size_t w = std::min(chunk_size, n - i0);
+    elements_batch_input chunk;
+    elements_batch_output par;
+    for (std::size_t c = 0u; c < 6u; ++c) {
+      chunk[c] = pos_vel[c].subspan(i0, w);
+      par[c] = std::span<double>(par_buf[c].data(), w);
+    }
+    ic2par_batch(chunk, mu, par);
+    for (std::size_t k = 0u; k < w; ++k) {
+      const state6 s = {chunk[0][k], chunk[1][k], chunk[2][k],
+                        chunk[3][k], chunk[4][k], chunk[5][k]};
+      const state6 p = {par[0][k], par[1][k], par[2][k],
+                        par[3][k], par[4][k], par[5][k]};
+      out[i0 + k] =
+          event(s, true_anomaly(s, mu), p, target[(i0 + k) * st], mu);
+    }
+  }
+}
+
+// The scalar version of for_each_state().
+template <typename Event>
+double single_state(const std::array<std::array<double, 3>, 2> &pos_vel,
+                    double target, double mu, const Event &event) {
+  const state6 s = {pos_vel[0][0], pos_vel[0][1], pos_vel[0][2],
+                    pos_vel[1][0], pos_vel[1][1], pos_vel[1][2]};
+  return event(s, true_anomaly(s, mu), ic2par(pos_vel, mu), target, mu);
+}
+
+// Dummy target of the events without one.
+constexpr std::array<double, 1> no_target = {0.};
+
+} // namespace
+
+// NOTE: the anomalies are converted to the mean ones, in which the time is
+// linear. On ellipses f2m() returns the mean anomaly in [-pi, pi], as the
+// conversions through the eccentric anomaly are 2pi periodic in f, and the
+// difference is reduced to a single revolution forward. On hyperbolas f2n()
+// is NaN (or infinite) outside the asymptotes.
+double time_of_flight(double f0, double f1, double sma, double ecc,
+                      double mu) {
+  if (ecc >= 0. && ecc < 1. && sma > 0.) {
+    double DM = std::fmod(f2m(f1, ecc) - f2m(f0, ecc), 2 * pi);
+    if (DM < 0.) {
+      DM += 2 * pi;
+    }
+    return DM * std::sqrt(sma * sma * sma / mu);
+  }
+  if (ecc > 1. && sma < 0.) {
+    const double DN = f2n(f1, ecc) - f2n(f0, ecc);
+    // NOTE: the negated comparison also catches NaNs.
+    if (!(DN >= 0.) || std::isinf(DN)) {
+      return nan;
+    }
+    return DN * std::sqrt(-sma * sma * sma / mu);
+  }
+  return nan;
+}
+
+double time_to_true_anomaly(const std::array<std::array<double, 3>, 2> &pos_vel,
+                            double f, double mu) {
+  return single_state(pos_vel, f, mu, true_anomaly_event);
+}
+
+double time_to_periapsis(const std::array<std::array<double, 3>, 2> &pos_vel,
+                         double mu) {
+  return single_state(pos_vel, 0., mu, periapsis_event);
+}
+
+double time_to_apoapsis(const std::array<std::array<double, 3>, 2> &pos_vel,
+                        double mu) {
+  return single_state(pos_vel, 0., mu, apoapsis_event);
+}
+
+double
+time_to_ascending_node(const std::array<std::array<double, 3>, 2> &pos_vel,
+                       double mu) {
+  return single_state(pos_vel, 0., mu, ascending_node_event);
+}
+
+double
+time_to_descending_node(const std::array<std::array<double, 3>, 2> &pos_vel,
+                        double mu) {
+  return single_state(pos_vel, 0., mu, descending_node_event);
+}
+
+double time_to_radius(const std::array<std::array<double, 3>, 2> &pos_vel,
+                      double R, double mu) {
+  return single_state(pos_vel, R, mu, radius_event);
+}
+
+void time_of_flight_batch(std::span<const double> f0,
+                          std::span<const double> f1,
+                          std::span<const double> sma,
+                          std::span<const double> ecc, double mu,
+                          std::span<double> out) {
+  const std::size_t n = out.size();
+  if (!consistent_size(f0, n) || !consistent_size(f1, n) ||
+      !consistent_size(sma, n) || !consistent_size(ecc, n)) {
+    throw std::invalid_argument(
+        "time_of_flight_batch: the inputs must have either the same size as "
+        "the output or size one.");
+  }
+  const std::size_t s0 = (f0.size() == 1u) ? 0u : 1u;
+  const std::size_t s1 = (f1.size() == 1u) ? 0u : 1u;
+  const std::size_t sa = (sma.size() == 1u) ? 0u : 1u;
+  const std::size_t se = (ecc.size() == 1u) ? 0u : 1u;
+  for (std::size_t i = 0u; i < n; ++i) {
+    out[i] = time_of_flight(f0[i * s0], f1[i * s1], sma[i * sa], ecc[i * se],
+                            mu);
+  }
+}
+
+void time_to_true_anomaly_batch(const elements_batch_input &pos_vel,
+                                std::span<const double> f, double mu,
+                                std::span<double> out) {
+  for_each_state("time_to_true_anomaly_batch", pos_vel, f, mu, out,
+                 true_anomaly_event);
+}
+
+void time_to_periapsis_batch(const elements_batch_input &pos_vel, double mu,
+                             std::span<double> out) {
+  for_each_state("time_to_periapsis_batch", pos_vel, no_target, mu, out,
+                 periapsis_event);
+}
+
+void time_to_apoapsis_batch(const elements_batch_input &pos_vel, double mu,
+                            std::span<double> out) {
+  for_each_state("time_to_apoapsis_batch", pos_vel, no_target, mu, out,
+                 apoapsis_event);
+}
+
+void time_to_ascending_node_batch(const elements_batch_input &pos_vel,
+                                  double mu, std::span<double> out) {
+  for_each_state("time_to_ascending_node_batch", pos_vel, no_target, mu, out,
+                 ascending_node_event);
+}
+
+void time_to_descending_node_batch(const elements_batch_input &pos_vel,
+                                   double mu, std::span<double> out) {
+  for_each_state("time_to_descending_node_batch", pos_vel, no_target, mu, out,
+                 descending_node_event);
+}
+
+void time_to_radius_batch(const elements_batch_input &pos_vel,
+                          std::span<const double> R, double mu,
+                          std::span<double> out) {
+  for_each_state("time_to_radius_batch", pos_vel, R, mu, out, radius_event);
+}
+
+} // namespace kep3
@@ -7,30 +7,42 @@
 // Public License v. 2.0. If a copy of the MPL was not distributed
 // with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
 
+#include <algorithm>
 #include <array>
 #include <cmath>
 
 #include <fmt/core.h>
 #include <fmt/ranges.h>
 
-#include <xtensor-blas/xlinalg.hpp>
-#include <xtensor/xadapt.hpp>
-
 #include <kep3/core_astro/constants.hpp>
 #include <kep3/core_astro/ic2eq2ic.hpp>
-
-using xt::linalg::cross;
-using xt::linalg::dot;
+#include <kep3/detail/dual.hpp>
+#include <kep3/detail/vec3.hpp>
 
 namespace kep3 {
 
+using detail::vec3_cross;
+using detail::vec3_div;
+using detail::vec3_dot;
+using detail::vec3_norm;
+using detail::vec3_sub;
+using detail::vec3_t;
+
+namespace {
+
+// NOTE: the conversions are templated on the scalar type so that their
+// Jacobians can be computed by evaluating them on dual numbers.
+
 // Implementation following:
 // Cefola: Equinoctial orbit elements - Application to artificial satellite
 // orbitsCefola, P., 1972, September. Equinoctial orbit elements-Application to
 // artificial satellite orbits. In Astrodynamics Conference (p. 937).
 
-std::array<double, 6> ic2eq(const std::array<std::array<double, 3>, 2> &pos_vel,
-                            double mu, bool retrogade) {
+template <typename F>
+std::array<F, 6> ic2eq_impl(const std::array<vec3_t<F>, 2> &pos_vel, double mu,
+                            bool retrogade) {
+  using std::abs;
+  using std::atan2;
   {
     // Switch between the element types.
     int I = 0;
@@ -39,74 +51,80 @@ std::array<double, 6> ic2eq(const std::array<std::array<double, 3>, 2> &pos_vel,
     } else {
       I = 1;
     }
-    // 0 - We prepare a few xtensor constants.
-    auto r0 = xt::adapt(pos_vel[0]);
-    auto v0 = xt::adapt(pos_vel[1]);
+    // 0 - We prepare a few constants.
+    const auto &r0 = pos_vel[0];
+    const auto &v0 = pos_vel[1];
     // The equinoctial reference frame
-    xt::xtensor_fixed<double, xt::xshape<3>> fv = {0.0, 0.0, 0.0};
-    xt::xtensor_fixed<double, xt::xshape<3>> gv = {0.0, 0.0, 0.0};
+    vec3_t<F> fv = {0.0, 0.0, 0.0};
+    vec3_t<F> gv = {0.0, 0.0, 0.0};
 
     // angular momentum
-    auto ang = cross(r0, v0);
+    const auto ang = vec3_cross(r0, v0);
 
     // 0 - We compute the semi-major axis
-    double R0 = xt::linalg::norm(r0);
-    double V0 = xt::linalg::norm(v0);
-    double sma = 1. / (2. / R0 - V0 * V0 / mu);
+    F R0 = vec3_norm(r0);
+    F V0 = vec3_norm(v0);
+    F sma = 1. / (2. / R0 - V0 * V0 / mu);
 
     // 1 - We compute the equinoctial frame
-    auto w = cross(r0, v0);
-    w = w / xt::linalg::norm(w);
+    const auto w = vec3_div(ang, vec3_norm(ang));
 
-    double k = w(0) / (1. + I * w(2));
-    double h = -w(1) / (1. + I * w(2));
-    double den = k * k + h * h + 1;
-    fv(0) = (1. - k * k + h * h) / den;
-    fv(1) = (2. * k * h) / den;
-    fv(2) = (-2. * I * k) / den;
+    F k = w[0] / (1. + I * w[2]);
+    F h = -w[1] / (1. + I * w[2]);
+    F den = k * k + h * h + 1;
+    fv[0] = (1. - k * k + h * h) / den;
+    fv[1] = (2. * k * h) / den;
+    fv[2] = (-2. * I * k) / den;
 
-    gv(0) = (2. * I * k * h) / den;
-    gv(1) = (1. + k * k - h * h) * I / den;
-    gv(2) = (2. * h) / den;
+    gv[0] = (2. * I * k * h) / den;
+    gv[1] = (1. + k * k - h * h) * I / den;
+    gv[2] = (2. * h) / den;
 
     // 2 - We compute evett: the eccentricity vector
-    auto evett = cross(v0, ang) / mu - r0 / R0; // e = (v x h)/mu - r0/R0;
+    // e = (v x h)/mu - r0/R0;
+    const auto evett =
+        vec3_sub(vec3_div(vec3_cross(v0, ang), mu), vec3_div(r0, R0));
 
-    double g = dot(evett, gv)(0);
-    double f = dot(evett, fv)(0);
-    double ecc = xt::linalg::norm(evett);
+    F g = vec3_dot(evett, gv);
+    F f = vec3_dot(evett, fv);
+    F ecc = vec3_norm(evett);
 
     // 3 - We compute the true longitude L
     // This solution is certainly not the most elegant, but it works and will
     // never be singular.
 
-    double det1 = (gv(1) * fv(0) - fv(1) * gv(0)); // xy
-    double det2 = (gv(2) * fv(0) - fv(2) * gv(0)); // xz
-    double det3 = (gv(2) * fv(1) - fv(2) * gv(1)); // yz
-    double max = std::max({std::abs(det1), std::abs(det2), std::abs(det3)});
-
-    double X = 0., Y = 0.;
-    if (std::abs(det1) == max) {
-      X = (gv(1) * r0(0) - gv(0) * r0(1)) / det1;
-      Y = (-fv(1) * r0(0) + fv(0) * r0(1)) / det1;
-    } else if (std::abs(det2) == max) {
-      X = (gv(2) * r0(0) - gv(0) * r0(2)) / det2;
-      Y = (-fv(2) * r0(0) + fv(0) * r0(2)) / det2;
+    F det1 = (gv[1] * fv[0] - fv[1] * gv[0]); // xy
+    F det2 = (gv[2] * fv[0] - fv[2] * gv[0]); // xz
+    F det3 = (gv[2] * fv[1] - fv[2] * gv[1]); // yz
+    F max = std::max({abs(det1), abs(det2), abs(det3)});
+
+    F X = 0., Y = 0.;
+    if (abs(det1) == max) {
+      X = (gv[1] * r0[0] - gv[0] * r0[1]) / det1;
+      Y = (-fv[1] * r0[0] + fv[0] * r0[1]) / det1;
+    } else if (abs(det2) == max) {
+      X = (gv[2] * r0[0] - gv[0] * r0[2]) / det2;
+      Y = (-fv[2] * r0[0] + fv[0] * r0[2]) / det2;
     } else {
-      X = (gv(2) * r0(1) - gv(1) * r0(2)) / det3;
-      Y = (-fv(2) * r0(1) + fv(1) * r0(2)) / det3;
+      X = (gv[2] * r0[1] - gv[1] * r0[2]) / det3;
+      Y = (-fv[2] * r0[1] + fv[1] * r0[2]) / det3;
     }
 
-    double L = std::atan2(Y / R0, X / R0);
+    F L = atan2(Y / R0, X / R0);
 
     // 5 - We assign the results
     return {sma * (1. - ecc * ecc), f, g, h, k, L};
   }
 }
 
-std::array<std::array<double, 3>, 2> eq2ic(const std::array<double, 6> &eq,
-                                           double mu, bool retrogade) {
-  std::array<std::array<double, 3>, 2> retval{};
+template <typename F>
+std::array<vec3_t<F>, 2> eq2ic_impl(const std::array<F, 6> &eq, double mu,
+                                    bool retrogade) {
+  using std::abs;
+  using std::cos;
+  using std::sin;
+  using std::sqrt;
+  std::array<vec3_t<F>, 2> retval{};
   int I = 0;
   if (retrogade) {
     I = -1;
@@ -116,30 +134,30 @@ std::array<std::array<double, 3>, 2> eq2ic(const std::array<double, 6> &eq,
 
   // p = a (1-e^2) will be negative for eccentricities > 1, we here need a
   // positive number for the following computations to make sense
-  double par = std::abs(eq[0]);
-  double f = eq[1];
-  double g = eq[2];
-  double h = eq[3];
-  double k = eq[4];
-  double L = eq[5];
+  F par = abs(eq[0]);
+  F f = eq[1];
+  F g = eq[2];
+  F h = eq[3];
+  F k = eq[4];
+  F L = eq[5];
 
   // We compute the equinoctial reference frame
-  double den = k * k + h * h + 1;
-  double fx = (1 - k * k + h * h) / den;
-  double fy = (2 * k * h) / den;
-  double fz = (-2 * I * k) / den;
+  F den = k * k + h * h + 1;
+  F fx = (1 - k * k + h * h) / den;
+  F fy = (2 * k * h) / den;
+  F fz = (-2 * I * k) / den;
 
-  double gx = (2 * I * k * h) / den;
-  double gy = (1 + k * k - h * h) * I / den;
-  double gz = (2 * h) / den;
+  F gx = (2 * I * k * h) / den;
+  F gy = (1 + k * k - h * h) * I / den;
+  F gz = (2 * h) / den;
 
   // Auxiliary
-  double radius = par / (1 + g * std::sin(L) + f * std::cos(L));
+  F radius = par / (1 + g * sin(L) + f * cos(L));
   // In the equinoctial reference frame
-  double X = radius * std::cos(L);
-  double Y = radius * std::sin(L);
-  double VX = -std::sqrt(mu / par) * (g + std::sin(L));
-  double VY = std::sqrt(mu / par) * (f + std::cos(L));
+  F X = radius * cos(L);
+  F Y = radius * sin(L);
+  F VX = -sqrt(mu / par) * (g + sin(L));
+  F VY = sqrt(mu / par) * (f + cos(L));
 
   // Results
   retval[0][0] = X * fx + Y * gx;
@@ -152,4 +170,36 @@ std::array<std::array<double, 3>, 2> eq2ic(const std::array<double, 6> &eq,
 
   return retval;
 }
-} // namespace kep3
\ No newline at end of file
+
+} // namespace
+
+std::array<double, 6> ic2eq(const std::array<std::array<double, 3>, 2> &pos_vel,
+                            double mu, bool retrogade) {
+  return ic2eq_impl(pos_vel, mu, retrogade);
+}
+
+std::array<std::array<double, 3>, 2> eq2ic(const std::array<double, 6> &eq,
+                                           double mu, bool retrogade) {
+  return eq2ic_impl(eq, mu, retrogade);
+}
+
+std::pair<std::array<double, 6>, std::array<std::array<double, 6>, 6>>
+ic2eq_jac(const std::array<std::array<double, 3>, 2> &pos_vel, double mu,
+          bool retrogade) {
+  const auto x = detail::dual_variables<6>({pos_vel[0][0], pos_vel[0][1],
+                                            pos_vel[0][2], pos_vel[1][0],
+                                            pos_vel[1][1], pos_vel[1][2]});
+  return detail::dual_jacobian(ic2eq_impl<detail::dual<6>>(
+      {{{x[0], x[1], x[2]}, {x[3], x[4], x[5]}}}, mu, retrogade));
+}
+
+std::pair<std::array<std::array<double, 3>, 2>,
+          std::array<std::array<double, 6>, 6>>
+eq2ic_jac(const std::array<double, 6> &eq, double mu, bool retrogade) {
+  const auto pv = eq2ic_impl(detail::dual_variables(eq), mu, retrogade);
+  const auto [f, jac] = detail::dual_jacobian<6>(
+      {pv[0][0], pv[0][1], pv[0][2], pv[1][0], pv[1][1], pv[1][2]});
+  return {{{{f[0], f[1], f[2]}, {f[3], f[4], f[5]}}}, jac};
+}
+
+} // namespace kep3
@@ -9,79 +9,89 @@
 
 #include <array>
 #include <cmath>
-
-#include <xtensor-blas/xlinalg.hpp>
-#include <xtensor/xadapt.hpp>
+#include <stdexcept>
 
 #include <kep3/core_astro/constants.hpp>
 #include <kep3/core_astro/ic2par2ic.hpp>
+#include <kep3/detail/dual.hpp>
+#include <kep3/detail/vec3.hpp>
 
 namespace kep3 {
 
-using xt::linalg::cross;
-using xt::linalg::dot;
+using detail::vec3_cross;
+using detail::vec3_div;
+using detail::vec3_dot;
+using detail::vec3_norm;
+using detail::vec3_sub;
+using detail::vec3_t;
+
+namespace {
+
+// NOTE: the conversions are templated on the scalar type so that their
+// Jacobians can be computed by evaluating them on dual numbers.
 
 // r,v,mu -> keplerian osculating elements [a,e,i,W,w,f]. The last
 // is the true anomaly. The semi-major axis a is positive for ellipses, negative
 // for hyperbolae. The anomalies W, w, f are in [0, 2pi]. Inclination is in [0,
 // pi].
 
-std::array<double, 6>
-ic2par(const std::array<std::array<double, 3>, 2> &pos_vel, double mu) {
+template <typename F>
+std::array<F, 6> ic2par_impl(const std::array<vec3_t<F>, 2> &pos_vel,
+                             double mu) {
+  using std::acos;
   // Return value
-  std::array<double, 6> retval{};
-  // 0 - We prepare a few xtensor constants.
-  xt::xtensor_fixed<double, xt::xshape<3>> k{0.0, 0.0, 1.0};
-  auto r0 = xt::adapt(pos_vel[0]);
-  auto v0 = xt::adapt(pos_vel[1]);
+  std::array<F, 6> retval{};
+  // 0 - We prepare a few constants.
+  const vec3_t<F> k{0.0, 0.0, 1.0};
+  const auto &r0 = pos_vel[0];
+  const auto &v0 = pos_vel[1];
 
   // 1 - We compute the orbital angular momentum vector
-  auto h = cross(r0, v0); // h = r0 x v0
+  const auto h = vec3_cross(r0, v0); // h = r0 x v0
 
   // 2 - We compute the orbital parameter
-  auto p = dot(h, h) / mu; // p = h^2 / mu
+  const F p = vec3_dot(h, h) / mu; // p = h^2 / mu
 
   // 3 - We compute the vector of the node line
   // This operation is singular when inclination is zero, in which case the
   // Keplerian orbital parameters are not well defined
-  auto n = cross(k, h);
-  n = n / xt::linalg::norm(n); // n = (k x h) / |k x h|
+  auto n = vec3_cross(k, h);
+  n = vec3_div(n, vec3_norm(n)); // n = (k x h) / |k x h|
 
   // 4 - We compute the eccentricity vector
-  auto R0 = xt::linalg::norm(r0);
-  auto evett = cross(v0, h) / mu - r0 / R0; // e = (v x h)/mu - r0/R0;
+  const F R0 = vec3_norm(r0);
+  // e = (v x h)/mu - r0/R0;
+  const auto evett =
+      vec3_sub(vec3_div(vec3_cross(v0, h), mu), vec3_div(r0, R0));
 
   // The eccentricity is calculated and stored as the second orbital element
-  retval[1] = xt::linalg::norm(evett);
+  retval[1] = vec3_norm(evett);
 
   // The semi-major axis (positive for ellipses, negative for hyperbolas) is
   // calculated and stored as the first orbital element a = p / (1 - e^2)
-  retval[0] = p(0) / (1 - retval[1] * retval[1]);
+  retval[0] = p / (1 - retval[1] * retval[1]);
 
   // Inclination is calculated and stored as the third orbital element
   // i = acos(hy/h) in [0, pi]
-  retval[2] = std::acos(h(2) / xt::linalg::norm(h));
+  retval[2] = acos(h[2] / vec3_norm(h));
 
   // Argument of pericentrum is calculated and stored as the fifth orbital
   // element. w = acos(n.e)\|n||e| in [0, 2pi]
-  auto temp = dot(n, evett);
-  retval[4] = std::acos(temp(0) / retval[1]);
-  if (evett(2) < 0) {
+  retval[4] = acos(vec3_dot(n, evett) / retval[1]);
+  if (evett[2] < 0) {
     retval[4] = 2 * pi - retval[4];
   }
   // Argument of longitude is calculated and stored as the fourth orbital
   // element in [0, 2pi]
-  retval[3] = std::acos(n(0));
-  if (n(1) < 0) {
+  retval[3] = acos(n[0]);
+  if (n[1] < 0) {
     retval[3] = 2 * pi - retval[3];
   }
 
   // 4 - We compute ni: the true anomaly in [0, 2pi]
-  temp = dot(evett, r0);
-  auto f = std::acos(temp(0) / retval[1] / R0);
+  auto f = acos(vec3_dot(evett, r0) / retval[1] / R0);
 
-  temp = dot(r0, v0);
-  if (temp(0) < 0.0) {
+  if (vec3_dot(r0, v0) < 0.0) {
     f = 2 * pi - f;
   }
   retval[5] = f;
@@ -94,27 +104,24 @@ ic2par(const std::array<std::array<double, 3>, 2> &pos_vel, double mu) {
 // for ellipses, negative for hyperbolae.
 // The anomalies W, w and E must be in [0, 2pi] and inclination in [0, pi].
 
-std::array<std::array<double, 3>, 2> par2ic(const std::array<double, 6> &par,
-                                            double mu) {
-  // Return values
-  std::array<double, 3> pos{};
-  std::array<double, 3> vel{};
-  auto pos_xt = xt::adapt(pos, {3u, 1u});
-  auto vel_xt = xt::adapt(vel, {3u, 1u});
-
+template <typename F>
+std::array<vec3_t<F>, 2> par2ic_impl(const std::array<F, 6> &par, double mu) {
+  using std::cos;
+  using std::sin;
+  using std::sqrt;
   // Rename some variables for readibility
-  double sma = par[0];
-  double ecc = par[1];
-  double inc = par[2];
-  double omg = par[3];
-  double omp = par[4];
-  double f = par[5];
+  const F &sma = par[0];
+  const F &ecc = par[1];
+  const F &inc = par[2];
+  const F &omg = par[3];
+  const F &omp = par[4];
+  const F &f = par[5];
 
   if (sma * (1 - ecc) < 0) {
     throw std::domain_error("par2ic was called with ecc and sma not compatible "
                             "with the convention a<0 -> e>1 [a>0 -> e<1].");
   }
-  double cosf = std::cos(f);
+  F cosf = cos(f);
   if (ecc > 1 && cosf < -1 / ecc) {
     throw std::domain_error("par2ic was called for an hyperbola but the true "
                             "anomaly is beyond asymptotes (cosf<-1/e)");
@@ -122,41 +129,69 @@ std::array<std::array<double, 3>, 2> par2ic(const std::array<double, 6> &par,
 
   // 1 - We start by evaluating position and velocity in the perifocal reference
   // system
-  double p = sma * (1.0 - ecc * ecc);
-  double r = p / (1.0 + ecc * std::cos(f));
-  double h = std::sqrt(p * mu);
-  double sinf = std::sin(f);
-  double x_per = r * cosf;
-  double y_per = r * sinf;
-  double xdot_per = -mu / h * sinf;
-  double ydot_per = mu / h * (ecc + cosf);
+  F p = sma * (1.0 - ecc * ecc);
+  F r = p / (1.0 + ecc * cos(f));
+  F h = sqrt(p * mu);
+  F sinf = sin(f);
+  F x_per = r * cosf;
+  F y_per = r * sinf;
+  F xdot_per = -mu / h * sinf;
+  F ydot_per = mu / h * (ecc + cosf);
 
   // 2 - We then built the rotation matrix from perifocal reference frame to
   // inertial
-  double cosomg = std::cos(omg);
-  double cosomp = std::cos(omp);
-  double sinomg = std::sin(omg);
-  double sinomp = std::sin(omp);
-  double cosi = std::cos(inc);
-  double sini = std::sin(inc);
-
-  xt::xtensor_fixed<double, xt::xshape<3, 3>> R = {
-      {cosomg * cosomp - sinomg * sinomp * cosi,
-       -cosomg * sinomp - sinomg * cosomp * cosi, sinomg * sini},
-      {sinomg * cosomp + cosomg * sinomp * cosi,
-       -sinomg * sinomp + cosomg * cosomp * cosi, -cosomg * sini},
-      {sinomp * sini, cosomp * sini, cosi}};
+  F cosomg = cos(omg);
+  F cosomp = cos(omp);
+  F sinomg = sin(omg);
+  F sinomp = sin(omp);
+  F cosi = cos(inc);
+  F sini = sin(inc);
+
+  const std::array<vec3_t<F>, 3> R = {
+      {{cosomg * cosomp - sinomg * sinomp * cosi,
+        -cosomg * sinomp - sinomg * cosomp * cosi, sinomg * sini},
+       {sinomg * cosomp + cosomg * sinomp * cosi,
+        -sinomg * sinomp + cosomg * cosomp * cosi, -cosomg * sini},
+       {sinomp * sini, cosomp * sini, cosi}}};
 
   // 3 - We end by transforming according to this rotation matrix
-  xt::xtensor_fixed<double, xt::xshape<3, 1>> pos_per{{x_per}, {y_per}, {0.0}};
-  xt::xtensor_fixed<double, xt::xshape<3, 1>> vel_per{
-      {xdot_per}, {ydot_per}, {0.0}};
+  const vec3_t<F> pos_per{x_per, y_per, 0.0};
+  const vec3_t<F> vel_per{xdot_per, ydot_per, 0.0};
+  return {{{vec3_dot(R[0], pos_per), vec3_dot(R[1], pos_per),
+            vec3_dot(R[2], pos_per)},
+           {vec3_dot(R[0], vel_per), vec3_dot(R[1], vel_per),
+            vec3_dot(R[2], vel_per)}}};
+}
+
+} // namespace
 
-  // The following lines, since use xtensors adapted to pos and vel, will change
-  // pos and vel.
-  pos_xt = xt::linalg::dot(R, pos_per);
-  vel_xt = xt::linalg::dot(R, vel_per);
+std::array<double, 6>
+ic2par(const std::array<std::array<double, 3>, 2> &pos_vel, double mu) {
+  return ic2par_impl(pos_vel, mu);
+}
+
+std::array<std::array<double, 3>, 2> par2ic(const std::array<double, 6> &par,
+                                            double mu) {
+  return par2ic_impl(par, mu);
+}
 
-  return {pos, vel};
+std::pair<std::array<double, 6>, std::array<std::array<double, 6>, 6>>
+ic2par_jac(const std::array<std::array<double, 3>, 2> &pos_vel, double mu) {
+  const auto x = detail::dual_variables<6>({pos_vel[0][0], pos_vel[0][1],
+                                            pos_vel[0][2], pos_vel[1][0],
+                                            pos_vel[1][1], pos_vel[1][2]});
+  return detail::dual_jacobian(
+      ic2par_impl<detail::dual<6>>({{{x[0], x[1], x[2]}, {x[3], x[4], x[5]}}},
+                                   mu));
 }
-} // namespace kep3
\ No newline at end of file
+
+std::pair<std::array<std::array<double, 3>, 2>,
+          std::array<std::array<double, 6>, 6>>
+par2ic_jac(const std::array<double, 6> &par, double mu) {
+  const auto pv = par2ic_impl(detail::dual_variables(par), mu);
+  const auto [f, jac] = detail::dual_jacobian<6>(
+      {pv[0][0], pv[0][1], pv[0][2], pv[1][0], pv[1][1], pv[1][2]});
+  return {{{{f[0], f[1], f[2]}, {f[3], f[4], f[5]}}}, jac};
+}
+
+} // namespace kep3
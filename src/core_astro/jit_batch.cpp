@@ -0,0 +1,207 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include <heyoka/heyoka.hpp>
+
+#include <kep3/core_astro/elements_batch.hpp>
+#include <kep3/core_astro/jit_batch.hpp>
+
+namespace kep3 {
+
+namespace {
+
+namespace hy = heyoka;
+
+using cfunc_t = hy::cfunc<double>;
+
+// A compiled kernel, with the gravity parameter as its only runtime
+// parameter, par[0]. NOTE: the kernels are static locals of the functions
+// below, compiled on first use in a thread safe way and then shared by all
+// the calls. A cfunc does not guarantee that concurrent evaluations are
+// safe, so that they are serialised by the mutex, while each evaluation is
+// split among threads by heyoka (parallel mode).
+struct jit_kernel {
+  explicit jit_kernel(cfunc_t c) : cf(std::move(c)) {}
+  cfunc_t cf;
+  std::mutex mutex;
+};
+
+cfunc_t make_kernel(std::vector<hy::expression> fn,
+                    std::vector<hy::expression> vars) {
+  return cfunc_t(std::move(fn), std::move(vars), hy::kw::parallel_mode = true);
+}
+
+// Rotation of the perifocal position and velocity (x, y, vx, vy) to the
+// inertial frame, R being the first two columns of the rotation matrix.
+std::vector<hy::expression>
+rotate(const std::array<std::array<hy::expression, 2>, 3> &R,
+       const hy::expression &x, const hy::expression &y,
+       const hy::expression &vx, const hy::expression &vy) {
+  return {R[0][0] * x + R[0][1] * y,   R[1][0] * x + R[1][1] * y,
+          R[2][0] * x + R[2][1] * y,   R[0][0] * vx + R[0][1] * vy,
+          R[1][0] * vx + R[1][1] * vy, R[2][0] * vx + R[2][1] * vy};
+}
+
+// par2ic(), without the checks on the elements.
+jit_kernel &par2ic_kernel() {
+  static jit_kernel kernel{[]() {
+    auto [sma, ecc, inc, omg, omp, f] =
+        hy::make_vars("a", "e", "i", "W", "w", "f");
+    const auto mu = hy::par[0];
+    const auto p = sma * (1. - ecc * ecc);
+    const auto r = p / (1. + ecc * hy::cos(f));
+    const auto h = hy::sqrt(p * mu);
+    const auto cosomg = hy::cos(omg), sinomg = hy::sin(omg);
+    const auto cosomp = hy::cos(omp), sinomp = hy::sin(omp);
+    const auto cosi = hy::cos(inc), sini = hy::sin(inc);
+    const std::array<std::array<hy::expression, 2>, 3> R = {
+        {{cosomg * cosomp - sinomg * sinomp * cosi,
+          -cosomg * sinomp - sinomg * cosomp * cosi},
+         {sinomg * cosomp + cosomg * sinomp * cosi,
+          -sinomg * sinomp + cosomg * cosomp * cosi},
+         {sinomp * sini, cosomp * sini}}};
+    return make_kernel(rotate(R, r * hy::cos(f), r * hy::sin(f),
+                              -mu / h * hy::sin(f),
+                              mu / h * (ecc + hy::cos(f))),
+                       {sma, ecc, inc, omg, omp, f});
+  }()};
+  return kernel;
+}
+
+// eq2ic(), for I = 1 (prograde) or I = -1 (retrograde). NOTE: the semi-latus
+// rectum is taken as given, without the abs() of the scalar version.
+cfunc_t make_eq2ic_kernel(double I) {
+  auto [p, f, g, h, k, L] = hy::make_vars("p", "f", "g", "h", "k", "L");
+  const auto mu = hy::par[0];
+  const auto den = k * k + h * h + 1.;
+  const std::array<std::array<hy::expression, 2>, 3> R = {
+      {{(1. - k * k + h * h) / den, (2. * I) * k * h / den},
+       {(2. * k * h) / den, (1. + k * k - h * h) * I / den},
+       {(-2. * I) * k / den, (2. * h) / den}}};
+  const auto radius = p / (1. + g * hy::sin(L) + f * hy::cos(L));
+  return make_kernel(rotate(R, radius * hy::cos(L), radius * hy::sin(L),
+                            -hy::sqrt(mu / p) * (g + hy::sin(L)),
+                            hy::sqrt(mu / p) * (f + hy::cos(L))),
+                     {p, f, g, h, k, L});
+}
+
+jit_kernel &eq2ic_kernel(bool retrogade) {
+  if (retrogade) {
+    static jit_kernel kernel_r{make_eq2ic_kernel(-1.)};
+    return kernel_r;
+  }
+  static jit_kernel kernel{make_eq2ic_kernel(1.)};
+  return kernel;
+}
+
+// The elliptic branch of propagate_lagrangian().
+jit_kernel &propagate_lagrangian_kernel() {
+  static jit_kernel kernel{[]() {
+    auto [x, y, z, vx, vy, vz, dt] =
+        hy::make_vars("x", "y", "z", "vx", "vy", "vz", "dt");
+    const auto mu = hy::par[0];
+    const auto R = hy::sqrt(x * x + y * y + z * z);
+    const auto V2 = vx * vx + vy * vy + vz * vz;
+    const auto a = -mu / 2. / (V2 / 2. - mu / R);
+    const auto sqrta = hy::sqrt(a);
+    const auto sigma0 = (x * vx + y * vy + z * vz) / hy::sqrt(mu);
+    const auto DM = hy::sqrt(mu / (a * a * a)) * dt;
+    // As in the scalar version, the mean anomaly difference is reduced to a
+    // single revolution with atan2() rather than with fmod().
+    const auto DE = hy::kepDE(sigma0 / sqrta, 1. - R / a,
+                              hy::atan2(hy::sin(DM), hy::cos(DM)));
+    const auto r = a + (R - a) * hy::cos(DE) + sigma0 * sqrta * hy::sin(DE);
+    // Lagrange coefficients.
+    const auto F = 1. - a / R * (1. - hy::cos(DE));
+    const auto G = a * sigma0 / hy::sqrt(mu) * (1. - hy::cos(DE)) +
+                   R * hy::sqrt(a / mu) * hy::sin(DE);
+    const auto Ft = -hy::sqrt(mu * a) / (r * R) * hy::sin(DE);
+    const auto Gt = 1. - a / r * (1. - hy::cos(DE));
+    return make_kernel({F * x + G * vx, F * y + G * vy, F * z + G * vz,
+                        Ft * x + Gt * vx, Ft * y + Gt * vy, Ft * z + Gt * vz},
+                       {x, y, z, vx, vy, vz, dt});
+  }()};
+  return kernel;
+}
+
+// Evaluates kernel on the states in, one per index of the spans. NOTE: the
+// kernels work on row major 2D arrays with one row per input (output,
+// parameter) and one column per state, so the spans are packed into
+// contiguous buffers.
+template <std::size_t N>
+void run_kernel(const char *func, jit_kernel &kernel,
+                const std::array<std::span<const double>, N> &in, double mu,
+                const elements_batch_output &out) {
+  const std::size_t n = in[0].size();
+  for (std::size_t c = 0u; c < N; ++c) {
+    if (in[c].size() != n) {
+      throw std::invalid_argument(fmt::format(
+          "{}: inconsistent sizes of the input/output spans.", func));
+    }
+  }
+  for (std::size_t c = 0u; c < 6u; ++c) {
+    if (out[c].size() != n) {
+      throw std::invalid_argument(fmt::format(
+          "{}: inconsistent sizes of the input/output spans.", func));
+    }
+  }
+  if (n == 0u) {
+    return;
+  }
+  std::vector<double> in_buf(N * n), out_buf(6u * n);
+  const std::vector<double> pars_buf(n, mu);
+  for (std::size_t c = 0u; c < N; ++c) {
+    std::copy(in[c].begin(), in[c].end(), in_buf.begin() + c * n);
+  }
+  {
+    const std::lock_guard<std::mutex> lock(kernel.mutex);
+    kernel.cf(cfunc_t::out_2d(out_buf.data(), 6u, n),
+              cfunc_t::in_2d(in_buf.data(), N, n),
+              hy::kw::pars = cfunc_t::in_2d(pars_buf.data(), 1u, n));
+  }
+  for (std::size_t c = 0u; c < 6u; ++c) {
+    std::copy(out_buf.begin() + c * n, out_buf.begin() + (c + 1u) * n,
+              out[c].begin());
+  }
+}
+
+} // namespace
+
+void par2ic_jit_batch(const elements_batch_input &par, double mu,
+                      const elements_batch_output &pos_vel) {
+  run_kernel("par2ic_jit_batch", par2ic_kernel(), par, mu, pos_vel);
+}
+
+void eq2ic_jit_batch(const elements_batch_input &eq, double mu,
+                     const elements_batch_output &pos_vel, bool retrogade) {
+  run_kernel("eq2ic_jit_batch", eq2ic_kernel(retrogade), eq, mu, pos_vel);
+}
+
+void propagate_lagrangian_jit_batch(const elements_batch_input &pos_vel,
+                                    std::span<const double> dt, double mu,
+                                    const elements_batch_output &pos_vel_new) {
+  run_kernel("propagate_lagrangian_jit_batch", propagate_lagrangian_kernel(),
+             std::array<std::span<const double>, 7>{pos_vel[0], pos_vel[1],
+                                                    pos_vel[2], pos_vel[3],
+                                                    pos_vel[4], pos_vel[5], dt},
+             mu, pos_vel_new);
+}
+
+} // namespace kep3
@@ -0,0 +1,115 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
+
+#include <boost/math/tools/roots.hpp>
+#include <fmt/core.h>
+
+#include <kep3/core_astro/constants.hpp>
+#include <kep3/core_astro/ic2eq2ic.hpp>
+#include <kep3/core_astro/kepler_equations.hpp>
+#include <kep3/core_astro/propagate_lagrangian.hpp>
+#include <kep3/core_astro/propagate_meq.hpp>
+
+namespace kep3 {
+
+// NOTE: in the orbital plane, with the x axis along the one of the
+// equinoctial frame, the position is r (cos(L), sin(L)) = a (X, Y) where
+// X = (1 - g^2 b) cos(F) + f g b sin(F) - f,
+// Y = (1 - f^2 b) sin(F) + f g b cos(F) - g
+// and b = 1 / (1 + sqrt(1 - e^2)) (Broucke and Cefola, 1972). The mean
+// longitude is F - f sin(F) + g cos(F), so that Kepler's equation can be
+// solved for the eccentric longitude F without ever computing the argument of
+// pericentre or the ascending node, which are not defined on circular or
+// equatorial orbits.
+void propagate_meq(std::array<double, 6> &eq, const double dt, const double mu,
+                   bool retrogade) {
+  const double f = eq[1], g = eq[2], L0 = eq[5];
+  const double e2 = f * f + g * g;
+  // NOTE: the negated comparison also catches NaNs.
+  if (!(e2 < 1.)) {
+    // No eccentric longitude: we pass through the cartesian state.
+    auto pos_vel = eq2ic(eq, mu, retrogade);
+    propagate_lagrangian(pos_vel, dt, mu);
+    // On hyperbolas the true longitude changes by less than 2pi, with the
+    // sign of dt.
+    double DL = std::fmod(ic2eq(pos_vel, mu, retrogade)[5] - L0, 2 * pi);
+    if (dt > 0. && DL < 0.) {
+      DL += 2 * pi;
+    } else if (dt < 0. && DL > 0.) {
+      DL -= 2 * pi;
+    }
+    eq[5] = L0 + DL;
+    return;
+  }
+  const double a = eq[0] / (1. - e2);
+  const double sqrt1me2 = std::sqrt(1. - e2);
+  const double b = 1. / (1. + sqrt1me2);
+
+  // 1 - We compute the initial eccentric longitude, taking it continuous
+  // with L0 (the true and eccentric longitudes differ by less than pi).
+  const double cosL0 = std::cos(L0), sinL0 = std::sin(L0);
+  const double r_a = (1. - e2) / (1. + f * cosL0 + g * sinL0);
+  const double X0 = r_a * cosL0, Y0 = r_a * sinL0;
+  const double cosF0 = f + ((1. - f * f * b) * X0 - f * g * b * Y0) / sqrt1me2;
+  const double sinF0 = g + ((1. - g * g * b) * Y0 - f * g * b * X0) / sqrt1me2;
+  const double F0 =
+      L0 - std::remainder(L0 - std::atan2(sinF0, cosF0), 2 * pi);
+
+  // 2 - We solve Kepler's equation in DF. The full revolutions are set apart
+  // (with an exact fmod) and added back at the end.
+  const double DM = std::sqrt(mu / (a * a * a)) * dt;
+  double DM_cropped = std::fmod(DM, 2 * pi);
+  if (DM_cropped < 0) {
+    DM_cropped += 2 * pi;
+  }
+  const double revs = DM - DM_cropped;
+  const double sinDM = std::sin(DM_cropped), cosDM = std::cos(DM_cropped);
+  const double s0 = f * sinF0 - g * cosF0;
+  const double c0 = f * cosF0 + g * sinF0;
+  // The same initial guess as in propagate_lagrangian(), as Kepler's equation
+  // in DF has the same form as the one in DE.
+  const double IG =
+      DM_cropped + c0 * sinDM - s0 * (1 - cosDM) +
+      (c0 * cosDM - s0 * sinDM) * (c0 * sinDM + s0 * cosDM - s0) +
+      0.5 * (c0 * sinDM + s0 * cosDM - s0) *
+          (2 * std::pow(c0 * cosDM - s0 * sinDM, 2) -
+           (c0 * sinDM + s0 * cosDM - s0) * (c0 * sinDM + s0 * cosDM));
+  const int digits = std::numeric_limits<double>::digits;
+  std::uintmax_t max_iter = 100u;
+  const double DF = boost::math::tools::newton_raphson_iterate(
+      [DM_cropped, s0, c0](double x) {
+        return std::make_tuple(kepDF(x, DM_cropped, s0, c0),
+                               d_kepDF(x, s0, c0));
+      },
+      IG, IG - pi, IG + pi, digits, max_iter);
+  if (max_iter == 100u) {
+    throw std::domain_error(fmt::format(
+        "Maximum number of iterations exceeded when solving Kepler's "
+        "equation for the eccentric longitude in propagate_meq.\n"
+        "DM={}\ns0={}\nc0={}\nDF={}",
+        DM, s0, c0, DF));
+  }
+
+  // 3 - We recover the true longitude, continuous with F1. NOTE: the full
+  // revolutions are left out of the arguments of the trigonometric functions.
+  const double F1 = F0 + DF;
+  const double cosF1 = std::cos(F1), sinF1 = std::sin(F1);
+  const double X1 = (1. - g * g * b) * cosF1 + f * g * b * sinF1 - f;
+  const double Y1 = (1. - f * f * b) * sinF1 + f * g * b * cosF1 - g;
+  eq[5] = F1 + std::remainder(std::atan2(Y1, X1) - F1, 2 * pi) + revs;
+}
+
+} // namespace kep3
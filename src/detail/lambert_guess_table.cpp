@@ -0,0 +1,128 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include <kep3/core_astro/constants.hpp>
+#include <kep3/detail/lambert_guess_table.hpp>
+#include <kep3/detail/lambert_kernels.hpp>
+#include <kep3/detail/lambert_tmin_table.hpp>
+
+namespace kep3::detail {
+
+namespace {
+
+// The surface x(lambda, T) of each branch is tabulated on a uniform grid in
+// phi = acos(lambda) and u, where u = log(T) for N = 0 and u = log(T - T_min)
+// for N > 0. The latter takes care of the square root behaviour of x close to
+// the minimum time of flight, and makes the two branches smooth functions of
+// u.
+constexpr unsigned n_phi = 64u;
+constexpr unsigned n_u = 128u;
+constexpr double h_phi = kep3::pi / n_phi;
+constexpr double u_min_zero_rev = -3.;
+constexpr double u_max_zero_rev = 8.;
+constexpr double u_min_multi_rev = -8.;
+constexpr double u_max_multi_rev = 7.;
+// The branches are stored in the order used by kep3::lambert_problem: N = 0,
+// then left and right for N = 1, 2, ...
+constexpr unsigned n_branches = 2u * lambert_x_guess_table_N + 1u;
+
+double node_lambda(double phi) {
+  return std::clamp(std::cos(phi), -1.0 + 1e-13, 1.0 - 1e-13);
+}
+
+double u_min(unsigned N) { return N == 0u ? u_min_zero_rev : u_min_multi_rev; }
+double u_max(unsigned N) { return N == 0u ? u_max_zero_rev : u_max_multi_rev; }
+
+// Cubic interpolation at t in [0, 1] through the values at -1, 0, 1 and 2.
+double cubic(double p0, double p1, double p2, double p3, double t) {
+  return p1 + 0.5 * t *
+                  (p2 - p0 +
+                   t * (2. * p0 - 5. * p1 + 4. * p2 - p3 +
+                        t * (3. * (p1 - p2) + p3 - p0)));
+}
+
+struct guess_table {
+  std::array<std::array<std::array<double, n_u + 1u>, n_phi + 1u>, n_branches>
+      x{};
+
+  guess_table() {
+    for (unsigned b = 0u; b < n_branches; ++b) {
+      const unsigned N = (b + 1u) / 2u;
+      const bool right = b != 0u && b % 2u == 0u;
+      const double h_u = (u_max(N) - u_min(N)) / n_u;
+      for (unsigned i = 0u; i <= n_phi; ++i) {
+        const double lambda = node_lambda(i * h_phi);
+        const double T_min = N == 0u ? 0. : lambert_T_min(lambda, N);
+        // Continuation in u: each solution is searched from the previous one,
+        // starting from the analytic guess at the largest time of flight.
+        double x_j = 0.;
+        for (unsigned j = n_u + 1u; j-- > 0u;) {
+          const double T = T_min + std::exp(u_min(N) + j * h_u);
+          if (j == n_u) {
+            lambert_solve_branch(T, lambda, N, right, x_j);
+          }
+          lambert_householder(T, x_j, N, 1e-14, 50u, lambda);
+          x[b][i][j] = x_j;
+        }
+      }
+    }
+  }
+};
+
+const guess_table &get_guess_table() {
+  static const guess_table table;
+  return table;
+}
+
+} // namespace
+
+bool lambert_x_guess_lookup(double T, double lambda, unsigned N, bool right,
+                            double &x) {
+  // NOTE: the negated comparisons also catch NaNs.
+  if (N > lambert_x_guess_table_N || !(std::abs(lambda) <= 1.) || !(T > 0.)) {
+    return false;
+  }
+  double T_min = 0., x_min = 0., err = 0.;
+  if (N > 0u) {
+    lambert_T_min_lookup(lambda, N, T_min, x_min, err);
+  }
+  const double u = std::log(T - T_min);
+  // NOTE: the negated comparison also catches T < T_min.
+  if (!(u >= u_min(N)) || u > u_max(N)) {
+    return false;
+  }
+  const unsigned b = N == 0u ? 0u : (right ? 2u * N : 2u * N - 1u);
+  const auto &x_b = get_guess_table().x[b];
+  const double a = std::acos(lambda) / h_phi;
+  const double c = (u - u_min(N)) / (u_max(N) - u_min(N)) * n_u;
+  // Index of the interval, moved inwards at the borders so that the
+  // interpolation stencil stays within the table.
+  const auto i = std::clamp(static_cast<unsigned>(a), 1u, n_phi - 2u);
+  const auto j = std::clamp(static_cast<unsigned>(c), 1u, n_u - 2u);
+  std::array<double, 4> rows{};
+  for (unsigned k = 0u; k < 4u; ++k) {
+    const auto &row = x_b[i - 1u + k];
+    rows[k] = cubic(row[j - 1u], row[j], row[j + 1u], row[j + 2u], c - j);
+  }
+  const double retval = cubic(rows[0], rows[1], rows[2], rows[3], a - i);
+  // For N > 0 the guess must lie on the requested side of the minimum, or the
+  // iterations could converge to the other branch.
+  if (N > 0u && !(right ? (retval > x_min && retval < 1.)
+                        : (retval < x_min && retval > -1.))) {
+    return false;
+  }
+  x = retval;
+  return true;
+}
+
+} // namespace kep3::detail
@@ -0,0 +1,105 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include <kep3/core_astro/constants.hpp>
+#include <kep3/detail/lambert_kernels.hpp>
+#include <kep3/detail/lambert_tmin_table.hpp>
+
+namespace kep3::detail {
+
+namespace {
+
+// The table is built on a uniform grid in phi = acos(lambda), as T_min is a
+// smooth function of phi (e.g. T00 = phi + sin(phi) cos(phi)) while it is not
+// of lambda at lambda = +-1.
+constexpr unsigned n_intervals = 128u;
+constexpr double h_phi = kep3::pi / n_intervals;
+
+// The Lambert kernels are singular at lambda = +-1, hence the end nodes are
+// placed slightly inside the domain.
+double node_lambda(double phi) {
+  return std::clamp(std::cos(phi), -1.0 + 1e-13, 1.0 - 1e-13);
+}
+
+struct tmin_node {
+  // T_min, its derivative with respect to phi and the corresponding x.
+  double T, dT, x;
+};
+
+// Cubic Hermite interpolation of T_min at s in [0, 1] within an interval.
+double hermite(const tmin_node &a, const tmin_node &b, double s) {
+  const double s2 = s * s;
+  const double s3 = s2 * s;
+  return (2. * s3 - 3. * s2 + 1.) * a.T + (s3 - 2. * s2 + s) * h_phi * a.dT +
+         (-2. * s3 + 3. * s2) * b.T + (s3 - s2) * h_phi * b.dT;
+}
+
+struct tmin_table {
+  std::array<std::array<tmin_node, n_intervals + 1u>, lambert_T_min_table_N>
+      nodes{};
+  // Bound on the interpolation error of T_min within each interval.
+  std::array<std::array<double, n_intervals>, lambert_T_min_table_N> err{};
+
+  tmin_table() {
+    for (unsigned N = 1u; N <= lambert_T_min_table_N; ++N) {
+      auto &nodes_N = nodes[N - 1u];
+      // Continuation in phi: each minimum is searched from the previous one.
+      double x = 0.0;
+      for (unsigned k = 0u; k <= n_intervals; ++k) {
+        const double phi = k * h_phi;
+        const double lambda = node_lambda(phi);
+        nodes_N[k].T = lambert_T_min_from(lambda, N, x, x);
+        nodes_N[k].x = x;
+        // As dT/dx = 0 at the minimum, dT_min/dlambda is the partial
+        // derivative of T with respect to lambda.
+        nodes_N[k].dT = lambert_dTdlambda(x, lambda) * (-std::sin(phi));
+      }
+      // The error bound is estimated from the error at the midpoint of each
+      // interval, with a generous safety factor.
+      for (unsigned k = 0u; k < n_intervals; ++k) {
+        const double lambda = node_lambda((k + 0.5) * h_phi);
+        double x_mid = 0.5 * (nodes_N[k].x + nodes_N[k + 1u].x);
+        const double T_mid = lambert_T_min_from(lambda, N, x_mid, x_mid);
+        err[N - 1u][k] =
+            8. * std::abs(hermite(nodes_N[k], nodes_N[k + 1u], 0.5) - T_mid) +
+            1e-12 * T_mid;
+      }
+    }
+  }
+};
+
+const tmin_table &get_tmin_table() {
+  static const tmin_table table;
+  return table;
+}
+
+} // namespace
+
+bool lambert_T_min_lookup(double lambda, unsigned N, double &T_min,
+                          double &x_min, double &err) {
+  // NOTE: the negated comparison also catches NaNs.
+  if (N == 0u || N > lambert_T_min_table_N || !(std::abs(lambda) <= 1.)) {
+    return false;
+  }
+  const auto &table = get_tmin_table();
+  const auto &nodes_N = table.nodes[N - 1u];
+  const double u = std::acos(lambda) / h_phi;
+  const auto k = std::min(static_cast<unsigned>(u), n_intervals - 1u);
+  const double s = u - k;
+  T_min = hermite(nodes_N[k], nodes_N[k + 1u], s);
+  x_min = (1. - s) * nodes_N[k].x + s * nodes_N[k + 1u].x;
+  err = table.err[N - 1u][k];
+  return true;
+}
+
+} // namespace kep3::detail
@@ -0,0 +1,201 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <fstream>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include <kep3/core_astro/constants.hpp>
+#include <kep3/detail/npy.hpp>
+#include <kep3/detail/parallel_for.hpp>
+#include <kep3/detail/same_central_body.hpp>
+#include <kep3/dv_matrix.hpp>
+#include <kep3/epoch.hpp>
+#include <kep3/lambert_solve.hpp>
+#include <kep3/planet.hpp>
+
+namespace kep3 {
+
+namespace {
+
+// Side of the square tiles of a matrix. A tile touches the departure and
+// arrival states of 2 * dv_matrix_tile targets (about 12KB), which stay in
+// L1 while its dv_matrix_tile^2 Lambert problems are solved.
+constexpr std::size_t dv_matrix_tile = 64u;
+
+using state = std::array<std::array<double, 3>, 2>;
+
+double norm_diff(const std::array<double, 3> &a,
+                 const std::array<double, 3> &b) {
+  return std::sqrt((a[0] - b[0]) * (a[0] - b[0]) +
+                   (a[1] - b[1]) * (a[1] - b[1]) +
+                   (a[2] - b[2]) * (a[2] - b[2]));
+}
+
+// Gravity parameter shared by all the targets.
+double targets_mu(std::vector<planet> &targets, const char *func) {
+  if (targets.empty()) {
+    return 0.;
+  }
+  const double mu = targets[0].get_mu_central_body();
+  // NOTE: the negated comparison also catches NaNs.
+  if (!(mu > 0)) {
+    throw std::domain_error(fmt::format(
+        "{}: The gravity parameter of the central body of the targets is zero "
+        "or negative!",
+        func));
+  }
+  for (std::size_t i = 1u; i < targets.size(); ++i) {
+    if (!detail::same_central_body(mu, targets[i].get_mu_central_body())) {
+      throw std::invalid_argument(fmt::format(
+          "{}: All the targets must orbit the same central body, but the "
+          "gravity parameters of targets 0 and {} are {} and {}",
+          func, i, mu, targets[i].get_mu_central_body()));
+    }
+  }
+  return mu;
+}
+
+// States of all the targets at an epoch.
+void target_states(std::vector<planet> &targets, double t,
+                   std::vector<state> &out) {
+  const epoch ep(t);
+  for (std::size_t i = 0u; i < targets.size(); ++i) {
+    out[i] = targets[i].eph(ep);
+  }
+}
+
+// Minimum number of tiles solved by each call to parallel_for(), per
+// hardware thread, so that the threads it spawns are kept busy and balanced.
+constexpr std::size_t dv_matrix_tiles_per_thread = 8u;
+
+// Computes the DV matrices, calling sink() on consecutive slabs of rows, in
+// the order of the output array. A slab is made of whole bands of
+// dv_matrix_tile rows (fewer for the last one of each matrix), as many as
+// needed to have dv_matrix_tiles_per_thread tiles per hardware thread: the
+// tiles of all its bands are solved by a single call to parallel_for(), while
+// for large catalogs the buffer stays of the size of a band.
+template <typename Sink>
+void dv_matrix_impl(std::vector<planet> &targets, double mu,
+                    std::span<const double> t_dep, std::span<const double> tof,
+                    bool cw, unsigned multi_revs, lambert_accuracy accuracy,
+                    const Sink &sink) {
+  const std::size_t n = targets.size();
+  const std::size_t n_tiles = (n + dv_matrix_tile - 1u) / dv_matrix_tile;
+  const std::size_t n_hw =
+      std::max(static_cast<std::size_t>(std::thread::hardware_concurrency()),
+               std::size_t(1));
+  const std::size_t slab_bands = std::max(
+      (dv_matrix_tiles_per_thread * n_hw + n_tiles - 1u) /
+          std::max(n_tiles, std::size_t(1)),
+      std::size_t(1));
+  const std::size_t slab_rows = std::min(slab_bands * dv_matrix_tile, n);
+  std::vector<state> dep_states(n), arr_states(n);
+  std::vector<double> slab(slab_rows * n);
+  for (const double td : t_dep) {
+    // 1 - Departure states, once per departure epoch.
+    target_states(targets, td, dep_states);
+    for (const double dt : tof) {
+      // 2 - Arrival states, once per arrival epoch.
+      target_states(targets, td + dt, arr_states);
+      const double tof_s = dt * DAY2SEC;
+      // 3 - Lambert problems, slab by slab of rows, with the tiles of all the
+      // bands of a slab solved in parallel.
+      for (std::size_t s0 = 0u; s0 < n; s0 += slab_rows) {
+        const std::size_t s1 = std::min(s0 + slab_rows, n);
+        const std::size_t n_bands =
+            (s1 - s0 + dv_matrix_tile - 1u) / dv_matrix_tile;
+        detail::parallel_for(
+            n_bands * n_tiles, 1u, [&](std::size_t begin, std::size_t end) {
+              for (std::size_t k = begin; k < end; ++k) {
+                const std::size_t i0 = s0 + (k / n_tiles) * dv_matrix_tile;
+                const std::size_t i1 = std::min(i0 + dv_matrix_tile, s1);
+                const std::size_t j0 = (k % n_tiles) * dv_matrix_tile;
+                const std::size_t j1 = std::min(j0 + dv_matrix_tile, n);
+                for (std::size_t i = i0; i < i1; ++i) {
+                  const auto &[r1, v_dep] = dep_states[i];
+                  for (std::size_t j = j0; j < j1; ++j) {
+                    const auto &[r2, v_arr] = arr_states[j];
+                    const auto sol =
+                        (multi_revs == 0u)
+                            ? lambert_solve(r1, r2, tof_s, mu, cw, {},
+                                            accuracy)
+                            : lambert_solve_min_dv(r1, r2, tof_s, mu, v_dep,
+                                                   v_arr, cw, multi_revs,
+                                                   accuracy);
+                    slab[(i - s0) * n + j] =
+                        (sol.status == lambert_status::success)
+                            ? norm_diff(sol.v1, v_dep) +
+                                  norm_diff(sol.v2, v_arr)
+                            : std::numeric_limits<double>::quiet_NaN();
+                  }
+                }
+              }
+            });
+        sink(std::span<const double>(slab.data(), (s1 - s0) * n));
+      }
+    }
+  }
+}
+
+} // namespace
+
+// NOTE: the targets are taken by value as planet::eph() is not const.
+dv_matrix_result dv_matrix(std::vector<planet> targets,
+                           std::span<const double> t_dep,
+                           std::span<const double> tof, bool cw,
+                           unsigned multi_revs, lambert_accuracy accuracy) {
+  const double mu = targets_mu(targets, "dv_matrix");
+  dv_matrix_result res;
+  res.n_dep = t_dep.size();
+  res.n_tof = tof.size();
+  res.n_targets = targets.size();
+  res.dv.reserve(res.n_dep * res.n_tof * res.n_targets * res.n_targets);
+  dv_matrix_impl(targets, mu, t_dep, tof, cw, multi_revs, accuracy,
+                 [&res](std::span<const double> rows) {
+                   res.dv.insert(res.dv.end(), rows.begin(), rows.end());
+                 });
+  return res;
+}
+
+void dv_matrix_save_npy(std::vector<planet> targets,
+                        std::span<const double> t_dep,
+                        std::span<const double> tof,
+                        const std::string &filename, bool cw,
+                        unsigned multi_revs, lambert_accuracy accuracy) {
+  const double mu = targets_mu(targets, "dv_matrix_save_npy");
+  std::ofstream file(filename, std::ios::binary);
+  if (!file) {
+    throw std::runtime_error(fmt::format(
+        "dv_matrix_save_npy: Could not open the file {}", filename));
+  }
+  detail::npy_write_header(
+      file, {t_dep.size(), tof.size(), targets.size(), targets.size()});
+  dv_matrix_impl(targets, mu, t_dep, tof, cw, multi_revs, accuracy,
+                 [&](std::span<const double> rows) {
+                   detail::npy_write_data(file, rows);
+                   if (!file) {
+                     throw std::runtime_error(fmt::format(
+                         "dv_matrix_save_npy: Could not write the file {}",
+                         filename));
+                   }
+                 });
+}
+
+} // namespace kep3
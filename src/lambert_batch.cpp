@@ -0,0 +1,295 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+
+#include <kep3/detail/lambert_kernels.hpp>
+#include <kep3/detail/lambert_lanes.hpp>
+#include <kep3/detail/lambert_setup.hpp>
+#include <kep3/lambert_batch.hpp>
+#include <kep3/lambert_solve.hpp>
+
+namespace kep3 {
+
+namespace {
+
+bool output_sizes_ok(const lambert_batch_output &out, std::size_t n) {
+  return out.v1x.size() == n && out.v1y.size() == n && out.v1z.size() == n &&
+         out.v2x.size() == n && out.v2y.size() == n && out.v2z.size() == n &&
+         out.status.size() == n && (out.x.empty() || out.x.size() == n) &&
+         (out.iters.empty() || out.iters.size() == n);
+}
+
+void check_sizes(const lambert_batch_input &in,
+                 const lambert_batch_output &out) {
+  const std::size_t n = in.r1x.size();
+  const bool sizes_ok =
+      in.r1y.size() == n && in.r1z.size() == n && in.r2x.size() == n &&
+      in.r2y.size() == n && in.r2z.size() == n && in.tof.size() == n &&
+      (in.mu.size() == n || in.mu.size() == 1u) && output_sizes_ok(out, n);
+  if (!sizes_ok) {
+    throw std::invalid_argument(
+        "lambert_batch: inconsistent sizes of the input/output spans.");
+  }
+}
+
+// Writes the solution of the i-th problem.
+void write_solution(const lambert_batch_output &out, std::size_t i,
+                    lambert_status status, double x, unsigned iters,
+                    const std::array<double, 3> &v1,
+                    const std::array<double, 3> &v2) {
+  constexpr double nan = std::numeric_limits<double>::quiet_NaN();
+  const bool ok = status == lambert_status::success;
+  out.v1x[i] = ok ? v1[0] : nan;
+  out.v1y[i] = ok ? v1[1] : nan;
+  out.v1z[i] = ok ? v1[2] : nan;
+  out.v2x[i] = ok ? v2[0] : nan;
+  out.v2y[i] = ok ? v2[1] : nan;
+  out.v2z[i] = ok ? v2[2] : nan;
+  out.status[i] = status;
+  if (!out.x.empty()) {
+    out.x[i] = x;
+  }
+  if (!out.iters.empty()) {
+    out.iters[i] = iters;
+  }
+}
+
+// Zero revolutions solver working on W problems at once.
+template <std::size_t W>
+void lambert_batch_zero_rev_lanes(const lambert_batch_input &in,
+                                  const lambert_batch_output &out, bool cw,
+                                  const detail::lambert_tolerances &tol) {
+  const std::size_t n = in.r1x.size();
+  const std::size_t mu_stride = (in.mu.size() == 1u) ? 0u : 1u;
+
+  std::array<detail::lambert_geometry, W> geo{};
+  std::array<lambert_status, W> status{};
+  detail::lambert_lanes<W> lambda{}, T{}, x{}, eps{};
+  detail::lambert_ulanes<W> iters{};
+  const detail::lambert_ulanes<W> N{};
+  detail::lambert_mask<W> active{}, converged{};
+  eps.fill(tol.eps_zero_rev);
+  std::array<double, 3> v1{}, v2{};
+
+  for (std::size_t base = 0u; base < n; base += W) {
+    const std::size_t n_lanes = std::min(W, n - base);
+    // 1 - Geometry and initial guesses. Unused or invalid lanes are given
+    // a harmless problem and are excluded from the iterations.
+    for (std::size_t k = 0u; k < W; ++k) {
+      const std::size_t i = base + k;
+      status[k] = (k < n_lanes)
+                      ? detail::lambert_setup(
+                            geo[k], {in.r1x[i], in.r1y[i], in.r1z[i]},
+                            {in.r2x[i], in.r2y[i], in.r2z[i]}, in.tof[i],
+                            in.mu[i * mu_stride], cw, T[k])
+                      : lambert_status::invalid_tof;
+      active[k] = status[k] == lambert_status::success;
+      lambda[k] = active[k] ? geo[k].lambda : 0.;
+      T[k] = active[k] ? T[k] : 1.;
+      x[k] = detail::lambert_x0_guess(T[k], lambda[k]);
+    }
+    // 2 - Householder iterations in lockstep.
+    detail::lambert_householder_lanes(T, x, N, eps, tol.iter_max, lambda,
+                                      active, iters, converged,
+                                      tol.hypergeometric_tol);
+    // 3 - Terminal velocities.
+    for (std::size_t k = 0u; k < n_lanes; ++k) {
+      const std::size_t i = base + k;
+      if (status[k] == lambert_status::success) {
+        if (!converged[k] || !std::isfinite(x[k])) {
+          status[k] = lambert_status::not_converged;
+        } else {
+          detail::lambert_velocities(geo[k], x[k], in.mu[i * mu_stride], v1,
+                                     v2);
+        }
+      }
+      write_solution(out, i, status[k],
+                     active[k] ? x[k]
+                               : std::numeric_limits<double>::quiet_NaN(),
+                     active[k] ? iters[k] : 0u, v1, v2);
+    }
+  }
+}
+
+} // namespace
+
+void lambert_batch(const lambert_batch_input &in,
+                   const lambert_batch_output &out, bool cw,
+                   lambert_branch branch, lambert_accuracy accuracy) {
+  check_sizes(in, out);
+  const std::size_t n = in.r1x.size();
+  const std::size_t mu_stride = (in.mu.size() == 1u) ? 0u : 1u;
+
+  for (std::size_t i = 0u; i < n; ++i) {
+    const auto sol = lambert_solve({in.r1x[i], in.r1y[i], in.r1z[i]},
+                                   {in.r2x[i], in.r2y[i], in.r2z[i]}, in.tof[i],
+                                   in.mu[i * mu_stride], cw, branch, accuracy);
+    write_solution(out, i, sol.status, sol.x, sol.iters, sol.v1, sol.v2);
+  }
+}
+
+void lambert_batch_lanes(const lambert_batch_input &in,
+                         const lambert_batch_output &out, bool cw,
+                         unsigned lanes, lambert_accuracy accuracy) {
+  check_sizes(in, out);
+  const auto tol = detail::lambert_tolerances_of(accuracy);
+  switch (lanes) {
+  case 4u:
+    lambert_batch_zero_rev_lanes<4>(in, out, cw, tol);
+    break;
+  case 8u:
+    lambert_batch_zero_rev_lanes<8>(in, out, cw, tol);
+    break;
+  default:
+    throw std::invalid_argument(
+        "lambert_batch_lanes: the number of lanes must be either 4 or 8.");
+  }
+}
+
+void lambert_sweep(const std::array<double, 3> &r1,
+                   const std::array<double, 3> &r2,
+                   std::span<const double> tof, double mu,
+                   const lambert_batch_output &out, bool cw,
+                   lambert_branch branch, lambert_accuracy accuracy) {
+  const std::size_t n = tof.size();
+  if (!output_sizes_ok(out, n)) {
+    throw std::invalid_argument(
+        "lambert_sweep: inconsistent sizes of the input/output spans.");
+  }
+  constexpr double nan = std::numeric_limits<double>::quiet_NaN();
+
+  // 1 - The geometry is shared by all problems. It does not depend on the
+  // time of flight, so that it is set up with a unit one.
+  detail::lambert_geometry geo{};
+  double T_unit = 0.;
+  const auto geo_status =
+      detail::lambert_setup(geo, r1, r2, 1., mu, cw, T_unit);
+  const auto tol = detail::lambert_tolerances_of(accuracy);
+  // The branch with N > 0 revolutions exists for T >= T_min, which also
+  // depends only on the geometry.
+  double T_min = 0.;
+  if (geo_status == lambert_status::success && branch.N > 0u) {
+    T_min = detail::lambert_T_min(geo.lambda, branch.N);
+  }
+
+  // 2 - Continuation along tof. x_prev and T_prev are the previous converged
+  // solution (NaN when there is none).
+  double x_prev = nan, T_prev = nan;
+  std::array<double, 3> v1{}, v2{};
+  for (std::size_t i = 0u; i < n; ++i) {
+    lambert_status status = geo_status;
+    if (status == lambert_status::success) {
+      status = detail::lambert_check_inputs(tof[i], mu);
+    }
+    const double T = detail::lambert_T(geo, tof[i], mu);
+    if (status == lambert_status::success && T < T_min) {
+      status = lambert_status::no_solution;
+    }
+    if (status != lambert_status::success) {
+      write_solution(out, i, status, nan, 0u, v1, v2);
+      if (status == lambert_status::no_solution) {
+        x_prev = nan;
+      }
+      continue;
+    }
+    // Initial guess: second order predictor from the previous solution
+    // (inverting the Taylor expansion of T(x) around x_prev), falling
+    // back to the generic guesses when there is none or when the predictor
+    // leaves the domain of the branch.
+    double x = nan;
+    double DT = 0.0, DDT = 0.0, DDDT = 0.0;
+    if (!std::isnan(x_prev)) {
+      detail::lambert_dTdx(DT, DDT, DDDT, x_prev, T_prev, geo.lambda);
+      const double dT = T - T_prev;
+      x = x_prev + dT / DT - DDT * dT * dT / (2. * DT * DT * DT);
+    }
+    detail::lambert_iterations its{};
+    bool warm = std::isfinite(x) && x > -1. && (branch.N == 0u || x < 1.);
+    if (warm) {
+      its = detail::lambert_householder(T, x, branch.N, tol.eps(branch.N),
+                                        tol.iter_max, geo.lambda,
+                                        tol.hypergeometric_tol);
+      warm = std::isfinite(x) && its.converged;
+      // With N > 0 the predictor may have crossed the minimum of T(x) and
+      // converged to the other branch: dT/dx is negative on the left branch
+      // and positive on the right one.
+      if (warm && branch.N > 0u) {
+        detail::lambert_dTdx(DT, DDT, DDDT, x, T, geo.lambda);
+        warm = (DT > 0.) == branch.right;
+      }
+    }
+    if (!warm) {
+      its = detail::lambert_solve_branch(T, geo.lambda, branch.N, branch.right,
+                                         x, false, tol);
+    }
+    if (!its.converged || !std::isfinite(x)) {
+      write_solution(out, i, lambert_status::not_converged, x, its.iters, v1,
+                     v2);
+      x_prev = nan;
+      continue;
+    }
+    detail::lambert_velocities(geo, x, mu, v1, v2);
+    write_solution(out, i, lambert_status::success, x, its.iters, v1, v2);
+    x_prev = x;
+    T_prev = T;
+  }
+}
+
+void lambert_one_to_many(const std::array<double, 3> &r1,
+                         std::span<const double> r2x,
+                         std::span<const double> r2y,
+                         std::span<const double> r2z,
+                         std::span<const double> tof, double mu,
+                         const lambert_batch_output &out, bool cw,
+                         lambert_branch branch, lambert_accuracy accuracy) {
+  const std::size_t n = r2x.size();
+  if (r2y.size() != n || r2z.size() != n ||
+      (tof.size() != n && tof.size() != 1u) || !output_sizes_ok(out, n)) {
+    throw std::invalid_argument(
+        "lambert_one_to_many: inconsistent sizes of the input/output spans.");
+  }
+  constexpr double nan = std::numeric_limits<double>::quiet_NaN();
+  const std::size_t tof_stride = (tof.size() == 1u) ? 0u : 1u;
+  const auto tol = detail::lambert_tolerances_of(accuracy);
+
+  // The departure part of the geometry is shared by all problems.
+  detail::lambert_geometry geo_r1{};
+  detail::lambert_geometry_set_r1(geo_r1, r1);
+
+  detail::lambert_geometry geo{};
+  std::array<double, 3> v1{}, v2{};
+  for (std::size_t i = 0u; i < n; ++i) {
+    double x = nan, T = 0.;
+    detail::lambert_iterations its{};
+    geo = geo_r1;
+    lambert_status status = detail::lambert_setup_r2(
+        geo, r1, {r2x[i], r2y[i], r2z[i]}, tof[i * tof_stride], mu, cw, T);
+    if (status == lambert_status::success) {
+      status = detail::lambert_branch_status(T, geo.lambda, branch.N);
+    }
+    if (status == lambert_status::success) {
+      its = detail::lambert_solve_branch(T, geo.lambda, branch.N, branch.right,
+                                         x, false, tol);
+      if (!its.converged || !std::isfinite(x)) {
+        status = lambert_status::not_converged;
+      } else {
+        detail::lambert_velocities(geo, x, mu, v1, v2);
+      }
+    }
+    write_solution(out, i, status, x, its.iters, v1, v2);
+  }
+}
+
+} // namespace kep3
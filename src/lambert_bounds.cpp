@@ -0,0 +1,131 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+
+#include <fmt/core.h>
+
+#include <kep3/detail/lambert_kernels.hpp>
+#include <kep3/lambert_bounds.hpp>
+
+namespace kep3 {
+
+namespace {
+
+// Checks the inputs and computes the geometry of the problem.
+detail::lambert_geometry bounds_geometry(const std::array<double, 3> &r1,
+                                         const std::array<double, 3> &r2,
+                                         double mu, bool cw,
+                                         const char *name) {
+  // NOTE: the negated comparison also catches NaNs.
+  if (!(mu > 0)) {
+    throw std::domain_error(
+        fmt::format("{}: Gravity parameter is zero or negative!", name));
+  }
+  detail::lambert_geometry geo{};
+  if (!detail::lambert_geometry_init(geo, r1, r2, cw)) {
+    throw std::domain_error(fmt::format(
+        "{}: The angular momentum vector has no z component, impossible to "
+        "define automatically clock or counterclockwise",
+        name));
+  }
+  return geo;
+}
+
+void check_tof(double tof, const char *name) {
+  if (!(tof >= 0)) {
+    throw std::domain_error(
+        fmt::format("{}: Time of flight is negative!", name));
+  }
+}
+
+// Dimensional time of flight corresponding to the non dimensional one.
+double dimensional_tof(const detail::lambert_geometry &geo, double T,
+                       double mu) {
+  return T * std::sqrt(geo.s * geo.s * geo.s / (2. * mu));
+}
+
+} // namespace
+
+double lambert_tof_parabolic(const std::array<double, 3> &r1,
+                             const std::array<double, 3> &r2, double mu,
+                             bool cw) {
+  auto geo = bounds_geometry(r1, r2, mu, cw, "lambert_tof_parabolic");
+  const double lambda = geo.lambda;
+  return dimensional_tof(geo, 2.0 / 3.0 * (1.0 - lambda * lambda * lambda),
+                         mu);
+}
+
+double lambert_tof_min_energy(const std::array<double, 3> &r1,
+                              const std::array<double, 3> &r2, double mu,
+                              bool cw, unsigned N) {
+  auto geo = bounds_geometry(r1, r2, mu, cw, "lambert_tof_min_energy");
+  return dimensional_tof(geo, detail::lambert_T00(geo.lambda) + N * kep3::pi,
+                         mu);
+}
+
+double lambert_tof_min(const std::array<double, 3> &r1,
+                       const std::array<double, 3> &r2, double mu, bool cw,
+                       unsigned N) {
+  auto geo = bounds_geometry(r1, r2, mu, cw, "lambert_tof_min");
+  if (N == 0u) {
+    return 0.;
+  }
+  return dimensional_tof(geo, detail::lambert_T_min(geo.lambda, N), mu);
+}
+
+unsigned lambert_Nmax(const std::array<double, 3> &r1,
+                      const std::array<double, 3> &r2, double tof, double mu,
+                      bool cw, unsigned multi_revs) {
+  check_tof(tof, "lambert_Nmax");
+  auto geo = bounds_geometry(r1, r2, mu, cw, "lambert_Nmax");
+  return detail::lambert_Nmax(detail::lambert_T(geo, tof, mu), geo.lambda,
+                              multi_revs);
+}
+
+double lambert_dv_lower_bound(const std::array<double, 3> &r1,
+                              const std::array<double, 3> &r2, double tof,
+                              double mu, const std::array<double, 3> &v_dep,
+                              const std::array<double, 3> &v_arr, bool cw,
+                              unsigned multi_revs) {
+  check_tof(tof, "lambert_dv_lower_bound");
+  auto geo = bounds_geometry(r1, r2, mu, cw, "lambert_dv_lower_bound");
+  const double T = detail::lambert_T(geo, tof, mu);
+  const unsigned Nmax = detail::lambert_Nmax(T, geo.lambda, multi_revs);
+
+  // 1 - Zero revolutions: as T(x) is decreasing, T >= T00 means x in (-1, 0]
+  // and T1 <= T < T00 means x in (0, 1], while hyperbolic solutions (x > 1)
+  // are not bounded. In the elliptic case tof < P also bounds |x| from below.
+  double xl = 0., xm = 0.;
+  detail::lambert_x_abs_range(geo, tof, mu, 0u, xl, xm);
+  double xa = 1., xb = 0.;
+  if (T >= detail::lambert_T00(geo.lambda)) {
+    xa = -1.;
+    xb = -xl;
+  } else if (T >= 2.0 / 3.0 * (1.0 - geo.lambda * geo.lambda * geo.lambda)) {
+    xa = xl;
+    xb = 1.;
+  }
+  double retval = detail::lambert_dv_lower_bound(geo, mu, xa, xb, v_dep, v_arr);
+
+  // 2 - Multiple revolutions, left (x < 0) and right (x > 0) branches.
+  for (unsigned N = 1u; N <= Nmax; ++N) {
+    detail::lambert_x_abs_range(geo, tof, mu, N, xl, xm);
+    retval = std::min(
+        {retval,
+         detail::lambert_dv_lower_bound(geo, mu, -xm, -xl, v_dep, v_arr),
+         detail::lambert_dv_lower_bound(geo, mu, xl, xm, v_dep, v_arr)});
+  }
+  return retval;
+}
+
+} // namespace kep3
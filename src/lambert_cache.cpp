@@ -0,0 +1,233 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include <kep3/lambert_cache.hpp>
+#include <kep3/lambert_problem.hpp>
+
+namespace kep3 {
+
+namespace {
+
+// The quantized inputs: exponent and quantized mantissa of r1, r2, tof and
+// mu, then cw, multi_revs and the options.
+using cache_key = std::array<std::int64_t, 19>;
+
+struct cache_key_hash {
+  std::size_t operator()(const cache_key &key) const {
+    std::size_t seed = 0u;
+    for (const auto k : key) {
+      seed ^= std::hash<std::int64_t>{}(k) + 0x9e3779b9u + (seed << 6u) +
+              (seed >> 2u);
+    }
+    return seed;
+  }
+};
+
+// Writes x as (exponent, mantissa rounded to a multiple of rel_tol) in
+// out[0] and out[1]. Zero, non finite values and a zero rel_tol are stored
+// exactly.
+void quantize(double x, double rel_tol, std::int64_t *out) {
+  if (rel_tol == 0. || x == 0. || !std::isfinite(x)) {
+    out[0] = 0;
+    out[1] = std::bit_cast<std::int64_t>(x);
+    return;
+  }
+  int e = 0;
+  const double m = std::frexp(x, &e);
+  auto q = std::llround(m / rel_tol);
+  // NOTE: the mantissa is in [0.5, 1) in absolute value. When it is rounded
+  // up to one, x is stored as the next power of two, whose mantissa is 0.5,
+  // so that the values just below a power of two share its key.
+  if (std::llabs(q) == std::llround(1. / rel_tol)) {
+    ++e;
+    q = std::llround(std::copysign(0.5, m) / rel_tol);
+  }
+  out[0] = e;
+  out[1] = q;
+}
+
+struct cache_shard {
+  std::mutex mutex;
+  // Most recently used entries first.
+  std::list<std::pair<cache_key, lambert_problem>> entries;
+  std::unordered_map<cache_key, decltype(entries)::iterator, cache_key_hash>
+      index;
+  unsigned long long hits = 0u;
+  unsigned long long misses = 0u;
+};
+
+} // namespace
+
+struct lambert_cache::impl {
+  std::size_t capacity;
+  std::size_t shard_capacity;
+  double rel_tol;
+  std::vector<cache_shard> shards;
+
+  impl(std::size_t cap, double tol, unsigned n_shards)
+      : capacity(cap), rel_tol(tol),
+        shards(std::min(static_cast<std::size_t>(n_shards), cap)) {
+    shard_capacity = capacity / shards.size();
+  }
+};
+
+lambert_cache::lambert_cache(std::size_t capacity, double rel_tol,
+                             unsigned n_shards) {
+  if (capacity == 0u || n_shards == 0u) {
+    throw std::invalid_argument(fmt::format(
+        "lambert_cache: The capacity and the number of shards must be "
+        "positive, but {} and {} were given",
+        capacity, n_shards));
+  }
+  // NOTE: the negated comparison also catches NaNs.
+  if (rel_tol != 0. && !(rel_tol >= 1e-15 && rel_tol < 1.)) {
+    throw std::invalid_argument(fmt::format(
+        "lambert_cache: The relative tolerance must be zero or in [1e-15, 1), "
+        "but {} was given",
+        rel_tol));
+  }
+  m_impl = std::make_unique<impl>(capacity, rel_tol, n_shards);
+}
+
+lambert_cache::lambert_cache(lambert_cache &&) noexcept = default;
+lambert_cache &lambert_cache::operator=(lambert_cache &&) noexcept = default;
+lambert_cache::~lambert_cache() = default;
+
+bool lambert_cache::is_valid() const { return static_cast<bool>(m_impl); }
+
+lambert_cache::impl &lambert_cache::get_impl() const {
+  if (!m_impl) {
+    throw std::logic_error(
+        "lambert_cache: The cache has been moved from and cannot be used");
+  }
+  return *m_impl;
+}
+
+lambert_problem lambert_cache::get(const std::array<double, 3> &r1,
+                                   const std::array<double, 3> &r2,
+                                   double tof, double mu, bool cw,
+                                   unsigned multi_revs,
+                                   const lambert_options &options) {
+  auto &d = get_impl();
+  cache_key key{};
+  for (std::size_t i = 0u; i < 3u; ++i) {
+    quantize(r1[i], d.rel_tol, &key[2u * i]);
+    quantize(r2[i], d.rel_tol, &key[6u + 2u * i]);
+  }
+  quantize(tof, d.rel_tol, &key[12]);
+  quantize(mu, d.rel_tol, &key[14]);
+  key[16] = cw ? 1 : 0;
+  key[17] = multi_revs;
+  key[18] = (options.sensitivities ? 1 : 0) |
+            (options.tabulated_guess ? 2 : 0) |
+            (static_cast<std::int64_t>(options.accuracy) << 2);
+  const std::size_t h = cache_key_hash{}(key);
+  auto &shard = d.shards[h % d.shards.size()];
+
+  {
+    const std::lock_guard<std::mutex> lock(shard.mutex);
+    const auto it = shard.index.find(key);
+    if (it != shard.index.end()) {
+      ++shard.hits;
+      shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+      return it->second->second;
+    }
+    ++shard.misses;
+  }
+
+  // NOTE: the problem is solved without holding the lock, so that other
+  // threads can use the shard meanwhile. If the same key is inserted by
+  // another thread in the meantime, its entry is kept.
+  lambert_problem lp(r1, r2, tof, mu, cw, multi_revs, options);
+  const std::lock_guard<std::mutex> lock(shard.mutex);
+  if (!shard.index.contains(key)) {
+    shard.entries.emplace_front(key, lp);
+    shard.index.emplace(key, shard.entries.begin());
+    if (shard.entries.size() > d.shard_capacity) {
+      shard.index.erase(shard.entries.back().first);
+      shard.entries.pop_back();
+    }
+  }
+  return lp;
+}
+
+std::size_t lambert_cache::get_capacity() const { return get_impl().capacity; }
+
+double lambert_cache::get_rel_tol() const { return get_impl().rel_tol; }
+
+std::size_t lambert_cache::size() const {
+  std::size_t retval = 0u;
+  for (auto &shard : get_impl().shards) {
+    const std::lock_guard<std::mutex> lock(shard.mutex);
+    retval += shard.entries.size();
+  }
+  return retval;
+}
+
+unsigned long long lambert_cache::get_hits() const {
+  unsigned long long retval = 0u;
+  for (auto &shard : get_impl().shards) {
+    const std::lock_guard<std::mutex> lock(shard.mutex);
+    retval += shard.hits;
+  }
+  return retval;
+}
+
+unsigned long long lambert_cache::get_misses() const {
+  unsigned long long retval = 0u;
+  for (auto &shard : get_impl().shards) {
+    const std::lock_guard<std::mutex> lock(shard.mutex);
+    retval += shard.misses;
+  }
+  return retval;
+}
+
+double lambert_cache::get_hit_rate() const {
+  const auto hits = get_hits();
+  const auto total = hits + get_misses();
+  return (total == 0u) ? 0.
+                       : static_cast<double>(hits) /
+                             static_cast<double>(total);
+}
+
+void lambert_cache::clear() {
+  for (auto &shard : get_impl().shards) {
+    const std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.entries.clear();
+    shard.index.clear();
+  }
+}
+
+void lambert_cache::reset_counters() {
+  for (auto &shard : get_impl().shards) {
+    const std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.hits = 0u;
+    shard.misses = 0u;
+  }
+}
+
+} // namespace kep3
@@ -7,24 +7,31 @@
 // Public License v. 2.0. If a copy of the MPL was not distributed
 // with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
 
+#include <algorithm>
 #include <array>
 #include <cmath>
+#include <cstddef>
+#include <span>
+#include <vector>
 
 #include <fmt/core.h>
 #include <fmt/ranges.h>
-#include <xtensor-blas/xlinalg.hpp>
-#include <xtensor/xadapt.hpp>
 
+#include <kep3/detail/lambert_kernels.hpp>
+#include <kep3/detail/lambert_lanes.hpp>
 #include <kep3/exceptions.hpp>
 #include <kep3/lambert_problem.hpp>
 
 namespace kep3 {
 
-using xt::linalg::cross;
-
 const std::array<double, 3> lambert_problem::default_r1 = {{1.0, 0.0, 0.0}};
 const std::array<double, 3> lambert_problem::default_r2 = {{0.0, 1.0, 0.0}};
 
+namespace {
+// Number of revolution branches solved at once by the constructor.
+constexpr std::size_t lanes = 4u;
+} // namespace
+
 /// Constructor
 /** Constructs and solves a Lambert problem.
  *
@@ -34,11 +41,14 @@ const std::array<double, 3> lambert_problem::default_r2 = {{0.0, 1.0, 0.0}};
  * \param[in] mu gravity parameter
  * \param[in] cw when true a retrograde orbit is assumed
  * \param[in] multi_revs maximum number of multirevolutions to compute
+ * \param[in] options the sensitivities, the initial guesses and the accuracy
+ * profile (see kep3::lambert_options)
  */
 lambert_problem::lambert_problem(const std::array<double, 3> &r1_a,
                                  const std::array<double, 3> &r2_a,
                                  double tof, // NOLINT
-                                 double mu, bool cw, unsigned multi_revs)
+                                 double mu, bool cw, unsigned multi_revs,
+                                 const lambert_options &options)
     : m_r1(r1_a), m_r2(r2_a), m_tof(tof), m_mu(mu), m_has_converged(true),
       m_multi_revs(multi_revs) {
   // 0 - Sanity checks
@@ -50,86 +60,23 @@ lambert_problem::lambert_problem(const std::array<double, 3> &r1_a,
         "lambert_problem: Gravity parameter is zero or negative!");
   }
 
-  // Creating xtensor objects binded to the kep3 arrays
-  const auto r1 = xt::adapt(r1_a);
-  const auto r2 = xt::adapt(r2_a);
-
   // 1 - Getting lambda and T
-  m_c = xt::linalg::norm(r2 - r1);
-
-  double R1 = xt::linalg::norm(r1);
-  double R2 = xt::linalg::norm(r2);
-  m_s = (m_c + R1 + R2) / 2.0;
-
-  auto ir1 = r1 / R1;
-  auto ir2 = r2 / R2;
-  auto ih = cross(ir1, ir2);
-  ih = ih / xt::linalg::norm(ih);
-
-  if (ih(2) == 0) {
+  detail::lambert_geometry geo{};
+  if (!detail::lambert_geometry_init(geo, r1_a, r2_a, cw)) {
     throw std::domain_error(
         "lambert_problem: The angular momentum vector has no z component, "
         "impossible to define automatically clock or "
         "counterclockwise");
   }
-  double lambda2 = 1.0 - m_c / m_s;
-  m_lambda = std::sqrt(lambda2);
-
-  auto it1 = cross(ih, ir1);
-  auto it2 = cross(ih, ir2);
-  it1 = it1 / xt::linalg::norm(it1);
-  it2 = it2 / xt::linalg::norm(it2);
-
-  if (ih(2) < 0.0) // Transfer angle is larger than 180 degrees as seen from
-                   // above the z axis
-  {
-    m_lambda = -m_lambda;
-    it1 = -it1;
-    it2 = -it2;
-  }
-  if (cw) { // Retrograde motion
-    m_lambda = -m_lambda;
-    it1 = -it1;
-    it2 = -it2;
-  }
-  double lambda3 = m_lambda * lambda2;
-  double T = std::sqrt(2.0 * m_mu / m_s / m_s / m_s) * m_tof;
+  m_c = geo.c;
+  m_s = geo.s;
+  m_lambda = geo.lambda;
+  double T = detail::lambert_T(geo, m_tof, m_mu);
 
   // 2 - We now have lambda, T and we will find all x
   // 2.1 - Let us first detect the maximum number of revolutions for which there
   // exists a solution
-  m_Nmax = static_cast<unsigned>(T / kep3::pi);
-  m_Nmax = std::min(m_multi_revs, m_Nmax);
-  double T00 = std::acos(m_lambda) + m_lambda * std::sqrt(1.0 - lambda2);
-  double T0 = (T00 + m_Nmax * kep3::pi);
-  double T1 = 2.0 / 3.0 * (1.0 - lambda3), DT = 0.0, DDT = 0.0, DDDT = 0.0;
-  if (m_Nmax > 0) {
-    if (T < T0) { // We use Halley iterations to find xM and TM
-      int it = 0;
-      double err = 1.0;
-      double T_min = T0;
-      double x_old = 0.0, x_new = 0.0;
-      while (true) {
-        dTdx(DT, DDT, DDDT, x_old, T_min);
-        if (DT != 0.0) {
-          x_new = x_old - DT * DDT / (DDT * DDT - DT * DDDT / 2.0);
-        }
-        err = std::abs(x_old - x_new);
-        if ((err < 1e-13) || (it > 12)) {
-          break;
-        }
-        x2tof(T_min, x_new, m_Nmax);
-        x_old = x_new;
-        it++;
-      }
-      if (T_min > T) {
-        m_Nmax -= 1;
-      }
-    }
-    // We exit this if clause with Nmax being the maximum number of revolutions
-    // for which there exists a solution. We crop it to m_multi_revs
-    m_Nmax = std::min(m_multi_revs, m_Nmax);
-  }
+  m_Nmax = detail::lambert_Nmax(T, m_lambda, m_multi_revs);
 
   // 2.2 We now allocate the memory for the output variables
   m_v1.resize(static_cast<size_t>(m_Nmax) * 2 + 1);
@@ -137,190 +84,90 @@ lambert_problem::lambert_problem(const std::array<double, 3> &r1_a,
   m_iters.resize(static_cast<size_t>(m_Nmax) * 2 + 1);
   m_x.resize(static_cast<size_t>(m_Nmax) * 2 + 1);
 
-  // 3 - We may now find all solutions in x,y
-  // 3.1 0 rev solution
-  // 3.1.1 initial guess
-  if (T >= T00) {
-    m_x[0] = -(T - T00) / (T - T00 + 4);
-  } else if (T <= T1) {
-    m_x[0] = T1 * (T1 - T) / (2.0 / 5.0 * (1 - lambda2 * lambda3) * T) + 1;
-  } else {
-    m_x[0] =
-        std::pow((T / T00), 0.69314718055994529 / std::log(T1 / T00)) - 1.0;
-  }
-  // 3.1.2 Householder iterations
-  m_iters[0] = householder(T, m_x[0], 0, 1e-5, 15);
-  // 3.2 multi rev solutions
-  double tmp = 0.;
-  for (std::vector<double>::size_type i = 1u; i < m_Nmax + 1; ++i) {
-    // 3.2.1 left Householder iterations
-    tmp = std::pow((static_cast<double>(i) * kep3::pi + kep3::pi) / (8.0 * T),
-                   2.0 / 3.0);
-    m_x[2 * i - 1] = (tmp - 1) / (tmp + 1);
-    m_iters[2 * i - 1] =
-        householder(T, m_x[2 * i - 1], static_cast<unsigned>(i), 1e-8, 15);
-    // 3.2.1 right Householder iterations
-    tmp = std::pow((8.0 * T) / (static_cast<double>(i) * kep3::pi), 2.0 / 3.0);
-    m_x[2 * i] = (tmp - 1) / (tmp + 1);
-    m_iters[2ul * i] =
-        householder(T, m_x[2 * i], static_cast<unsigned>(i), 1e-8, 15);
-  }
-
-  // 4 - For each found x value we reconstruct the terminal velocities
-  double gamma = std::sqrt(m_mu * m_s / 2.0);
-  double rho = (R1 - R2) / m_c;
-  double sigma = std::sqrt(1 - rho * rho);
-  double vr1 = 0., vt1 = 0., vr2 = 0., vt2 = 0., y = 0.;
-  for (size_t i = 0; i < m_x.size(); ++i) {
-    y = std::sqrt(1.0 - lambda2 + lambda2 * m_x[i] * m_x[i]);
-    vr1 =
-        gamma * ((m_lambda * y - m_x[i]) - rho * (m_lambda * y + m_x[i])) / R1;
-    vr2 =
-        -gamma * ((m_lambda * y - m_x[i]) + rho * (m_lambda * y + m_x[i])) / R2;
-    double vt = gamma * sigma * (y + m_lambda * m_x[i]);
-    vt1 = vt / R1;
-    vt2 = vt / R2;
-    for (auto j = 0lu; j < 3lu; ++j) {
-      m_v1[i][j] = vr1 * ir1[j] + vt1 * it1[j];
-    }
-    for (auto j = 0lu; j < 3lu; ++j) {
-      m_v2[i][j] = vr2 * ir2[j] + vt2 * it2[j];
+  // 3 - We may now find all solutions in x,y. The branches share lambda and
+  // T: their Householder iterations are run in lockstep, lanes at a time, one
+  // branch per lane (0 revs, then left and right for 1, 2, ... revs).
+  const auto tol = detail::lambert_tolerances_of(options.accuracy);
+  const std::size_t n_sol = m_x.size();
+  detail::lambert_lanes<lanes> T_l{}, lambda_l{}, x_l{}, eps_l{};
+  detail::lambert_ulanes<lanes> N_l{}, iters_l{};
+  detail::lambert_mask<lanes> active{}, converged_l{};
+  T_l.fill(T);
+  lambda_l.fill(m_lambda);
+  for (std::size_t base = 0u; base < n_sol; base += lanes) {
+    const std::size_t n_lanes = std::min(lanes, n_sol - base);
+    if (n_lanes == 1u) {
+      // 3.1 - A single branch left (e.g. 0 revs only), solved on its own
+      const auto N = static_cast<unsigned>((base + 1u) / 2u);
+      const auto its = detail::lambert_solve_branch(
+          T, m_lambda, N, base > 0u && base % 2u == 0u, m_x[base],
+          options.tabulated_guess, tol);
+      m_iters[base] = its.iters;
+      m_has_converged =
+          m_has_converged && its.converged && std::isfinite(m_x[base]);
+      detail::lambert_velocities(geo, m_x[base], m_mu, m_v1[base],
+                                 m_v2[base]);
+      continue;
     }
-  }
-}
-
-unsigned lambert_problem::householder(double T, double &x0,
-                                      unsigned N, // NOLINT
-                                      double eps, unsigned iter_max) const {
-  unsigned it = 0;
-  double err = 1.0;
-  double xnew = 0.0;
-  double tof = 0.0, delta = 0.0, DT = 0.0, DDT = 0.0, DDDT = 0.0;
-  while ((err > eps) && (it < iter_max)) {
-    x2tof(tof, x0, N);
-    dTdx(DT, DDT, DDDT, x0, tof);
-    delta = tof - T;
-    double DT2 = DT * DT;
-    xnew = x0 - delta * (DT2 - delta * DDT / 2.0) /
-                    (DT * (DT2 - delta * DDT) + DDDT * delta * delta / 6.0);
-    err = std::abs(x0 - xnew);
-    x0 = xnew;
-    it++;
-  }
-  return it;
-}
-
-void lambert_problem::dTdx(double &DT, double &DDT, double &DDDT, double x,
-                           double T) const {
-  double l2 = m_lambda * m_lambda;
-  double l3 = l2 * m_lambda;
-  double umx2 = 1.0 - x * x;
-  double y = std::sqrt(1.0 - l2 * umx2);
-  double y2 = y * y;
-  double y3 = y2 * y;
-  DT = 1.0 / umx2 * (3.0 * T * x - 2.0 + 2.0 * l3 * x / y);
-  DDT = 1.0 / umx2 * (3.0 * T + 5.0 * x * DT + 2.0 * (1.0 - l2) * l3 / y3);
-  DDDT = 1.0 / umx2 *
-         (7.0 * x * DDT + 8.0 * DT - 6.0 * (1.0 - l2) * l2 * l3 * x / y3 / y2);
-}
-
-void lambert_problem::x2tof2(double &tof, double x, // NOLINT
-                             unsigned N) const {
-  double a = 1.0 / (1.0 - x * x);
-  if (a > 0) // ellipse
-  {
-    double alfa = 2.0 * std::acos(x);
-    double beta = 2.0 * std::asin(std::sqrt(m_lambda * m_lambda / a));
-    if (m_lambda < 0.0) {
-      beta = -beta;
+    // 3.2 - Initial guesses
+    for (std::size_t k = 0u; k < lanes; ++k) {
+      const std::size_t i = base + k;
+      active[k] = k < n_lanes;
+      N_l[k] = active[k] ? static_cast<unsigned>((i + 1u) / 2u) : 0u;
+      eps_l[k] = tol.eps(N_l[k]);
+      x_l[k] = detail::lambert_x0_guess_branch(T, m_lambda, N_l[k],
+                                               i > 0u && i % 2u == 0u,
+                                               options.tabulated_guess);
     }
-    tof = ((a * std::sqrt(a) *
-            ((alfa - std::sin(alfa)) - (beta - std::sin(beta)) +
-             2.0 * kep3::pi * N)) /
-           2.0);
-  } else {
-    double alfa = 2.0 * std::acosh(x);
-    double beta = 2.0 * std::asinh(std::sqrt(-m_lambda * m_lambda / a));
-    if (m_lambda < 0.0) {
-      beta = -beta;
+    // 3.3 - Householder iterations
+    detail::lambert_householder_lanes(T_l, x_l, N_l, eps_l, tol.iter_max,
+                                      lambda_l, active, iters_l, converged_l,
+                                      tol.hypergeometric_tol);
+    // 4 - For each found x value we reconstruct the terminal velocities
+    for (std::size_t k = 0u; k < n_lanes; ++k) {
+      const std::size_t i = base + k;
+      m_x[i] = x_l[k];
+      m_iters[i] = iters_l[k];
+      m_has_converged =
+          m_has_converged && converged_l[k] && std::isfinite(m_x[i]);
+      detail::lambert_velocities(geo, m_x[i], m_mu, m_v1[i], m_v2[i]);
     }
-    tof = (-a * std::sqrt(-a) *
-           ((beta - std::sinh(beta)) - (alfa - std::sinh(alfa))) / 2.0);
   }
-}
 
-void lambert_problem::x2tof(double &tof, double x, unsigned N) const {
-  double battin = 0.01;
-  double lagrange = 0.2;
-  double dist = std::abs(x - 1);
-  if (dist < lagrange && dist > battin) { // We use Lagrange tof expression
-    x2tof2(tof, x, N);
-    return;
-  }
-  double K = m_lambda * m_lambda;
-  double E = x * x - 1.0;
-  double rho = std::abs(E);
-  double z = std::sqrt(1 + K * E);
-  if (dist < battin) { // We use Battin series tof expression
-    double eta = z - m_lambda * x;
-    double S1 = 0.5 * (1.0 - m_lambda - x * eta);
-    double Q = hypergeometricF(S1, 1e-11);
-    Q = 4.0 / 3.0 * Q;
-    tof = (eta * eta * eta * Q + 4.0 * m_lambda * eta) / 2.0 +
-          N * kep3::pi / std::pow(rho, 1.5);
-    return;
-  } else { // We use Lancaster tof expresion
-    double y = std::sqrt(rho);
-    double g = x * z - m_lambda * E;
-    double d = 0.0;
-    if (E < 0) {
-      double l = std::acos(g);
-      d = N * kep3::pi + l;
-    } else {
-      double f = y * (z - m_lambda * x);
-      d = std::log(f + g);
+  // 5 - And, if requested, their sensitivities
+  if (options.sensitivities) {
+    m_dv1_dp.resize(m_x.size());
+    m_dv2_dp.resize(m_x.size());
+    for (size_t i = 0; i < m_x.size(); ++i) {
+      detail::lambert_sensitivities(m_r1, m_r2, m_tof, m_mu, cw, m_x[i],
+                                    static_cast<unsigned>((i + 1) / 2),
+                                    m_dv1_dp[i], m_dv2_dp[i]);
     }
-    tof = (x - m_lambda * z - d / y) / E;
-    return;
   }
 }
 
-double lambert_problem::hypergeometricF(double z, double tol) const { // NOLINT
-  double Sj = 1.0;
-  double Cj = 1.0;
-  double err = 1.0;
-  double Cj1 = 0.0;
-  double Sj1 = 0.0;
-  int j = 0;
-  while (err > tol) {
-    Cj1 = Cj * (3.0 + j) * (1.0 + j) / (2.5 + j) * z / (j + 1);
-    Sj1 = Sj + Cj1;
-    err = std::abs(Cj1);
-    Sj = Sj1;
-    Cj = Cj1;
-    j = j + 1;
-  }
-  return Sj;
-}
-
 /// Gets velocity at r1
 /**
+ * The solutions are copied in a new vector at each call: see get_v1_span()
+ * for a view that does not allocate.
  *
- * \return an std::vector containing 3-d arrays with the cartesian components of
- * the velocities at r1 for all 2N_max+1 solutions
+ * \return a vector containing 3-d arrays with the cartesian components of the
+ * velocities at r1 for all 2N_max+1 solutions
  */
-const std::vector<std::array<double, 3>> &lambert_problem::get_v1() const {
-  return m_v1;
+std::vector<std::array<double, 3>> lambert_problem::get_v1() const {
+  return {m_v1.begin(), m_v1.end()};
 }
 
 /// Gets velocity at r2
 /**
+ * The solutions are copied in a new vector at each call: see get_v2_span()
+ * for a view that does not allocate.
  *
- * \return an std::vector containing 3-d arrays with the cartesian components of
- * the velocities at r2 for all 2N_max+1 solutions
+ * \return a vector containing 3-d arrays with the cartesian components of the
+ * velocities at r2 for all 2N_max+1 solutions
  */
-const std::vector<std::array<double, 3>> &lambert_problem::get_v2() const {
-  return m_v2;
+std::vector<std::array<double, 3>> lambert_problem::get_v2() const {
+  return {m_v2.begin(), m_v2.end()};
 }
 
 /// Gets r1
@@ -346,11 +193,15 @@ const double &lambert_problem::get_tof() const { return m_tof; }
 
 /// Gets the x variable
 /**
- * Gets the x variable for each solution found (0 revs, 1,1,2,2,3,3 .... N,N)
+ * Gets the x variable for each solution found (0 revs, 1,1,2,2,3,3 .... N,N).
+ * They are copied in a new vector at each call: see get_x_span() for a view
+ * that does not allocate.
  *
- * \return the x variables in an std::vector
+ * \return the x variables in a vector
  */
-const std::vector<double> &lambert_problem::get_x() const { return m_x; }
+std::vector<double> lambert_problem::get_x() const {
+  return {m_x.begin(), m_x.end()};
+}
 
 /// Gets gravitational parameter
 /**
@@ -361,14 +212,52 @@ const double &lambert_problem::get_mu() const { return m_mu; }
 
 /// Gets number of iterations
 /**
+ * The iterations are copied in a new vector at each call: see
+ * get_iters_span() for a view that does not allocate.
+ *
+ * \return a vector containing the iterations taken to compute each one of the
+ * solutions
+ */
+std::vector<unsigned> lambert_problem::get_iters() const {
+  return {m_iters.begin(), m_iters.end()};
+}
+
+/// Gets views of the solutions
+/**
+ * As get_v1(), get_v2(), get_x() and get_iters(), but without copying the
+ * solutions out of the object (and thus without allocations).
  *
- * \return an std::vector containing the iterations taken to compute each one of
- * the solutions
+ * \return a view of the solutions, valid until the object is destroyed or
+ * assigned to
  */
-const std::vector<unsigned> &lambert_problem::get_iters() const {
-  return m_iters;
+std::span<const std::array<double, 3>> lambert_problem::get_v1_span() const {
+  return {m_v1.data(), m_v1.size()};
 }
 
+std::span<const std::array<double, 3>> lambert_problem::get_v2_span() const {
+  return {m_v2.data(), m_v2.size()};
+}
+
+std::span<const double> lambert_problem::get_x_span() const {
+  return {m_x.data(), m_x.size()};
+}
+
+std::span<const unsigned> lambert_problem::get_iters_span() const {
+  return {m_iters.data(), m_iters.size()};
+}
+
+/// Gets the convergence flag
+/**
+ * The Householder iterations of a solution may hit their maximum number
+ * (see kep3::lambert_accuracy) or diverge before meeting the convergence
+ * criterion, as reported by kep3::lambert_status::not_converged in
+ * kep3::lambert_solve(). The corresponding solutions are then inaccurate (or
+ * not finite).
+ *
+ * \return true if all the solutions have converged
+ */
+bool lambert_problem::get_converged() const { return m_has_converged; }
+
 /// Gets N_max
 /**
  *
@@ -377,6 +266,34 @@ const std::vector<unsigned> &lambert_problem::get_iters() const {
  */
 unsigned lambert_problem::get_Nmax() const { return m_Nmax; }
 
+/// Gets the sensitivities of the velocity at r1
+/**
+ * Available only if the problem was constructed with options.sensitivities,
+ * otherwise the returned vector is empty. The sensitivities are computed
+ * analytically from the converged x via the implicit function theorem, at a
+ * cost comparable to a single solution.
+ *
+ * \return an std::vector containing, for all 2N_max+1 solutions, the 3x7
+ * Jacobian of v1 with respect to [r1, r2, tof]
+ */
+const std::vector<std::array<std::array<double, 7>, 3>> &
+lambert_problem::get_dv1_dp() const {
+  return m_dv1_dp;
+}
+
+/// Gets the sensitivities of the velocity at r2
+/**
+ * Available only if the problem was constructed with options.sensitivities,
+ * otherwise the returned vector is empty.
+ *
+ * \return an std::vector containing, for all 2N_max+1 solutions, the 3x7
+ * Jacobian of v2 with respect to [r1, r2, tof]
+ */
+const std::vector<std::array<std::array<double, 7>, 3>> &
+lambert_problem::get_dv2_dp() const {
+  return m_dv2_dp;
+}
+
 /// Streaming operator
 std::ostream &operator<<(std::ostream &s, const lambert_problem &lp) {
   s << std::setprecision(16) << "Lambert's problem:" << std::endl;
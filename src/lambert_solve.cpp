@@ -0,0 +1,175 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <kep3/core_astro/constants.hpp>
+#include <kep3/detail/lambert_kernels.hpp>
+#include <kep3/detail/lambert_setup.hpp>
+#include <kep3/detail/lambert_universal.hpp>
+#include <kep3/lambert_solve.hpp>
+
+namespace kep3 {
+
+namespace {
+
+// Solves the branch (assumed to exist) of a problem whose geometry and non
+// dimensional time of flight have already been computed.
+void lambert_solve_branch(const detail::lambert_geometry &geo, double T,
+                          double mu, lambert_branch branch,
+                          const detail::lambert_tolerances &tol,
+                          lambert_solution &sol) {
+  sol.branch = branch;
+  const auto its = detail::lambert_solve_branch(T, geo.lambda, branch.N,
+                                               branch.right, sol.x, false, tol);
+  sol.iters = its.iters;
+  if (!its.converged || !std::isfinite(sol.x)) {
+    sol.status = lambert_status::not_converged;
+    sol.v1.fill(std::numeric_limits<double>::quiet_NaN());
+    sol.v2 = sol.v1;
+    return;
+  }
+  detail::lambert_velocities(geo, sol.x, mu, sol.v1, sol.v2);
+  sol.status = lambert_status::success;
+}
+
+// As lambert_solve_branch(), with the universal variable. The existence of
+// the branch is determined by the solver itself.
+void lambert_solve_branch_universal(const detail::lambert_geometry &geo,
+                                    double tof, double mu,
+                                    lambert_branch branch,
+                                    const detail::lambert_tolerances &tol,
+                                    lambert_solution &sol) {
+  sol.branch = branch;
+  sol.status = detail::lambert_universal_solve(geo, tof, mu, branch.N,
+                                               branch.right, sol.x, sol.v1,
+                                               sol.v2, sol.iters, tol);
+  if (sol.status != lambert_status::success) {
+    return;
+  }
+  // NOTE: the velocities are not finite for transfer angles of 180 degrees.
+  if (!std::isfinite(sol.x) || !std::isfinite(sol.v1[0]) ||
+      !std::isfinite(sol.v2[0])) {
+    sol.status = lambert_status::not_converged;
+    sol.v1.fill(std::numeric_limits<double>::quiet_NaN());
+    sol.v2 = sol.v1;
+    return;
+  }
+  sol.status = lambert_status::success;
+}
+
+double norm_diff(const std::array<double, 3> &a,
+                 const std::array<double, 3> &b) {
+  return std::sqrt((a[0] - b[0]) * (a[0] - b[0]) +
+                   (a[1] - b[1]) * (a[1] - b[1]) +
+                   (a[2] - b[2]) * (a[2] - b[2]));
+}
+
+} // namespace
+
+lambert_solution lambert_solve(const std::array<double, 3> &r1,
+                               const std::array<double, 3> &r2, double tof,
+                               double mu, bool cw, lambert_branch branch,
+                               lambert_accuracy accuracy,
+                               lambert_engine engine) {
+  lambert_solution retval;
+  retval.branch = branch;
+  detail::lambert_geometry geo{};
+  double T = 0.;
+  retval.status = detail::lambert_setup(geo, r1, r2, tof, mu, cw, T);
+  if (retval.status != lambert_status::success) {
+    return retval;
+  }
+  if (engine == lambert_engine::universal) {
+    lambert_solve_branch_universal(geo, tof, mu, branch,
+                                   detail::lambert_tolerances_of(accuracy),
+                                   retval);
+    return retval;
+  }
+  retval.status = detail::lambert_branch_status(T, geo.lambda, branch.N);
+  if (retval.status != lambert_status::success) {
+    return retval;
+  }
+  lambert_solve_branch(geo, T, mu, branch,
+                       detail::lambert_tolerances_of(accuracy), retval);
+  return retval;
+}
+
+lambert_solution lambert_solve_min_dv(const std::array<double, 3> &r1,
+                                      const std::array<double, 3> &r2,
+                                      double tof, double mu,
+                                      const std::array<double, 3> &v_dep,
+                                      const std::array<double, 3> &v_arr,
+                                      bool cw, unsigned multi_revs,
+                                      lambert_accuracy accuracy) {
+  lambert_solution best;
+  detail::lambert_geometry geo{};
+  double T = 0.;
+  if (const auto status = detail::lambert_setup(geo, r1, r2, tof, mu, cw, T);
+      status != lambert_status::success) {
+    best.status = status;
+    return best;
+  }
+  const unsigned Nmax = detail::lambert_Nmax(T, geo.lambda, multi_revs);
+
+  // 1 - Lower bounds of the DV for each number of revolutions. For N > 0 the
+  // transfer lasts between N and N + 1 periods, N P <= tof < (N + 1) P,
+  // which bounds the semi-major axis a = s / 2 / (1 - x^2) and hence |x|. The
+  // zero revolutions solution is not bounded and is always computed first.
+  std::vector<std::pair<double, unsigned>> bounds;
+  bounds.reserve(Nmax + 1u);
+  bounds.emplace_back(0., 0u);
+  for (unsigned N = 1u; N <= Nmax; ++N) {
+    double xl = 0., xm = 0.;
+    detail::lambert_x_abs_range(geo, tof, mu, N, xl, xm);
+    bounds.emplace_back(
+        std::min(
+            detail::lambert_dv_lower_bound(geo, mu, -xm, -xl, v_dep, v_arr),
+            detail::lambert_dv_lower_bound(geo, mu, xl, xm, v_dep, v_arr)),
+        N);
+  }
+
+  // 2 - Best first search: the branches are solved by increasing lower bound
+  // until the bound exceeds the best DV found.
+  std::sort(bounds.begin(), bounds.end());
+  auto dv = [&v_dep, &v_arr](const lambert_solution &sol) {
+    return norm_diff(sol.v1, v_dep) + norm_diff(sol.v2, v_arr);
+  };
+  const auto tol = detail::lambert_tolerances_of(accuracy);
+  double best_dv = std::numeric_limits<double>::infinity();
+  lambert_solution sol;
+  for (const auto &[dv_lb, N] : bounds) {
+    if (dv_lb >= best_dv) {
+      break;
+    }
+    for (bool right : {false, true}) {
+      lambert_solve_branch(geo, T, mu, {N, right}, tol, sol);
+      if (sol.status == lambert_status::success) {
+        const double sol_dv = dv(sol);
+        if (sol_dv < best_dv) {
+          best = sol;
+          best_dv = sol_dv;
+        }
+      } else if (best.status != lambert_status::success) {
+        best = sol;
+      }
+      if (N == 0u) {
+        break;
+      }
+    }
+  }
+  return best;
+}
+
+} // namespace kep3
@@ -17,7 +17,7 @@
 
 #include <kep3/core_astro/constants.hpp>
 #include <kep3/core_astro/convert_anomalies.hpp>
-#include <kep3/core_astro/eq2par2eq.hpp>
+#include <kep3/core_astro/convert_elements.hpp>
 #include <kep3/epoch.hpp>
 #include <kep3/planet.hpp>
 #include <kep3/planets/jpl_lp.hpp>
@@ -149,23 +149,12 @@ std::array<std::array<double, 3>, 2> jpl_lp::eph(const epoch &ep) const {
 
 std::array<double, 6> jpl_lp::elements(const kep3::epoch &ep,
                                        kep3::elements_type el_type) const {
-  auto elements = _f_elements(ep);
-  switch (el_type) {
-  case kep3::elements_type::KEP_F:
-    break;
-  case kep3::elements_type::KEP_M:
-    elements[5] = kep3::f2m(elements[5], elements[1]);
-    break;
-  case kep3::elements_type::MEQ:
-    elements = kep3::par2eq(elements, false);
-    break;
-  case kep3::elements_type::MEQ_R:
-    elements = kep3::par2eq(elements, true);
-    break;
-  default:
-    throw std::logic_error("You should not go here!");
+  if (el_type == kep3::elements_type::POSVEL) {
+    throw std::logic_error(
+        "jpl_lp::elements: POSVEL is not an element set, use eph() instead");
   }
-  return elements;
+  return kep3::convert(_f_elements(ep), kep3::elements_type::KEP_F, el_type,
+                       get_mu_central_body());
 }
 
 std::string jpl_lp::get_name() const { return m_name; }
@@ -17,8 +17,7 @@
 
 #include <kep3/core_astro/constants.hpp>
 #include <kep3/core_astro/convert_anomalies.hpp>
-#include <kep3/core_astro/eq2par2eq.hpp>
-#include <kep3/core_astro/ic2eq2ic.hpp>
+#include <kep3/core_astro/convert_elements.hpp>
 #include <kep3/core_astro/ic2par2ic.hpp>
 #include <kep3/core_astro/propagate_lagrangian.hpp>
 #include <kep3/epoch.hpp>
@@ -60,27 +59,16 @@ keplerian::keplerian(const epoch &ref_epoch,
       m_mu_central_body(mu_central_body), m_mu_self(added_params[0]),
       m_radius(added_params[1]), m_safe_radius(added_params[2]), m_period(),
       m_ellipse() {
-  // orbital parameters a,e,i,W,w,f will be stored here
-  std::array<double, 6> par(par_in);
-  // we convert according to the chosen input
-  switch (el_type) {
-  case kep3::elements_type::KEP_F:
-    break;
-  case kep3::elements_type::KEP_M:
-    if (par[0] < 0) {
-      throw std::logic_error("Mean anomaly is only available for ellipses.");
-    }
-    par[5] = kep3::m2f(par[5], par[1]);
-    break;
-  case kep3::elements_type::MEQ:
-    par = kep3::eq2par(par, false);
-    break;
-  case kep3::elements_type::MEQ_R:
-    par = kep3::eq2par(par, true);
-    break;
-  default:
-    throw std::logic_error("You should not go here!");
+  if (el_type == kep3::elements_type::KEP_M && par_in[0] < 0) {
+    throw std::logic_error("Mean anomaly is only available for ellipses.");
+  }
+  if (el_type == kep3::elements_type::POSVEL) {
+    throw std::logic_error("A Keplerian planet constructor was called with "
+                           "POSVEL: use the constructor from pos_vel instead.");
   }
+  // orbital parameters a,e,i,W,w,f will be stored here
+  const auto par = kep3::convert(par_in, el_type, kep3::elements_type::KEP_F,
+                                 mu_central_body);
 
   if (par[0] * (1 - par[1]) <= 0) {
     throw std::domain_error(
@@ -125,28 +113,16 @@ double keplerian::period(const kep3::epoch &) const { return m_period; }
 kep3::epoch keplerian::get_ref_epoch() const { return m_ref_epoch; }
 
 std::array<double, 6> keplerian::elements(kep3::elements_type el_type) const {
-  std::array<double, 6> retval{};
-  switch (el_type) {
-  case kep3::elements_type::KEP_F:
-    retval = kep3::ic2par(m_pos_vel_0, m_mu_central_body);
-    break;
-  case kep3::elements_type::KEP_M:
-    if (!m_ellipse) {
-      throw std::logic_error("Mean anomaly is only available for ellipses.");
-    }
-    retval = kep3::ic2par(m_pos_vel_0, m_mu_central_body);
-    retval[5] = kep3::f2m(retval[5], retval[1]);
-    break;
-  case kep3::elements_type::MEQ:
-    retval = kep3::ic2eq(m_pos_vel_0, m_mu_central_body);
-    break;
-  case kep3::elements_type::MEQ_R:
-    retval = kep3::ic2eq(m_pos_vel_0, m_mu_central_body, true);
-    break;
-  default:
-    throw std::logic_error("You should not go here!");
+  if (el_type == kep3::elements_type::KEP_M && !m_ellipse) {
+    throw std::logic_error("Mean anomaly is only available for ellipses.");
   }
-  return retval;
+  if (el_type == kep3::elements_type::POSVEL) {
+    throw std::logic_error(
+        "keplerian::elements: POSVEL is not an element set, use eph() instead");
+  }
+  return kep3::convert(kep3::detail::posvel_flat(m_pos_vel_0),
+                       kep3::elements_type::POSVEL, el_type,
+                       m_mu_central_body);
 }
 
 std::string keplerian::get_extra_info() const {
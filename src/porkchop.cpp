@@ -0,0 +1,144 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include <kep3/core_astro/constants.hpp>
+#include <kep3/detail/npy.hpp>
+#include <kep3/detail/parallel_for.hpp>
+#include <kep3/detail/same_central_body.hpp>
+#include <kep3/epoch.hpp>
+#include <kep3/lambert_solve.hpp>
+#include <kep3/planet.hpp>
+#include <kep3/porkchop.hpp>
+
+namespace kep3 {
+
+namespace {
+
+// Side of the square tiles of the grid. A tile of departure and arrival
+// epochs touches 2 * porkchop_tile positions and velocities, and is large
+// enough to make the threading overhead negligible.
+constexpr std::size_t porkchop_tile = 64u;
+
+// Positions and velocities of a planet at the grid epochs.
+std::vector<std::array<std::array<double, 3>, 2>>
+ephemerides(planet &pla, std::span<const double> t) {
+  std::vector<std::array<std::array<double, 3>, 2>> retval(t.size());
+  for (std::size_t i = 0u; i < t.size(); ++i) {
+    retval[i] = pla.eph(epoch(t[i]));
+  }
+  return retval;
+}
+
+double norm2_diff(const std::array<double, 3> &a,
+                  const std::array<double, 3> &b) {
+  return (a[0] - b[0]) * (a[0] - b[0]) + (a[1] - b[1]) * (a[1] - b[1]) +
+         (a[2] - b[2]) * (a[2] - b[2]);
+}
+
+} // namespace
+
+// NOTE: the planets are taken by value as planet::eph() is not const.
+porkchop_result porkchop(planet dep, planet arr, std::span<const double> t_dep,
+                         std::span<const double> t_arr, bool cw,
+                         unsigned multi_revs, lambert_accuracy accuracy) {
+  const double mu = dep.get_mu_central_body();
+  // NOTE: the negated comparison also catches NaNs.
+  if (!(mu > 0)) {
+    throw std::domain_error(
+        "porkchop: The gravity parameter of the central body of the departure "
+        "planet is zero or negative!");
+  }
+  if (!detail::same_central_body(mu, arr.get_mu_central_body())) {
+    throw std::invalid_argument(fmt::format(
+        "porkchop: The departure and arrival planets must orbit the same "
+        "central body, but their gravity parameters are {} and {}",
+        mu, arr.get_mu_central_body()));
+  }
+
+  porkchop_result res;
+  res.n_dep = t_dep.size();
+  res.n_arr = t_arr.size();
+  const std::size_t n = res.n_dep * res.n_arr;
+  res.c3.resize(n);
+  res.vinf_arr.resize(n);
+  res.dv.resize(n);
+
+  // 1 - Ephemerides, once per grid epoch.
+  const auto eph_dep = ephemerides(dep, t_dep);
+  const auto eph_arr = ephemerides(arr, t_arr);
+
+  // 2 - Lambert problems, tile by tile.
+  const std::size_t n_tiles_dep =
+      (res.n_dep + porkchop_tile - 1u) / porkchop_tile;
+  const std::size_t n_tiles_arr =
+      (res.n_arr + porkchop_tile - 1u) / porkchop_tile;
+  detail::parallel_for(
+      n_tiles_dep * n_tiles_arr, 1u, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t k = begin; k < end; ++k) {
+          const std::size_t i0 = (k / n_tiles_arr) * porkchop_tile;
+          const std::size_t j0 = (k % n_tiles_arr) * porkchop_tile;
+          const std::size_t i1 = std::min(i0 + porkchop_tile, res.n_dep);
+          const std::size_t j1 = std::min(j0 + porkchop_tile, res.n_arr);
+          for (std::size_t i = i0; i < i1; ++i) {
+            const auto &[r1, v_dep] = eph_dep[i];
+            for (std::size_t j = j0; j < j1; ++j) {
+              const auto &[r2, v_arr] = eph_arr[j];
+              const double tof = (t_arr[j] - t_dep[i]) * DAY2SEC;
+              const auto sol =
+                  (multi_revs == 0u)
+                      ? lambert_solve(r1, r2, tof, mu, cw, {}, accuracy)
+                      : lambert_solve_min_dv(r1, r2, tof, mu, v_dep, v_arr,
+                                             cw, multi_revs, accuracy);
+              const std::size_t idx = i * res.n_arr + j;
+              if (sol.status != lambert_status::success) {
+                res.c3[idx] = std::numeric_limits<double>::quiet_NaN();
+                res.vinf_arr[idx] = res.c3[idx];
+                res.dv[idx] = res.c3[idx];
+                continue;
+              }
+              res.c3[idx] = norm2_diff(sol.v1, v_dep);
+              res.vinf_arr[idx] = std::sqrt(norm2_diff(sol.v2, v_arr));
+              res.dv[idx] = std::sqrt(res.c3[idx]) + res.vinf_arr[idx];
+            }
+          }
+        }
+      });
+  return res;
+}
+
+void porkchop_save_npy(const porkchop_result &res,
+                       const std::string &filename) {
+  std::ofstream file(filename, std::ios::binary);
+  if (!file) {
+    throw std::runtime_error(
+        fmt::format("porkchop_save_npy: Could not open the file {}", filename));
+  }
+  detail::npy_write_header(file, {3u, res.n_dep, res.n_arr});
+  detail::npy_write_data(file, res.c3);
+  detail::npy_write_data(file, res.vinf_arr);
+  detail::npy_write_data(file, res.dv);
+  if (!file) {
+    throw std::runtime_error(fmt::format(
+        "porkchop_save_npy: Could not write the file {}", filename));
+  }
+}
+
+} // namespace kep3
@@ -0,0 +1,214 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include <fmt/core.h>
+#include <fmt/ranges.h>
+
+#include <kep3/core_astro/constants.hpp>
+#include <kep3/detail/same_central_body.hpp>
+#include <kep3/epoch.hpp>
+#include <kep3/lambert_solve.hpp>
+#include <kep3/planet.hpp>
+#include <kep3/window_search.hpp>
+
+namespace kep3 {
+
+namespace {
+
+double norm_diff(const std::array<double, 3> &a,
+                 const std::array<double, 3> &b) {
+  return std::sqrt((a[0] - b[0]) * (a[0] - b[0]) +
+                   (a[1] - b[1]) * (a[1] - b[1]) +
+                   (a[2] - b[2]) * (a[2] - b[2]));
+}
+
+// Evaluates the transfers between two planets, counting the Lambert problems
+// solved.
+class window_evaluator {
+  planet &m_dep;
+  planet &m_arr;
+  double m_mu;
+  bool m_cw;
+  unsigned m_multi_revs;
+
+public:
+  unsigned long n_lambert = 0u;
+
+  window_evaluator(planet &dep, planet &arr, double mu, bool cw,
+                   unsigned multi_revs)
+      : m_dep(dep), m_arr(arr), m_mu(mu), m_cw(cw), m_multi_revs(multi_revs) {}
+
+  // The minimum DV transfer (infinite DV if there is none).
+  launch_window operator()(double t_dep, double tof) {
+    launch_window retval{t_dep, tof, 0., 0.,
+                         std::numeric_limits<double>::infinity()};
+    const auto [r1, v_dep] = m_dep.eph(epoch(t_dep));
+    const auto [r2, v_arr] = m_arr.eph(epoch(t_dep + tof));
+    ++n_lambert;
+    // NOTE: as in porkchop(), the solvers report the problems that cannot be
+    // solved (e.g. a degenerate geometry) by their status.
+    const auto sol =
+        (m_multi_revs == 0u)
+            ? lambert_solve(r1, r2, tof * DAY2SEC, m_mu, m_cw)
+            : lambert_solve_min_dv(r1, r2, tof * DAY2SEC, m_mu, v_dep, v_arr,
+                                   m_cw, m_multi_revs);
+    if (sol.status != lambert_status::success) {
+      return retval;
+    }
+    const double dv1 = norm_diff(sol.v1, v_dep);
+    retval.c3 = dv1 * dv1;
+    retval.vinf_arr = norm_diff(sol.v2, v_arr);
+    retval.dv = dv1 + retval.vinf_arr;
+    return retval;
+  }
+};
+
+} // namespace
+
+// NOTE: the planets are taken by value as planet::eph() is not const.
+window_search_result window_search(planet dep, planet arr,
+                                   const std::array<double, 2> &t_dep_bounds,
+                                   const std::array<double, 2> &tof_bounds,
+                                   unsigned grid_size, double tol, bool cw,
+                                   unsigned multi_revs, double merge_factor) {
+  // NOTE: the negated comparisons also catch NaNs.
+  if (!(t_dep_bounds[0] < t_dep_bounds[1]) ||
+      !(tof_bounds[0] < tof_bounds[1])) {
+    throw std::invalid_argument(fmt::format(
+        "window_search: The bounds must be ordered, but {} and {} were given",
+        t_dep_bounds, tof_bounds));
+  }
+  if (!(tof_bounds[0] > 0)) {
+    throw std::invalid_argument(
+        "window_search: The minimum time of flight must be positive");
+  }
+  if (grid_size < 3u) {
+    throw std::invalid_argument(fmt::format(
+        "window_search: The grid size must be at least 3, but {} was given",
+        grid_size));
+  }
+  if (!(tol > 0)) {
+    throw std::invalid_argument(
+        "window_search: The tolerance must be positive");
+  }
+  if (!(merge_factor >= 0)) {
+    throw std::invalid_argument(fmt::format(
+        "window_search: The merge factor must not be negative, but {} was "
+        "given",
+        merge_factor));
+  }
+  const double mu = dep.get_mu_central_body();
+  if (!(mu > 0)) {
+    throw std::domain_error(
+        "window_search: The gravity parameter of the central body of the "
+        "departure planet is zero or negative!");
+  }
+  if (!detail::same_central_body(mu, arr.get_mu_central_body())) {
+    throw std::invalid_argument(fmt::format(
+        "window_search: The departure and arrival planets must orbit the same "
+        "central body, but their gravity parameters are {} and {}",
+        mu, arr.get_mu_central_body()));
+  }
+
+  window_evaluator eval(dep, arr, mu, cw, multi_revs);
+  const double h_dep0 = (t_dep_bounds[1] - t_dep_bounds[0]) / (grid_size - 1u);
+  const double h_tof0 = (tof_bounds[1] - tof_bounds[0]) / (grid_size - 1u);
+
+  // 1 - Coarse grid.
+  std::vector<launch_window> grid;
+  grid.reserve(static_cast<std::size_t>(grid_size) * grid_size);
+  for (unsigned i = 0u; i < grid_size; ++i) {
+    for (unsigned j = 0u; j < grid_size; ++j) {
+      grid.push_back(
+          eval(t_dep_bounds[0] + i * h_dep0, tof_bounds[0] + j * h_tof0));
+    }
+  }
+
+  // 2 - Refinement of the local minima of the grid (including those on its
+  // border) by pattern search.
+  window_search_result res;
+  const auto n = static_cast<int>(grid_size);
+  for (int i = 0; i < n; ++i) {
+    for (int j = 0; j < n; ++j) {
+      const auto &node = grid[static_cast<std::size_t>(i * n + j)];
+      if (!std::isfinite(node.dv)) {
+        continue;
+      }
+      bool is_min = true;
+      for (int di = -1; di <= 1 && is_min; ++di) {
+        for (int dj = -1; dj <= 1; ++dj) {
+          const int k = i + di, l = j + dj;
+          if ((di != 0 || dj != 0) && k >= 0 && k < n && l >= 0 && l < n &&
+              grid[static_cast<std::size_t>(k * n + l)].dv < node.dv) {
+            is_min = false;
+            break;
+          }
+        }
+      }
+      if (!is_min) {
+        continue;
+      }
+      launch_window best = node;
+      double h_dep = h_dep0 / 2., h_tof = h_tof0 / 2.;
+      while (std::max(h_dep, h_tof) >= tol) {
+        launch_window cand = best;
+        for (int di = -1; di <= 1; ++di) {
+          for (int dj = -1; dj <= 1; ++dj) {
+            if (di == 0 && dj == 0) {
+              continue;
+            }
+            const double t = std::clamp(best.t_dep + di * h_dep,
+                                        t_dep_bounds[0], t_dep_bounds[1]);
+            const double tof = std::clamp(best.tof + dj * h_tof, tof_bounds[0],
+                                          tof_bounds[1]);
+            if (t == best.t_dep && tof == best.tof) {
+              continue;
+            }
+            const auto w = eval(t, tof);
+            if (w.dv < cand.dv) {
+              cand = w;
+            }
+          }
+        }
+        if (cand.dv < best.dv) {
+          best = cand;
+        } else {
+          h_dep /= 2.;
+          h_tof /= 2.;
+        }
+      }
+      // Minima of the grid converging to the same window are merged.
+      const double merge_radius = merge_factor * tol;
+      const auto same = std::find_if(
+          res.windows.begin(), res.windows.end(), [&](const auto &w) {
+            return std::abs(w.t_dep - best.t_dep) <= merge_radius &&
+                   std::abs(w.tof - best.tof) <= merge_radius;
+          });
+      if (same == res.windows.end()) {
+        res.windows.push_back(best);
+      } else if (best.dv < same->dv) {
+        *same = best;
+      }
+    }
+  }
+  std::sort(res.windows.begin(), res.windows.end(),
+            [](const auto &a, const auto &b) { return a.dv < b.dv; });
+  res.n_lambert = eval.n_lambert;
+  return res;
+}
+
+} // namespace kep3
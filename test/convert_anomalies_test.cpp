@@ -7,8 +7,10 @@
 // Public License v. 2.0. If a copy of the MPL was not distributed
 // with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
 
+#include <array>
 #include <iostream>
 #include <random>
+#include <vector>
 
 #include <kep3/core_astro/convert_anomalies.hpp>
 #include <stdexcept>
@@ -152,4 +154,39 @@ TEST_CASE("throws") {
         
         REQUIRE_THROWS_AS(kep3::zeta2f(0.3,0.1), std::domain_error);
         REQUIRE_THROWS_AS(kep3::f2zeta(0.3,0.1), std::domain_error);
-}
\ No newline at end of file
+}
+
+TEST_CASE("batch") {
+        // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+        std::mt19937 rng_engine(1234u);
+        std::uniform_real_distribution<double> ecc_d(0., 0.99);
+        std::uniform_real_distribution<double> M_d(-100., 100.);
+        const unsigned N = 1000u;
+        std::vector<double> Ms(N), eccs(N), out(N);
+        for (auto i = 0u; i < N; ++i) {
+                Ms[i] = M_d(rng_engine);
+                eccs[i] = ecc_d(rng_engine);
+        }
+        // Element-wise eccentricities.
+        kep3::m2e_v(Ms, eccs, out);
+        for (auto i = 0u; i < N; ++i) {
+                REQUIRE(out[i] == kep3::m2e(Ms[i], eccs[i]));
+        }
+        // Broadcasted eccentricity.
+        const std::array<double, 1> ecc{0.3};
+        kep3::m2f_v(Ms, ecc, out);
+        for (auto i = 0u; i < N; ++i) {
+                REQUIRE(out[i] == kep3::m2f(Ms[i], 0.3));
+        }
+        // Hyperbolic conversions.
+        const std::array<double, 1> hecc{3.2};
+        kep3::n2h_v(Ms, hecc, out);
+        for (auto i = 0u; i < N; ++i) {
+                REQUIRE(out[i] == kep3::n2h(Ms[i], 3.2));
+        }
+        // Throws.
+        std::vector<double> wrong(N - 1u);
+        REQUIRE_THROWS_AS(kep3::m2e_v(Ms, wrong, out), std::invalid_argument);
+        REQUIRE_THROWS_AS(kep3::m2e_v(Ms, hecc, out), std::domain_error);
+        REQUIRE_THROWS_AS(kep3::n2h_v(Ms, ecc, out), std::domain_error);
+}
@@ -0,0 +1,224 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <array>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <kep3/core_astro/constants.hpp>
+#include <kep3/core_astro/convert_anomalies.hpp>
+#include <kep3/core_astro/convert_elements.hpp>
+#include <kep3/core_astro/elements_batch.hpp>
+#include <kep3/core_astro/eq2par2eq.hpp>
+#include <kep3/core_astro/ic2eq2ic.hpp>
+#include <kep3/core_astro/ic2par2ic.hpp>
+
+#include "catch.hpp"
+#include "test_helpers.hpp"
+
+using kep3::elements_type;
+
+namespace {
+
+constexpr std::array<elements_type, 5> all_types = {
+    kep3::KEP_M, kep3::KEP_F, kep3::MEQ, kep3::MEQ_R, kep3::POSVEL};
+
+// The elements of the state pos_vel, through the conversions from the
+// cartesian state.
+std::array<double, 6>
+reference_elements(const std::array<std::array<double, 3>, 2> &pos_vel,
+                   elements_type t) {
+  switch (t) {
+  case kep3::KEP_M: {
+    auto par = kep3::ic2par(pos_vel, 1.);
+    par[5] = kep3::f2m(par[5], par[1]);
+    return par;
+  }
+  case kep3::KEP_F:
+    return kep3::ic2par(pos_vel, 1.);
+  case kep3::MEQ:
+    return kep3::ic2eq(pos_vel, 1.);
+  case kep3::MEQ_R:
+    return kep3::ic2eq(pos_vel, 1., true);
+  default:
+    return kep3::detail::posvel_flat(pos_vel);
+  }
+}
+
+// The cartesian state of the elements x, through the conversions to the
+// cartesian state.
+std::array<std::array<double, 3>, 2>
+reference_posvel(std::array<double, 6> x, elements_type t) {
+  switch (t) {
+  case kep3::KEP_M:
+    x[5] = kep3::m2f(x[5], x[1]);
+    return kep3::par2ic(x, 1.);
+  case kep3::KEP_F:
+    return kep3::par2ic(x, 1.);
+  case kep3::MEQ:
+    return kep3::eq2ic(x, 1.);
+  case kep3::MEQ_R:
+    return kep3::eq2ic(x, 1., true);
+  default:
+    return kep3::detail::posvel_split(x);
+  }
+}
+
+} // namespace
+
+TEST_CASE("convert") {
+  // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+  std::mt19937 rng_engine(122012203u);
+  std::uniform_real_distribution<double> sma_d(1.1, 100.);
+  std::uniform_real_distribution<double> ecc_d(0.01, 0.9);
+  std::uniform_real_distribution<double> incl_d(0.1, kep3::pi - 0.1);
+  std::uniform_real_distribution<double> angle_d(0., 2 * kep3::pi);
+  for (auto i = 0u; i < 1000u; ++i) {
+    const auto pos_vel = kep3::par2ic(
+        {sma_d(rng_engine), ecc_d(rng_engine), incl_d(rng_engine),
+         angle_d(rng_engine), angle_d(rng_engine), angle_d(rng_engine)},
+        1.);
+    for (auto from : all_types) {
+      const auto x = reference_elements(pos_vel, from);
+      for (auto to : all_types) {
+        // NOTE: the angles are compared through the cartesian state.
+        const auto pv = reference_posvel(kep3::convert(x, from, to, 1.), to);
+        REQUIRE(kep3_tests::floating_point_error_vector(pv[0], pos_vel[0]) <
+                1e-12);
+        REQUIRE(kep3_tests::floating_point_error_vector(pv[1], pos_vel[1]) <
+                1e-12);
+      }
+    }
+  }
+  // The compile time and runtime versions agree.
+  const auto pos_vel =
+      kep3::par2ic({1.3, 0.2, 0.3, 0.4, 0.5, 0.6}, kep3::MU_SUN);
+  const auto par = kep3::ic2par(pos_vel, kep3::MU_SUN);
+  REQUIRE(kep3::convert<kep3::KEP_F, kep3::MEQ_R>(par, kep3::MU_SUN) ==
+          kep3::convert(par, kep3::KEP_F, kep3::MEQ_R, kep3::MU_SUN));
+  REQUIRE(kep3::convert<kep3::POSVEL, kep3::KEP_M>(
+              kep3::detail::posvel_flat(pos_vel), kep3::MU_SUN) ==
+          kep3::convert(kep3::detail::posvel_flat(pos_vel), kep3::POSVEL,
+                        kep3::KEP_M, kep3::MU_SUN));
+  REQUIRE(kep3::convert<kep3::MEQ, kep3::MEQ>(par, 1.) == par);
+  // The closed form swap of the equinoctial elements.
+  const auto eq = kep3::par2eq(par);
+  const auto eq_r = kep3::eq2eq_r(eq);
+  const auto eq_r_ref = kep3::par2eq(par, true);
+  const auto eq_back = kep3::eq_r2eq(eq_r);
+  for (auto k = 0u; k < 6u; ++k) {
+    REQUIRE(std::abs(std::remainder(eq_r[k] - eq_r_ref[k], 2 * kep3::pi)) <
+            1e-14);
+    REQUIRE(std::abs(std::remainder(eq_back[k] - eq[k], 2 * kep3::pi)) <
+            1e-14);
+  }
+  // Hyperbolas have no mean anomaly.
+  const std::array<double, 6> hyp = {-1.3, 1.2, 0.3, 0.4, 0.5, 0.6};
+  REQUIRE_THROWS_AS(kep3::convert(hyp, kep3::KEP_F, kep3::KEP_M, 1.),
+                    std::domain_error);
+  REQUIRE_THROWS_AS(kep3::convert(hyp, kep3::KEP_M, kep3::MEQ, 1.),
+                    std::domain_error);
+  REQUIRE(kep3::convert(hyp, kep3::KEP_F, kep3::MEQ, 1.) == kep3::par2eq(hyp));
+  // Invalid element types.
+  REQUIRE_THROWS_AS(
+      kep3::convert(par, static_cast<elements_type>(5), kep3::MEQ, 1.),
+      std::invalid_argument);
+  REQUIRE_THROWS_AS(
+      kep3::convert(par, kep3::MEQ, static_cast<elements_type>(6), 1.),
+      std::invalid_argument);
+}
+
+TEST_CASE("convert_batch") {
+  // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+  std::mt19937 rng_engine(122012203u);
+  std::uniform_real_distribution<double> sma_d(1.1, 100.);
+  std::uniform_real_distribution<double> ecc_d(0.01, 0.9);
+  std::uniform_real_distribution<double> incl_d(0.1, kep3::pi - 0.1);
+  std::uniform_real_distribution<double> angle_d(0., 2 * kep3::pi);
+  // A size that is not a multiple of the block size of the batches.
+  const auto n = 103u;
+  std::vector<std::array<std::array<double, 3>, 2>> pos_vel(n);
+  for (auto &pv : pos_vel) {
+    pv = kep3::par2ic({sma_d(rng_engine), ecc_d(rng_engine),
+                       incl_d(rng_engine), angle_d(rng_engine),
+                       angle_d(rng_engine), angle_d(rng_engine)},
+                      1.);
+  }
+  std::array<std::vector<double>, 6> in, out;
+  for (auto c = 0u; c < 6u; ++c) {
+    in[c].resize(n);
+    out[c].resize(n);
+  }
+  const auto spans_in = [&]() {
+    return kep3::elements_batch_input{in[0], in[1], in[2],
+                                      in[3], in[4], in[5]};
+  };
+  const auto spans_out = [&]() {
+    return kep3::elements_batch_output{out[0], out[1], out[2],
+                                       out[3], out[4], out[5]};
+  };
+  for (auto from : all_types) {
+    for (auto i = 0u; i < n; ++i) {
+      const auto x = reference_elements(pos_vel[i], from);
+      for (auto c = 0u; c < 6u; ++c) {
+        in[c][i] = x[c];
+      }
+    }
+    for (auto to : all_types) {
+      kep3::convert_batch(spans_in(), from, to, 1., spans_out());
+      for (auto i = 0u; i < n; ++i) {
+        const auto pv = reference_posvel({out[0][i], out[1][i], out[2][i],
+                                          out[3][i], out[4][i], out[5][i]},
+                                         to);
+        REQUIRE(kep3_tests::floating_point_error_vector(pv[0],
+                                                        pos_vel[i][0]) <
+                1e-12);
+        REQUIRE(kep3_tests::floating_point_error_vector(pv[1],
+                                                        pos_vel[i][1]) <
+                1e-12);
+      }
+    }
+  }
+  // In place, with the compile time version.
+  for (auto i = 0u; i < n; ++i) {
+    const auto x = reference_elements(pos_vel[i], kep3::KEP_M);
+    for (auto c = 0u; c < 6u; ++c) {
+      out[c][i] = x[c];
+    }
+  }
+  kep3::convert_batch<kep3::KEP_M, kep3::MEQ_R>(
+      {out[0], out[1], out[2], out[3], out[4], out[5]}, 1., spans_out());
+  for (auto i = 0u; i < n; ++i) {
+    const auto pv = kep3::eq2ic(
+        {out[0][i], out[1][i], out[2][i], out[3][i], out[4][i], out[5][i]},
+        1., true);
+    REQUIRE(kep3_tests::floating_point_error_vector(pv[0], pos_vel[i][0]) <
+            1e-12);
+  }
+  // Hyperbolas have no mean anomaly: NaNs.
+  for (auto c = 0u; c < 6u; ++c) {
+    in[c].assign(n, 0.3);
+  }
+  in[0][0] = -1.3;
+  in[1][0] = 1.2;
+  kep3::convert_batch(spans_in(), kep3::KEP_F, kep3::KEP_M, 1., spans_out());
+  REQUIRE(std::isnan(out[5][0]));
+  REQUIRE(std::isfinite(out[5][1]));
+  // Invalid arguments.
+  REQUIRE_THROWS_AS(kep3::convert_batch(spans_in(),
+                                        static_cast<elements_type>(7),
+                                        kep3::MEQ, 1., spans_out()),
+                    std::invalid_argument);
+  out[2].resize(n - 1u);
+  REQUIRE_THROWS_AS(kep3::convert_batch(spans_in(), kep3::KEP_F, kep3::MEQ,
+                                        1., spans_out()),
+                    std::invalid_argument);
+}
@@ -0,0 +1,164 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <kep3/core_astro/constants.hpp>
+#include <kep3/dv_matrix.hpp>
+#include <kep3/epoch.hpp>
+#include <kep3/lambert_problem.hpp>
+#include <kep3/planet.hpp>
+
+#include "catch.hpp"
+
+using kep3::epoch;
+using kep3::planet;
+
+// A planet on an inclined circular orbit around the Sun.
+struct circular_udpla {
+  double a = kep3::AU;
+  double phase = 0.;
+  double incl = 0.1;
+  double mu = kep3::MU_SUN;
+
+  [[nodiscard]] std::array<std::array<double, 3>, 2>
+  eph(const epoch &ep) const {
+    const double n = std::sqrt(mu / (a * a * a));
+    const double th = phase + n * ep.mjd2000() * kep3::DAY2SEC;
+    const double v = n * a;
+    return {{{a * std::cos(th), a * std::sin(th) * std::cos(incl),
+              a * std::sin(th) * std::sin(incl)},
+             {-v * std::sin(th), v * std::cos(th) * std::cos(incl),
+              v * std::cos(th) * std::sin(incl)}}};
+  }
+  [[nodiscard]] double get_mu_central_body() const { return mu; }
+
+private:
+  friend class boost::serialization::access;
+  template <typename Archive> void serialize(Archive &ar, unsigned) {
+    ar &a;
+    ar &phase;
+    ar &incl;
+    ar &mu;
+  }
+};
+kep3_S11N_PLANET_EXPORT(circular_udpla);
+
+namespace {
+double norm_diff(const std::array<double, 3> &a,
+                 const std::array<double, 3> &b) {
+  return std::sqrt((a[0] - b[0]) * (a[0] - b[0]) +
+                   (a[1] - b[1]) * (a[1] - b[1]) +
+                   (a[2] - b[2]) * (a[2] - b[2]));
+}
+
+// More targets than one tile, so that the bands and the tiles are partial.
+std::vector<circular_udpla> make_targets(unsigned n) {
+  std::vector<circular_udpla> retval;
+  for (auto i = 0u; i < n; ++i) {
+    retval.push_back(circular_udpla{(1. + 0.01 * i) * kep3::AU, 0.37 * i,
+                                    0.002 * i, kep3::MU_SUN});
+  }
+  return retval;
+}
+} // namespace
+
+TEST_CASE("dv_matrix") {
+  const auto udplas = make_targets(70u);
+  const std::vector<planet> targets(udplas.begin(), udplas.end());
+  const std::vector<double> t_dep = {0., 123.};
+  const std::vector<double> tof = {150., 310.};
+  for (unsigned multi_revs : {0u, 1u}) {
+    const auto res = kep3::dv_matrix(targets, t_dep, tof, false, multi_revs);
+    REQUIRE(res.n_dep == 2u);
+    REQUIRE(res.n_tof == 2u);
+    REQUIRE(res.n_targets == udplas.size());
+    REQUIRE(res.dv.size() == 4u * udplas.size() * udplas.size());
+    for (auto k = 0u; k < t_dep.size(); ++k) {
+      for (auto l = 0u; l < tof.size(); ++l) {
+        // Against the minimum DV solution of a lambert_problem, on a subset
+        // of the pairs.
+        for (auto i = 0u; i < udplas.size(); i += 3u) {
+          for (auto j = 0u; j < udplas.size(); j += 5u) {
+            const auto [r1, v_dep] = udplas[i].eph(epoch(t_dep[k]));
+            const auto [r2, v_arr] = udplas[j].eph(epoch(t_dep[k] + tof[l]));
+            const kep3::lambert_problem lp(r1, r2, tof[l] * kep3::DAY2SEC,
+                                           kep3::MU_SUN, false, multi_revs);
+            double dv = 1e300;
+            for (auto m = 0u; m < lp.get_v1().size(); ++m) {
+              dv = std::min(dv, norm_diff(lp.get_v1()[m], v_dep) +
+                                    norm_diff(lp.get_v2()[m], v_arr));
+            }
+            const auto idx =
+                ((k * tof.size() + l) * udplas.size() + i) * udplas.size() +
+                j;
+            REQUIRE(std::abs(res.dv[idx] - dv) <= 1e-8 * dv);
+          }
+        }
+      }
+    }
+  }
+  // Targets orbiting different bodies.
+  std::vector<planet> mixed = targets;
+  mixed.emplace_back(circular_udpla{kep3::AU, 0., 0.1, kep3::MU_EARTH});
+  REQUIRE_THROWS_AS(kep3::dv_matrix(mixed, t_dep, tof),
+                    std::invalid_argument);
+  REQUIRE_THROWS_AS(
+      kep3::dv_matrix({planet(circular_udpla{kep3::AU, 0., 0.1, 0.})}, t_dep,
+                      tof),
+      std::domain_error);
+  // No targets.
+  const auto res = kep3::dv_matrix({}, t_dep, tof);
+  REQUIRE(res.n_targets == 0u);
+  REQUIRE(res.dv.empty());
+}
+
+TEST_CASE("dv_matrix_save_npy") {
+  const auto udplas = make_targets(67u);
+  const std::vector<planet> targets(udplas.begin(), udplas.end());
+  const std::vector<double> t_dep = {10., 20., 30.};
+  const std::vector<double> tof = {200.};
+  const auto res = kep3::dv_matrix(targets, t_dep, tof);
+  const std::string filename = "dv_matrix_test.npy";
+  kep3::dv_matrix_save_npy(targets, t_dep, tof, filename);
+  std::ifstream file(filename, std::ios::binary);
+  const std::vector<char> bytes((std::istreambuf_iterator<char>(file)),
+                                std::istreambuf_iterator<char>());
+  file.close();
+  std::remove(filename.c_str());
+  REQUIRE(std::string(bytes.begin(), bytes.begin() + 8) ==
+          std::string("\x93NUMPY\x01\x00", 8));
+  const std::size_t header_len =
+      static_cast<unsigned char>(bytes[8]) +
+      256u * static_cast<unsigned char>(bytes[9]);
+  const std::string header(bytes.begin() + 10,
+                           bytes.begin() + 10 +
+                               static_cast<std::ptrdiff_t>(header_len));
+  REQUIRE(header.find("'shape': (3, 1, 67, 67)") != std::string::npos);
+  REQUIRE(bytes.size() == 10u + header_len + res.dv.size() * sizeof(double));
+  std::vector<double> data(res.dv.size());
+  std::copy(bytes.begin() + 10 + static_cast<std::ptrdiff_t>(header_len),
+            bytes.end(), reinterpret_cast<char *>(data.data()));
+  for (auto k = 0u; k < data.size(); ++k) {
+    REQUIRE((data[k] == res.dv[k] ||
+             (std::isnan(data[k]) && std::isnan(res.dv[k]))));
+  }
+  REQUIRE_THROWS_AS(kep3::dv_matrix_save_npy(targets, t_dep, tof,
+                                             "/nonexistent/dir/x.npy"),
+                    std::runtime_error);
+}
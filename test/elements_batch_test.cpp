@@ -0,0 +1,181 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <array>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <boost/math/constants/constants.hpp>
+
+#include <kep3/core_astro/elements_batch.hpp>
+#include <kep3/core_astro/eq2par2eq.hpp>
+#include <kep3/core_astro/ic2eq2ic.hpp>
+#include <kep3/core_astro/ic2par2ic.hpp>
+
+#include "catch.hpp"
+#include "test_helpers.hpp"
+
+using kep3::elements_batch_input;
+using kep3::elements_batch_output;
+
+constexpr double pi{boost::math::constants::pi<double>()};
+
+namespace {
+
+// Six arrays of n values.
+struct soa {
+  std::array<std::vector<double>, 6> data;
+  explicit soa(std::size_t n) {
+    for (auto &v : data) {
+      v.resize(n);
+    }
+  }
+  [[nodiscard]] elements_batch_input in() const {
+    return {data[0], data[1], data[2], data[3], data[4], data[5]};
+  }
+  [[nodiscard]] elements_batch_output out() {
+    return {data[0], data[1], data[2], data[3], data[4], data[5]};
+  }
+  [[nodiscard]] std::array<double, 6> get(std::size_t i) const {
+    return {data[0][i], data[1][i], data[2][i],
+            data[3][i], data[4][i], data[5][i]};
+  }
+};
+
+// Error on an angle, modulo 2pi.
+double angle_error(double a, double b) {
+  return std::abs(std::remainder(a - b, 2 * pi));
+}
+
+// Random Keplerian elements, half of them hyperbolae (with the true anomaly
+// within the asymptotes). An odd size exercises the last, partial, block.
+soa random_par(std::size_t n) {
+  // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+  std::mt19937 rng_engine(122012203u);
+  std::uniform_real_distribution<double> sma_d(1.1, 100.);
+  std::uniform_real_distribution<double> ecc_d(0, 0.99);
+  std::uniform_real_distribution<double> incl_d(0.01, pi - 0.01);
+  std::uniform_real_distribution<double> angle_d(0., 2 * pi);
+  std::uniform_real_distribution<double> unit_d(-1., 1.);
+  soa par(n);
+  for (auto i = 0u; i < n; ++i) {
+    const bool hyperbola = i % 2u == 1u;
+    const double ecc = hyperbola ? ecc_d(rng_engine) + 1.1 : ecc_d(rng_engine);
+    par.data[0][i] = hyperbola ? -sma_d(rng_engine) : sma_d(rng_engine);
+    par.data[1][i] = ecc;
+    par.data[2][i] = incl_d(rng_engine);
+    par.data[3][i] = angle_d(rng_engine);
+    par.data[4][i] = angle_d(rng_engine);
+    par.data[5][i] = hyperbola
+                         ? 0.9 * std::acos(-1. / ecc) * unit_d(rng_engine)
+                         : angle_d(rng_engine);
+  }
+  return par;
+}
+
+} // namespace
+
+TEST_CASE("par2ic2par_batch") {
+  const std::size_t n = 1001u;
+  const auto par = random_par(n);
+  soa pos_vel(n), par_new(n);
+  kep3::par2ic_batch(par.in(), 1.3, pos_vel.out());
+  kep3::ic2par_batch(pos_vel.in(), 1.3, par_new.out());
+  for (auto i = 0u; i < n; ++i) {
+    const auto p = par.get(i);
+    // Against the scalar conversions.
+    const auto [r, v] = kep3::par2ic(p, 1.3);
+    for (auto c = 0u; c < 3u; ++c) {
+      REQUIRE(kep3_tests::floating_point_error(pos_vel.data[c][i], r[c]) <
+              1e-13);
+      REQUIRE(kep3_tests::floating_point_error(pos_vel.data[3u + c][i],
+                                               v[c]) < 1e-13);
+    }
+    const auto p_scalar = kep3::ic2par({r, v}, 1.3);
+    REQUIRE(kep3_tests::floating_point_error(par_new.data[0][i],
+                                             p_scalar[0]) < 1e-13);
+    REQUIRE(kep3_tests::floating_point_error(par_new.data[1][i],
+                                             p_scalar[1]) < 1e-13);
+    for (auto c = 2u; c < 6u; ++c) {
+      REQUIRE(angle_error(par_new.data[c][i], p_scalar[c]) < 1e-12);
+    }
+    // Back to the original elements.
+    REQUIRE(kep3_tests::floating_point_error(par_new.data[0][i], p[0]) <
+            1e-10);
+    REQUIRE(kep3_tests::floating_point_error(par_new.data[1][i], p[1]) <
+            1e-10);
+  }
+  // Invalid elements give NaNs.
+  soa bad(2u), bad_ic(2u);
+  bad.data[0] = {1.3, 11.1};
+  bad.data[1] = {1.3, 1.4};
+  bad.data[5] = {0., 5.23};
+  kep3::par2ic_batch(bad.in(), 1., bad_ic.out());
+  for (auto c = 0u; c < 6u; ++c) {
+    REQUIRE(std::isnan(bad_ic.data[c][0]));
+    REQUIRE(std::isnan(bad_ic.data[c][1]));
+  }
+}
+
+TEST_CASE("eq_batch") {
+  const std::size_t n = 999u;
+  const auto par = random_par(n);
+  soa pos_vel(n);
+  kep3::par2ic_batch(par.in(), 1., pos_vel.out());
+  for (bool retrogade : {false, true}) {
+    soa eq(n), ic_new(n), eq_par(n), par_eq(n);
+    kep3::ic2eq_batch(pos_vel.in(), 1., eq.out(), retrogade);
+    kep3::eq2ic_batch(eq.in(), 1., ic_new.out(), retrogade);
+    kep3::eq2par_batch(eq.in(), eq_par.out(), retrogade);
+    kep3::par2eq_batch(eq_par.in(), par_eq.out(), retrogade);
+    for (auto i = 0u; i < n; ++i) {
+      const std::array<std::array<double, 3>, 2> pv = {
+          {{pos_vel.data[0][i], pos_vel.data[1][i], pos_vel.data[2][i]},
+           {pos_vel.data[3][i], pos_vel.data[4][i], pos_vel.data[5][i]}}};
+      // Against the scalar conversions.
+      const auto eq_scalar = kep3::ic2eq(pv, 1., retrogade);
+      for (auto c = 0u; c < 5u; ++c) {
+        REQUIRE(kep3_tests::floating_point_error(eq.data[c][i],
+                                                 eq_scalar[c]) < 1e-11);
+      }
+      REQUIRE(angle_error(eq.data[5][i], eq_scalar[5]) < 1e-12);
+      const auto ic_scalar = kep3::eq2ic(eq.get(i), 1., retrogade);
+      const auto par_scalar = kep3::eq2par(eq.get(i), retrogade);
+      const auto eq_back = kep3::par2eq(eq_par.get(i), retrogade);
+      for (auto c = 0u; c < 6u; ++c) {
+        REQUIRE(kep3_tests::floating_point_error(ic_new.data[c][i],
+                                                 ic_scalar[c / 3u][c % 3u]) <
+                1e-13);
+        REQUIRE(kep3_tests::floating_point_error(eq_par.data[c][i],
+                                                 par_scalar[c]) < 1e-13);
+        REQUIRE(kep3_tests::floating_point_error(par_eq.data[c][i],
+                                                 eq_back[c]) < 1e-13);
+      }
+      // Back to the original state.
+      for (auto c = 0u; c < 6u; ++c) {
+        REQUIRE(kep3_tests::floating_point_error(ic_new.data[c][i],
+                                                 pos_vel.data[c][i]) < 1e-9);
+      }
+    }
+  }
+}
+
+TEST_CASE("sizes") {
+  soa a(3u), b(3u);
+  a.data[4].resize(2u);
+  REQUIRE_THROWS_AS(kep3::ic2par_batch(a.in(), 1., b.out()),
+                    std::invalid_argument);
+  REQUIRE_THROWS_AS(kep3::eq2par_batch(b.in(), a.out()),
+                    std::invalid_argument);
+  // Empty batches.
+  soa e(0u), f(0u);
+  kep3::par2ic_batch(e.in(), 1., f.out());
+}
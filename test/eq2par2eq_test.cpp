@@ -7,7 +7,9 @@
 // Public License v. 2.0. If a copy of the MPL was not distributed
 // with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
 
+#include <array>
 #include <cmath>
+#include <random>
 #include <stdexcept>
 
 #include <fmt/core.h>
@@ -170,4 +172,44 @@ TEST_CASE("eq2par2eq_retrogade") {
       REQUIRE(kep3_tests::floating_point_error(ni, par[5]) < 1e-13);
     }
   }
-}
\ No newline at end of file
+}
+TEST_CASE("eq2par2eq_jac") {
+  // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+  std::mt19937 rng_engine(122012203u);
+  // Away from the singularities of the elements (circular and equatorial
+  // orbits).
+  std::uniform_real_distribution<double> sma_d(1.1, 10.);
+  std::uniform_real_distribution<double> ecc_d(0.05, 0.9);
+  std::uniform_real_distribution<double> incl_d(0.1, pi - 0.1);
+  std::uniform_real_distribution<double> angle_d(0., 2 * pi);
+  for (bool retrogade : {false, true}) {
+    for (auto i = 0u; i < 1000u; ++i) {
+      const std::array<double, 6> par = {
+          sma_d(rng_engine),   ecc_d(rng_engine),   incl_d(rng_engine),
+          angle_d(rng_engine), angle_d(rng_engine), angle_d(rng_engine)};
+      const auto eq = kep3::par2eq(par, retrogade);
+      // par2eq.
+      {
+        const auto [val, jac] = kep3::par2eq_jac(par, retrogade);
+        for (auto k = 0u; k < 6u; ++k) {
+          REQUIRE(kep3_tests::floating_point_error(val[k], eq[k]) < 1e-14);
+        }
+        REQUIRE(kep3_tests::jacobian_error(
+                    [&](const auto &x) { return kep3::par2eq(x, retrogade); },
+                    par, jac, {false, false, false, false, false, true}) <
+                1e-5);
+      }
+      // eq2par.
+      {
+        const auto [val, jac] = kep3::eq2par_jac(eq, retrogade);
+        const auto ref = kep3::eq2par(eq, retrogade);
+        for (auto k = 0u; k < 6u; ++k) {
+          REQUIRE(kep3_tests::floating_point_error(val[k], ref[k]) < 1e-14);
+        }
+        REQUIRE(kep3_tests::jacobian_error(
+                    [&](const auto &x) { return kep3::eq2par(x, retrogade); },
+                    eq, jac, {false, false, false, true, true, true}) < 1e-5);
+      }
+    }
+  }
+}
@@ -0,0 +1,264 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <kep3/core_astro/constants.hpp>
+#include <kep3/core_astro/elements_batch.hpp>
+#include <kep3/core_astro/event_times.hpp>
+#include <kep3/core_astro/ic2par2ic.hpp>
+#include <kep3/core_astro/propagate_lagrangian.hpp>
+
+#include "catch.hpp"
+
+using kep3::pi;
+
+namespace {
+
+using pos_vel_t = std::array<std::array<double, 3>, 2>;
+
+// The state pos_vel propagated for the time dt, with mu = 1.
+pos_vel_t propagated(pos_vel_t pos_vel, double dt) {
+  kep3::propagate_lagrangian(pos_vel, dt, 1.);
+  return pos_vel;
+}
+
+double norm(const std::array<double, 3> &x) {
+  return std::sqrt(x[0] * x[0] + x[1] * x[1] + x[2] * x[2]);
+}
+
+double dot(const std::array<double, 3> &x, const std::array<double, 3> &y) {
+  return x[0] * y[0] + x[1] * y[1] + x[2] * y[2];
+}
+
+// Random states on ellipses or, within the asymptotes, on hyperbolas.
+std::vector<pos_vel_t> random_states(std::size_t n, bool hyperbola) {
+  // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+  std::mt19937 rng_engine(122012203u);
+  std::uniform_real_distribution<double> sma_d(1.1, 10.);
+  std::uniform_real_distribution<double> ecc_d(0.01, 0.9);
+  std::uniform_real_distribution<double> incl_d(0.01, pi - 0.01);
+  std::uniform_real_distribution<double> angle_d(0., 2 * pi);
+  std::uniform_real_distribution<double> unit_d(-1., 1.);
+  std::vector<pos_vel_t> retval(n);
+  for (auto &pos_vel : retval) {
+    const double ecc = hyperbola ? ecc_d(rng_engine) + 1.1 : ecc_d(rng_engine);
+    const double f = hyperbola
+                         ? 0.9 * std::acos(-1. / ecc) * unit_d(rng_engine)
+                         : angle_d(rng_engine);
+    pos_vel = kep3::par2ic({hyperbola ? -sma_d(rng_engine) : sma_d(rng_engine),
+                            ecc, incl_d(rng_engine), angle_d(rng_engine),
+                            angle_d(rng_engine), f},
+                           1.);
+  }
+  return retval;
+}
+
+} // namespace
+
+TEST_CASE("time_of_flight") {
+  // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+  std::mt19937 rng_engine(122012203u);
+  std::uniform_real_distribution<double> sma_d(1.1, 10.);
+  std::uniform_real_distribution<double> ecc_d(0., 0.9);
+  std::uniform_real_distribution<double> angle_d(0., 2 * pi);
+  std::uniform_real_distribution<double> unit_d(-1., 1.);
+  // Ellipses: propagating for the time of flight from f0 leads to f1.
+  for (auto i = 0u; i < 1000u; ++i) {
+    const double sma = sma_d(rng_engine), ecc = ecc_d(rng_engine);
+    const double f0 = angle_d(rng_engine), f1 = angle_d(rng_engine);
+    const double tof = kep3::time_of_flight(f0, f1, sma, ecc, 1.);
+    REQUIRE(tof >= 0.);
+    REQUIRE(tof <= 2 * pi * std::sqrt(sma * sma * sma));
+    const auto pos_vel =
+        propagated(kep3::par2ic({sma, ecc, 0.3, 0.4, 0.5, f0}, 1.), tof);
+    REQUIRE(std::abs(std::remainder(kep3::ic2par(pos_vel, 1.)[5] - f1,
+                                    2 * pi)) < 1e-10);
+  }
+  // Hyperbolas: the same, only forward and within the asymptotes.
+  for (auto i = 0u; i < 1000u; ++i) {
+    const double sma = -sma_d(rng_engine), ecc = ecc_d(rng_engine) + 1.1;
+    const double f_inf = std::acos(-1. / ecc);
+    double f0 = 0.9 * f_inf * unit_d(rng_engine);
+    double f1 = 0.9 * f_inf * unit_d(rng_engine);
+    if (f1 < f0) {
+      REQUIRE(std::isnan(kep3::time_of_flight(f0, f1, sma, ecc, 1.)));
+      std::swap(f0, f1);
+    }
+    const double tof = kep3::time_of_flight(f0, f1, sma, ecc, 1.);
+    REQUIRE(tof >= 0.);
+    const auto pos_vel =
+        propagated(kep3::par2ic({sma, ecc, 0.3, 0.4, 0.5, f0}, 1.), tof);
+    REQUIRE(std::abs(std::remainder(kep3::ic2par(pos_vel, 1.)[5] - f1,
+                                    2 * pi)) < 1e-10);
+    // Beyond the asymptotes.
+    REQUIRE(std::isnan(
+        kep3::time_of_flight(f0, 0.5 * (f_inf + pi), sma, ecc, 1.)));
+  }
+  // From f = 0.5 to f = 0 on a circular orbit of sma 2: the time of flight
+  // is always forward, i.e. a full period minus 0.5 rad of anomaly.
+  REQUIRE(std::abs(kep3::time_of_flight(0.5, 0., 2., 0., 1.) -
+                   (2 * pi - 0.5) * std::sqrt(8.)) < 1e-13);
+  // Parabolas and inconsistent elements.
+  REQUIRE(std::isnan(kep3::time_of_flight(0., 1., 1., 1., 1.)));
+  REQUIRE(std::isnan(kep3::time_of_flight(0., 1., -1., 0.5, 1.)));
+  REQUIRE(std::isnan(kep3::time_of_flight(0., 1., 1., 1.5, 1.)));
+}
+
+TEST_CASE("time_to_events") {
+  for (bool hyperbola : {false, true}) {
+    for (const auto &pos_vel : random_states(1000u, hyperbola)) {
+      const auto par = kep3::ic2par(pos_vel, 1.);
+      const double sma = par[0], ecc = par[1];
+      // Periapsis.
+      const double t_peri = kep3::time_to_periapsis(pos_vel, 1.);
+      if (hyperbola && par[5] < pi) {
+        // Already past the periapsis.
+        REQUIRE(std::isnan(t_peri));
+      } else {
+        const auto pv = propagated(pos_vel, t_peri);
+        REQUIRE(std::abs(norm(pv[0]) - sma * (1. - ecc)) < 1e-10);
+      }
+      // Apoapsis.
+      const double t_apo = kep3::time_to_apoapsis(pos_vel, 1.);
+      if (hyperbola) {
+        REQUIRE(std::isnan(t_apo));
+      } else {
+        const auto pv = propagated(pos_vel, t_apo);
+        REQUIRE(std::abs(norm(pv[0]) - sma * (1. + ecc)) < 1e-10);
+      }
+      // Nodes: when they are reached, the body crosses the reference plane
+      // upwards or downwards.
+      const double t_asc = kep3::time_to_ascending_node(pos_vel, 1.);
+      const double t_desc = kep3::time_to_descending_node(pos_vel, 1.);
+      REQUIRE((hyperbola || !std::isnan(t_asc)));
+      REQUIRE((hyperbola || !std::isnan(t_desc)));
+      if (!std::isnan(t_asc)) {
+        const auto pv = propagated(pos_vel, t_asc);
+        REQUIRE(std::abs(pv[0][2]) < 1e-10 * norm(pv[0]));
+        REQUIRE(pv[1][2] > 0.);
+      }
+      if (!std::isnan(t_desc)) {
+        const auto pv = propagated(pos_vel, t_desc);
+        REQUIRE(std::abs(pv[0][2]) < 1e-10 * norm(pv[0]));
+        REQUIRE(pv[1][2] < 0.);
+      }
+      // A radius between the current one and the periapsis, crossed first
+      // on the way to the periapsis (on hyperbolas, only if the body is
+      // still approaching it).
+      const double R = 0.5 * (norm(pos_vel[0]) + sma * (1. - ecc));
+      const double t_R = kep3::time_to_radius(pos_vel, R, 1.);
+      if (hyperbola && dot(pos_vel[0], pos_vel[1]) > 0.) {
+        REQUIRE(std::isnan(t_R));
+      } else {
+        const auto pv = propagated(pos_vel, t_R);
+        REQUIRE(std::abs(norm(pv[0]) - R) < 1e-10 * R);
+        if (dot(pos_vel[0], pos_vel[1]) < 0.) {
+          REQUIRE(t_R < t_peri);
+        }
+      }
+      // A radius below the periapsis, which is never reached.
+      REQUIRE(std::isnan(
+          kep3::time_to_radius(pos_vel, 0.5 * sma * (1. - ecc), 1.)));
+      // The time to a true anomaly is that to the periapsis, for f = 0.
+      REQUIRE((std::isnan(t_peri) ||
+               kep3::time_to_true_anomaly(pos_vel, 0., 1.) == t_peri));
+    }
+  }
+  // Equatorial orbits have no nodes.
+  const pos_vel_t pos_vel = {{{1., 0., 0.}, {0., 1.1, 0.}}};
+  REQUIRE(std::isnan(kep3::time_to_ascending_node(pos_vel, 1.)));
+  REQUIRE(std::isnan(kep3::time_to_descending_node(pos_vel, 1.)));
+  REQUIRE(std::abs(kep3::time_to_periapsis(pos_vel, 1.)) < 1e-13);
+}
+
+TEST_CASE("time_to_events_batch") {
+  // Half ellipses and half hyperbolas, on an odd number of states so as to
+  // span more than one chunk of elements.
+  auto states = random_states(301u, false);
+  const auto states_h = random_states(300u, true);
+  states.insert(states.end(), states_h.begin(), states_h.end());
+  const std::size_t n = states.size();
+  std::array<std::vector<double>, 6> soa;
+  for (auto c = 0u; c < 6u; ++c) {
+    soa[c].resize(n);
+    for (std::size_t i = 0u; i < n; ++i) {
+      soa[c][i] = states[i][c / 3u][c % 3u];
+    }
+  }
+  const kep3::elements_batch_input pos_vel = {soa[0], soa[1], soa[2],
+                                              soa[3], soa[4], soa[5]};
+  std::vector<double> out(n), target(n);
+  for (std::size_t i = 0u; i < n; ++i) {
+    target[i] = 0.9 * norm(states[i][0]);
+  }
+  // The batch and scalar versions agree (NaNs included).
+  const auto check = [&](auto scalar) {
+    for (std::size_t i = 0u; i < n; ++i) {
+      const double t = scalar(states[i], i);
+      REQUIRE(std::isnan(t) == std::isnan(out[i]));
+      if (!std::isnan(t)) {
+        REQUIRE(std::abs(out[i] - t) <= 1e-10 * std::max(1., std::abs(t)));
+      }
+    }
+  };
+  kep3::time_to_periapsis_batch(pos_vel, 1., out);
+  check([](const auto &pv, std::size_t) {
+    return kep3::time_to_periapsis(pv, 1.);
+  });
+  kep3::time_to_apoapsis_batch(pos_vel, 1., out);
+  check([](const auto &pv, std::size_t) {
+    return kep3::time_to_apoapsis(pv, 1.);
+  });
+  kep3::time_to_ascending_node_batch(pos_vel, 1., out);
+  check([](const auto &pv, std::size_t) {
+    return kep3::time_to_ascending_node(pv, 1.);
+  });
+  kep3::time_to_descending_node_batch(pos_vel, 1., out);
+  check([](const auto &pv, std::size_t) {
+    return kep3::time_to_descending_node(pv, 1.);
+  });
+  kep3::time_to_radius_batch(pos_vel, target, 1., out);
+  check([&](const auto &pv, std::size_t i) {
+    return kep3::time_to_radius(pv, target[i], 1.);
+  });
+  // Targets of size one are used for all the states.
+  const std::array<double, 1> f = {1.};
+  kep3::time_to_true_anomaly_batch(pos_vel, f, 1., out);
+  check([](const auto &pv, std::size_t) {
+    return kep3::time_to_true_anomaly(pv, 1., 1.);
+  });
+  std::vector<double> sma(n), ecc(n);
+  for (std::size_t i = 0u; i < n; ++i) {
+    const auto par = kep3::ic2par(states[i], 1.);
+    sma[i] = par[0];
+    ecc[i] = par[1];
+  }
+  kep3::time_of_flight_batch(f, target, sma, ecc, 1., out);
+  for (std::size_t i = 0u; i < n; ++i) {
+    const double t = kep3::time_of_flight(1., target[i], sma[i], ecc[i], 1.);
+    REQUIRE(((std::isnan(t) && std::isnan(out[i])) || out[i] == t));
+  }
+  // Inconsistent sizes.
+  target.pop_back();
+  REQUIRE_THROWS_AS(kep3::time_to_radius_batch(pos_vel, target, 1., out),
+                    std::invalid_argument);
+  REQUIRE_THROWS_AS(kep3::time_of_flight_batch(f, target, sma, ecc, 1., out),
+                    std::invalid_argument);
+  out.pop_back();
+  REQUIRE_THROWS_AS(kep3::time_to_periapsis_batch(pos_vel, 1., out),
+                    std::invalid_argument);
+}
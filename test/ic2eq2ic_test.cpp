@@ -7,7 +7,9 @@
 // Public License v. 2.0. If a copy of the MPL was not distributed
 // with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
 
+#include <array>
 #include <cmath>
+#include <random>
 #include <stdexcept>
 
 #include <fmt/core.h>
@@ -239,3 +241,58 @@ TEST_CASE("ic2eq2ic_retrogade") {
     }
   }
 }
+
+TEST_CASE("ic2eq2ic_jac") {
+  // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+  std::mt19937 rng_engine(122012203u);
+  // Away from the singularities of the elements (equatorial orbits, prograde
+  // or retrograde).
+  std::uniform_real_distribution<double> sma_d(1.1, 10.);
+  std::uniform_real_distribution<double> ecc_d(0., 0.9);
+  std::uniform_real_distribution<double> incl_d(0.1, pi - 0.1);
+  std::uniform_real_distribution<double> angle_d(0., 2 * pi);
+  const auto to_pv = [](const std::array<double, 6> &x) {
+    return std::array<std::array<double, 3>, 2>{
+        {{x[0], x[1], x[2]}, {x[3], x[4], x[5]}}};
+  };
+  const auto from_pv = [](const std::array<std::array<double, 3>, 2> &pv) {
+    return std::array<double, 6>{pv[0][0], pv[0][1], pv[0][2],
+                                 pv[1][0], pv[1][1], pv[1][2]};
+  };
+  for (bool retrogade : {false, true}) {
+    for (auto i = 0u; i < 1000u; ++i) {
+      const auto pos_vel = kep3::par2ic(
+          {sma_d(rng_engine), ecc_d(rng_engine), incl_d(rng_engine),
+           angle_d(rng_engine), angle_d(rng_engine), angle_d(rng_engine)},
+          1.);
+      const auto eq = ic2eq(pos_vel, 1., retrogade);
+      // ic2eq.
+      {
+        const auto [val, jac] = kep3::ic2eq_jac(pos_vel, 1., retrogade);
+        for (auto k = 0u; k < 6u; ++k) {
+          REQUIRE(kep3_tests::floating_point_error(val[k], eq[k]) < 1e-14);
+        }
+        REQUIRE(kep3_tests::jacobian_error(
+                    [&](const auto &x) {
+                      return ic2eq(to_pv(x), 1., retrogade);
+                    },
+                    from_pv(pos_vel), jac,
+                    {false, false, false, false, false, true}) < 1e-5);
+      }
+      // eq2ic.
+      {
+        const auto [val, jac] = kep3::eq2ic_jac(eq, 1., retrogade);
+        const auto ref = eq2ic(eq, 1., retrogade);
+        REQUIRE(kep3_tests::floating_point_error_vector(val[0], ref[0]) <
+                1e-14);
+        REQUIRE(kep3_tests::floating_point_error_vector(val[1], ref[1]) <
+                1e-14);
+        REQUIRE(kep3_tests::jacobian_error(
+                    [&](const auto &x) {
+                      return from_pv(eq2ic(x, 1., retrogade));
+                    },
+                    eq, jac) < 1e-5);
+      }
+    }
+  }
+}
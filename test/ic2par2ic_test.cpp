@@ -7,6 +7,9 @@
 // Public License v. 2.0. If a copy of the MPL was not distributed
 // with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
 
+#include <array>
+#include <cmath>
+#include <random>
 #include <stdexcept>
 
 #include <fmt/core.h>
@@ -226,3 +229,70 @@ TEST_CASE("ic2par2ic") {
     }
   }
 }
+
+TEST_CASE("ic2par2ic_jac") {
+  // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+  std::mt19937 rng_engine(122012203u);
+  // Away from the singularities of the elements (circular and equatorial
+  // orbits).
+  std::uniform_real_distribution<double> sma_d(1.1, 10.);
+  std::uniform_real_distribution<double> ecc_d(0.05, 0.9);
+  std::uniform_real_distribution<double> incl_d(0.1, pi - 0.1);
+  std::uniform_real_distribution<double> angle_d(0., 2 * pi);
+  const auto to_pv = [](const std::array<double, 6> &x) {
+    return std::array<std::array<double, 3>, 2>{
+        {{x[0], x[1], x[2]}, {x[3], x[4], x[5]}}};
+  };
+  const auto from_pv = [](const std::array<std::array<double, 3>, 2> &pv) {
+    return std::array<double, 6>{pv[0][0], pv[0][1], pv[0][2],
+                                 pv[1][0], pv[1][1], pv[1][2]};
+  };
+  for (auto i = 0u; i < 1000u; ++i) {
+    const std::array<double, 6> par = {
+        sma_d(rng_engine),   ecc_d(rng_engine),   incl_d(rng_engine),
+        angle_d(rng_engine), angle_d(rng_engine), angle_d(rng_engine)};
+    const auto pos_vel = par2ic(par, 1.);
+    // ic2par.
+    {
+      const auto [val, jac] = kep3::ic2par_jac(pos_vel, 1.);
+      const auto ref = ic2par(pos_vel, 1.);
+      for (auto k = 0u; k < 6u; ++k) {
+        REQUIRE(kep3_tests::floating_point_error(val[k], ref[k]) < 1e-14);
+      }
+      REQUIRE(kep3_tests::jacobian_error(
+                  [&](const auto &x) { return ic2par(to_pv(x), 1.); },
+                  from_pv(pos_vel), jac,
+                  {false, false, false, true, true, true}) < 1e-5);
+    }
+    // par2ic.
+    {
+      const auto [val, jac] = kep3::par2ic_jac(par, 1.);
+      REQUIRE(kep3_tests::floating_point_error_vector(val[0], pos_vel[0]) <
+              1e-14);
+      REQUIRE(kep3_tests::floating_point_error_vector(val[1], pos_vel[1]) <
+              1e-14);
+      REQUIRE(kep3_tests::jacobian_error(
+                  [&](const auto &x) { return from_pv(par2ic(x, 1.)); }, par,
+                  jac) < 1e-5);
+    }
+  }
+  // Hyperbolas.
+  for (auto i = 0u; i < 1000u; ++i) {
+    const double ecc = ecc_d(rng_engine) + 1.1;
+    // The true anomaly within the asymptotes.
+    const double ni =
+        (2. * angle_d(rng_engine) / (2 * pi) - 1.) * 0.9 * std::acos(-1. / ecc);
+    const std::array<double, 6> par = {
+        -sma_d(rng_engine),  ecc, incl_d(rng_engine), angle_d(rng_engine),
+        angle_d(rng_engine), ni};
+    const auto [val, jac] = kep3::par2ic_jac(par, 1.);
+    REQUIRE(kep3_tests::jacobian_error(
+                [&](const auto &x) { return from_pv(par2ic(x, 1.)); }, par,
+                jac) < 1e-5);
+    const auto [val2, jac2] = kep3::ic2par_jac(val, 1.);
+    REQUIRE(kep3_tests::jacobian_error(
+                [&](const auto &x) { return ic2par(to_pv(x), 1.); },
+                from_pv(val), jac2,
+                {false, false, false, true, true, true}) < 1e-5);
+  }
+}
@@ -0,0 +1,154 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <kep3/core_astro/constants.hpp>
+#include <kep3/core_astro/elements_batch.hpp>
+#include <kep3/core_astro/ic2eq2ic.hpp>
+#include <kep3/core_astro/ic2par2ic.hpp>
+#include <kep3/core_astro/jit_batch.hpp>
+#include <kep3/core_astro/propagate_lagrangian.hpp>
+
+#include "catch.hpp"
+#include "test_helpers.hpp"
+
+using kep3::elements_batch_input;
+using kep3::elements_batch_output;
+using kep3::pi;
+
+namespace {
+
+// Six arrays of n values.
+struct soa {
+  std::array<std::vector<double>, 6> data;
+  explicit soa(std::size_t n) {
+    for (auto &v : data) {
+      v.resize(n);
+    }
+  }
+  [[nodiscard]] elements_batch_input in() const {
+    return {data[0], data[1], data[2], data[3], data[4], data[5]};
+  }
+  [[nodiscard]] elements_batch_output out() {
+    return {data[0], data[1], data[2], data[3], data[4], data[5]};
+  }
+  [[nodiscard]] std::array<double, 6> get(std::size_t i) const {
+    return {data[0][i], data[1][i], data[2][i],
+            data[3][i], data[4][i], data[5][i]};
+  }
+  void set(std::size_t i, const std::array<double, 6> &x) {
+    for (auto k = 0u; k < 6u; ++k) {
+      data[k][i] = x[k];
+    }
+  }
+};
+
+// Random elliptic Keplerian elements. An odd size exercises the partial
+// SIMD batches of the kernels.
+soa random_par(std::size_t n) {
+  // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+  std::mt19937 rng_engine(122012203u);
+  std::uniform_real_distribution<double> sma_d(1.1, 100.);
+  std::uniform_real_distribution<double> ecc_d(0, 0.99);
+  std::uniform_real_distribution<double> incl_d(0.01, pi - 0.01);
+  std::uniform_real_distribution<double> angle_d(0., 2 * pi);
+  soa par(n);
+  for (auto i = 0u; i < n; ++i) {
+    par.set(i, {sma_d(rng_engine), ecc_d(rng_engine), incl_d(rng_engine),
+                angle_d(rng_engine), angle_d(rng_engine),
+                angle_d(rng_engine)});
+  }
+  return par;
+}
+
+// Largest error between the cartesian states in a and b.
+double pos_vel_error(const soa &a, const soa &b) {
+  double err = 0.;
+  for (std::size_t i = 0u; i < a.data[0].size(); ++i) {
+    const auto x = a.get(i), y = b.get(i);
+    err = std::max(
+        err, std::max(kep3_tests::floating_point_error_vector(
+                          std::array<double, 3>{x[0], x[1], x[2]},
+                          std::array<double, 3>{y[0], y[1], y[2]}),
+                      kep3_tests::floating_point_error_vector(
+                          std::array<double, 3>{x[3], x[4], x[5]},
+                          std::array<double, 3>{y[3], y[4], y[5]})));
+  }
+  return err;
+}
+
+} // namespace
+
+TEST_CASE("par2ic_jit_batch") {
+  const std::size_t n = 1001u;
+  const auto par = random_par(n);
+  soa pos_vel(n), pos_vel_ref(n);
+  kep3::par2ic_jit_batch(par.in(), 1.3, pos_vel.out());
+  for (auto i = 0u; i < n; ++i) {
+    const auto [r, v] = kep3::par2ic(par.get(i), 1.3);
+    pos_vel_ref.set(i, {r[0], r[1], r[2], v[0], v[1], v[2]});
+  }
+  REQUIRE(pos_vel_error(pos_vel, pos_vel_ref) < 1e-12);
+}
+
+TEST_CASE("eq2ic_jit_batch") {
+  const std::size_t n = 1001u;
+  const auto par = random_par(n);
+  for (bool retrogade : {false, true}) {
+    soa eq(n), pos_vel(n), pos_vel_ref(n);
+    for (auto i = 0u; i < n; ++i) {
+      eq.set(i, kep3::ic2eq(kep3::par2ic(par.get(i), 1.), 1., retrogade));
+    }
+    kep3::eq2ic_jit_batch(eq.in(), 1., pos_vel.out(), retrogade);
+    for (auto i = 0u; i < n; ++i) {
+      const auto [r, v] = kep3::eq2ic(eq.get(i), 1., retrogade);
+      pos_vel_ref.set(i, {r[0], r[1], r[2], v[0], v[1], v[2]});
+    }
+    REQUIRE(pos_vel_error(pos_vel, pos_vel_ref) < 1e-12);
+  }
+}
+
+TEST_CASE("propagate_lagrangian_jit_batch") {
+  const std::size_t n = 1001u;
+  const auto par = random_par(n);
+  // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+  std::mt19937 rng_engine(122012203u);
+  std::uniform_real_distribution<double> dt_d(-100., 100.);
+  soa pos_vel(n), pos_vel_new(n), pos_vel_ref(n);
+  std::vector<double> dt(n);
+  for (auto i = 0u; i < n; ++i) {
+    auto pv = kep3::par2ic(par.get(i), 1.);
+    pos_vel.set(i, {pv[0][0], pv[0][1], pv[0][2], pv[1][0], pv[1][1],
+                    pv[1][2]});
+    dt[i] = dt_d(rng_engine);
+    kep3::propagate_lagrangian(pv, dt[i], 1.);
+    pos_vel_ref.set(i, {pv[0][0], pv[0][1], pv[0][2], pv[1][0], pv[1][1],
+                        pv[1][2]});
+  }
+  kep3::propagate_lagrangian_jit_batch(pos_vel.in(), dt, 1.,
+                                       pos_vel_new.out());
+  REQUIRE(pos_vel_error(pos_vel_new, pos_vel_ref) < 1e-11);
+  // Inconsistent sizes.
+  dt.pop_back();
+  REQUIRE_THROWS_AS(kep3::propagate_lagrangian_jit_batch(pos_vel.in(), dt, 1.,
+                                                         pos_vel_new.out()),
+                    std::invalid_argument);
+  soa small(n - 1u);
+  REQUIRE_THROWS_AS(kep3::par2ic_jit_batch(par.in(), 1., small.out()),
+                    std::invalid_argument);
+  // Empty batches are fine.
+  soa empty(0u);
+  REQUIRE_NOTHROW(kep3::eq2ic_jit_batch(empty.in(), 1., empty.out()));
+}
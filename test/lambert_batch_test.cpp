@@ -0,0 +1,312 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <array>
+#include <cmath>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include <kep3/core_astro/constants.hpp>
+#include <kep3/lambert_batch.hpp>
+#include <kep3/lambert_bounds.hpp>
+#include <kep3/lambert_problem.hpp>
+#include <kep3/lambert_solve.hpp>
+
+#include "catch.hpp"
+#include "test_helpers.hpp"
+
+// SoA storage for a batch of problems and its solutions.
+struct batch_data {
+  explicit batch_data(std::size_t n)
+      : r1x(n), r1y(n), r1z(n), r2x(n), r2y(n), r2z(n), tof(n), mu(n), v1x(n),
+        v1y(n), v1z(n), v2x(n), v2y(n), v2z(n), x(n), status(n), iters(n) {}
+  std::vector<double> r1x, r1y, r1z, r2x, r2y, r2z, tof, mu;
+  std::vector<double> v1x, v1y, v1z, v2x, v2y, v2z, x;
+  std::vector<kep3::lambert_status> status;
+  std::vector<unsigned> iters;
+  [[nodiscard]] kep3::lambert_batch_input input() const {
+    return {r1x, r1y, r1z, r2x, r2y, r2z, tof, mu};
+  }
+  kep3::lambert_batch_output output() {
+    return {v1x, v1y, v1z, v2x, v2y, v2z, status, x, iters};
+  }
+};
+
+TEST_CASE("lambert_batch_vs_lambert_problem") {
+  // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+  std::mt19937 rng_engine(12201203u);
+  std::uniform_real_distribution<double> r_d(-2, 2);
+  std::uniform_real_distribution<double> tof_d(2., 40.);
+  std::uniform_real_distribution<double> mu_d(0.9, 1.1);
+  const std::size_t n = 1000u;
+  batch_data data(n);
+  for (auto i = 0u; i < n; ++i) {
+    data.r1x[i] = r_d(rng_engine);
+    data.r1y[i] = r_d(rng_engine);
+    data.r1z[i] = r_d(rng_engine);
+    data.r2x[i] = r_d(rng_engine);
+    data.r2y[i] = r_d(rng_engine);
+    data.r2z[i] = r_d(rng_engine);
+    data.tof[i] = tof_d(rng_engine);
+    data.mu[i] = mu_d(rng_engine);
+  }
+  for (bool cw : {false, true}) {
+    for (kep3::lambert_branch branch : {kep3::lambert_branch{0u, false},
+                                        kep3::lambert_branch{2u, false},
+                                        kep3::lambert_branch{2u, true}}) {
+      kep3::lambert_batch(data.input(), data.output(), cw, branch);
+      for (auto i = 0u; i < n; ++i) {
+        kep3::lambert_problem lp({data.r1x[i], data.r1y[i], data.r1z[i]},
+                                 {data.r2x[i], data.r2y[i], data.r2z[i]},
+                                 data.tof[i], data.mu[i], cw, branch.N);
+        if (lp.get_Nmax() < branch.N) {
+          REQUIRE(data.status[i] == kep3::lambert_status::no_solution);
+          REQUIRE(std::isnan(data.v1x[i]));
+          continue;
+        }
+        const auto idx = (branch.N == 0u) ? 0u : 2u * branch.N - 1u + branch.right;
+        REQUIRE(data.status[i] == kep3::lambert_status::success);
+        REQUIRE(data.x[i] == lp.get_x()[idx]);
+        REQUIRE(data.iters[i] == lp.get_iters()[idx]);
+        REQUIRE(kep3_tests::floating_point_error_vector(
+                    {data.v1x[i], data.v1y[i], data.v1z[i]}, lp.get_v1()[idx]) <
+                1e-14);
+        REQUIRE(kep3_tests::floating_point_error_vector(
+                    {data.v2x[i], data.v2y[i], data.v2z[i]}, lp.get_v2()[idx]) <
+                1e-14);
+      }
+    }
+  }
+}
+
+TEST_CASE("lambert_batch_lanes") {
+  // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+  std::mt19937 rng_engine(12201203u);
+  std::uniform_real_distribution<double> r_d(-2, 2);
+  std::uniform_real_distribution<double> tof_d(0.1, 40.);
+  // A size which is not a multiple of the numbers of lanes, so that the last
+  // chunk is only partially filled.
+  const std::size_t n = 1003u;
+  batch_data data(n), ref(n);
+  for (auto i = 0u; i < n; ++i) {
+    data.r1x[i] = r_d(rng_engine);
+    data.r1y[i] = r_d(rng_engine);
+    data.r1z[i] = r_d(rng_engine);
+    data.r2x[i] = r_d(rng_engine);
+    data.r2y[i] = r_d(rng_engine);
+    data.r2z[i] = r_d(rng_engine);
+    data.tof[i] = tof_d(rng_engine);
+    data.mu[i] = 1.;
+  }
+  // Some invalid problems mixed in.
+  data.tof[5] = -1.;
+  data.mu[17] = 0.;
+  data.r1z[42] = 0.;
+  data.r2z[42] = 0.;
+  data.r1x[42] = 0.;
+  data.r2x[42] = 0.;
+  for (bool cw : {false, true}) {
+    kep3::lambert_batch(data.input(), ref.output(), cw);
+    for (unsigned lanes : {4u, 8u}) {
+      kep3::lambert_batch_lanes(data.input(), data.output(), cw, lanes);
+      for (auto i = 0u; i < n; ++i) {
+        REQUIRE(data.status[i] == ref.status[i]);
+        if (ref.status[i] != kep3::lambert_status::success) {
+          REQUIRE(std::isnan(data.v1x[i]));
+          continue;
+        }
+        REQUIRE(data.iters[i] == ref.iters[i]);
+        REQUIRE(std::abs(data.x[i] - ref.x[i]) < 1e-14);
+        REQUIRE(kep3_tests::floating_point_error_vector(
+                    {data.v1x[i], data.v1y[i], data.v1z[i]},
+                    {ref.v1x[i], ref.v1y[i], ref.v1z[i]}) < 1e-14);
+        REQUIRE(kep3_tests::floating_point_error_vector(
+                    {data.v2x[i], data.v2y[i], data.v2z[i]},
+                    {ref.v2x[i], ref.v2y[i], ref.v2z[i]}) < 1e-14);
+      }
+    }
+  }
+  REQUIRE(data.status[5] == kep3::lambert_status::invalid_tof);
+  REQUIRE(data.status[17] == kep3::lambert_status::invalid_mu);
+  REQUIRE(data.status[42] == kep3::lambert_status::degenerate_geometry);
+  REQUIRE_THROWS_AS(
+      kep3::lambert_batch_lanes(data.input(), data.output(), false, 3u),
+      std::invalid_argument);
+}
+
+TEST_CASE("lambert_sweep") {
+  // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+  std::mt19937 rng_engine(12201203u);
+  std::uniform_real_distribution<double> r_d(-2, 2);
+  const std::size_t n = 300u;
+  batch_data data(n);
+  std::vector<double> tof(n);
+  for (auto i = 0u; i < n; ++i) {
+    tof[i] = 0.2 + 0.2 * i;
+  }
+  unsigned long iters = 0u, count = 0u;
+  for (auto trial = 0u; trial < 100u; ++trial) {
+    const std::array<double, 3> r1{r_d(rng_engine), r_d(rng_engine),
+                                   r_d(rng_engine)};
+    const std::array<double, 3> r2{r_d(rng_engine), r_d(rng_engine),
+                                   r_d(rng_engine)};
+    for (bool cw : {false, true}) {
+      for (kep3::lambert_branch branch :
+           {kep3::lambert_branch{0u, false}, kep3::lambert_branch{1u, false},
+            kep3::lambert_branch{1u, true}, kep3::lambert_branch{3u, true}}) {
+        kep3::lambert_sweep(r1, r2, tof, 1.1, data.output(), cw, branch);
+        for (auto i = 0u; i < n; ++i) {
+          const auto sol = kep3::lambert_solve(r1, r2, tof[i], 1.1, cw, branch);
+          REQUIRE(data.status[i] == sol.status);
+          if (sol.status != kep3::lambert_status::success) {
+            REQUIRE(std::isnan(data.v1x[i]));
+            continue;
+          }
+          REQUIRE(kep3_tests::floating_point_error_vector(
+                      {data.v1x[i], data.v1y[i], data.v1z[i]}, sol.v1) < 1e-11);
+          REQUIRE(kep3_tests::floating_point_error_vector(
+                      {data.v2x[i], data.v2y[i], data.v2z[i]}, sol.v2) < 1e-11);
+          if (branch.N == 0u) {
+            iters += data.iters[i];
+            ++count;
+          }
+        }
+      }
+    }
+  }
+  // Warm starting should need (much) less than two iterations on average.
+  REQUIRE(static_cast<double>(iters) / static_cast<double>(count) < 2.);
+  // Times of flight around the minimum one of the branch, where the tabulated
+  // curve cannot decide whether the branch exists.
+  {
+    const std::array<double, 3> r1{1., 0., 0.}, r2{-0.3, 1.1, 0.2};
+    for (kep3::lambert_branch branch :
+         {kep3::lambert_branch{1u, false}, kep3::lambert_branch{2u, true}}) {
+      const double tof_min = kep3::lambert_tof_min(r1, r2, 1., false, branch.N);
+      std::vector<double> tof_near;
+      for (double rel : {-1e-6, -1e-10, -1e-14, 0., 1e-14, 1e-10, 1e-6}) {
+        tof_near.push_back(tof_min * (1. + rel));
+      }
+      batch_data near(tof_near.size());
+      kep3::lambert_sweep(r1, r2, tof_near, 1., near.output(), false, branch);
+      REQUIRE(near.status.front() == kep3::lambert_status::no_solution);
+      REQUIRE(near.status.back() == kep3::lambert_status::success);
+      for (auto i = 0u; i < tof_near.size(); ++i) {
+        REQUIRE(near.status[i] ==
+                kep3::lambert_solve(r1, r2, tof_near[i], 1., false, branch)
+                    .status);
+      }
+    }
+  }
+  // Degenerate geometry and invalid inputs.
+  tof[3] = -1.;
+  kep3::lambert_sweep({1., 0., 0.}, {0., 1., 0.}, tof, 1., data.output());
+  REQUIRE(data.status[2] == kep3::lambert_status::success);
+  REQUIRE(data.status[3] == kep3::lambert_status::invalid_tof);
+  kep3::lambert_sweep({0., 0., 1.}, {0., 1., 0.}, tof, 1., data.output());
+  REQUIRE(data.status[0] == kep3::lambert_status::degenerate_geometry);
+  kep3::lambert_sweep({1., 0., 0.}, {0., 1., 0.}, tof, -1., data.output());
+  REQUIRE(data.status[0] == kep3::lambert_status::invalid_mu);
+  REQUIRE_THROWS_AS(kep3::lambert_sweep({1., 0., 0.}, {0., 1., 0.},
+                                        std::span<const double>(tof).subspan(1),
+                                        1., data.output()),
+                    std::invalid_argument);
+}
+
+TEST_CASE("lambert_one_to_many") {
+  // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+  std::mt19937 rng_engine(12201203u);
+  std::uniform_real_distribution<double> r_d(-2, 2);
+  std::uniform_real_distribution<double> tof_d(2., 40.);
+  const std::size_t n = 1000u;
+  batch_data data(n);
+  for (auto i = 0u; i < n; ++i) {
+    data.r2x[i] = r_d(rng_engine);
+    data.r2y[i] = r_d(rng_engine);
+    data.r2z[i] = r_d(rng_engine);
+    data.tof[i] = tof_d(rng_engine);
+  }
+  data.tof[7] = 0.;
+  const std::array<double, 3> r1{1., 0.2, -0.3};
+  for (bool cw : {false, true}) {
+    for (kep3::lambert_branch branch : {kep3::lambert_branch{0u, false},
+                                        kep3::lambert_branch{2u, true}}) {
+      kep3::lambert_one_to_many(r1, data.r2x, data.r2y, data.r2z, data.tof, 1.,
+                                data.output(), cw, branch);
+      for (auto i = 0u; i < n; ++i) {
+        const auto sol = kep3::lambert_solve(
+            r1, {data.r2x[i], data.r2y[i], data.r2z[i]}, data.tof[i], 1., cw,
+            branch);
+        REQUIRE(data.status[i] == sol.status);
+        if (sol.status != kep3::lambert_status::success) {
+          REQUIRE(std::isnan(data.v1x[i]));
+          continue;
+        }
+        REQUIRE(data.x[i] == sol.x);
+        REQUIRE(std::array<double, 3>{data.v1x[i], data.v1y[i], data.v1z[i]} ==
+                sol.v1);
+        REQUIRE(std::array<double, 3>{data.v2x[i], data.v2y[i], data.v2z[i]} ==
+                sol.v2);
+      }
+    }
+  }
+  REQUIRE(data.status[7] == kep3::lambert_status::invalid_tof);
+  // A single tof for all targets.
+  const std::array<double, 1> tof{10.};
+  kep3::lambert_one_to_many(r1, data.r2x, data.r2y, data.r2z, tof, 1.,
+                            data.output());
+  REQUIRE(data.status[7] == kep3::lambert_status::success);
+  REQUIRE_THROWS_AS(kep3::lambert_one_to_many(
+                        r1, data.r2x, data.r2y,
+                        std::span<const double>(data.r2z).subspan(1), tof, 1.,
+                        data.output()),
+                    std::invalid_argument);
+}
+
+TEST_CASE("lambert_batch_status") {
+  batch_data data(4u);
+  // A valid problem, one with negative tof, one with negative mu and a
+  // degenerate one.
+  data.r1x = {1., 1., 1., 0.};
+  data.r1y = {0., 0., 0., 0.};
+  data.r1z = {0., 0., 0., 1.};
+  data.r2x = {0., 0., 0., 0.};
+  data.r2y = {1., 1., 1., 1.};
+  data.r2z = {0., 0., 0., 0.};
+  data.tof = {3 * kep3::pi / 2, -1., 1., 1.};
+  data.mu = {1., 1., -1., 1.};
+  kep3::lambert_batch(data.input(), data.output(), true);
+  REQUIRE(data.status[0] == kep3::lambert_status::success);
+  REQUIRE(kep3_tests::floating_point_error_vector(
+              {data.v1x[0], data.v1y[0], data.v1z[0]}, {0, -1, 0}) < 1e-13);
+  REQUIRE(data.status[1] == kep3::lambert_status::invalid_tof);
+  REQUIRE(data.status[2] == kep3::lambert_status::invalid_mu);
+  REQUIRE(data.status[3] == kep3::lambert_status::degenerate_geometry);
+  for (auto i = 1u; i < 4u; ++i) {
+    REQUIRE(std::isnan(data.v1x[i]));
+    REQUIRE(std::isnan(data.v2z[i]));
+  }
+  // A single mu can be used for the whole batch.
+  const std::array<double, 1> mu{1.};
+  auto in = data.input();
+  in.mu = mu;
+  kep3::lambert_batch(in, data.output(), true);
+  REQUIRE(data.status[2] == kep3::lambert_status::success);
+  // Optional outputs can be omitted.
+  auto out = data.output();
+  out.x = {};
+  out.iters = {};
+  REQUIRE_NOTHROW(kep3::lambert_batch(in, out, true));
+  // Inconsistent sizes.
+  in.tof = in.tof.subspan(1);
+  REQUIRE_THROWS_AS(kep3::lambert_batch(in, data.output()),
+                    std::invalid_argument);
+}
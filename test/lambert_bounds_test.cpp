@@ -0,0 +1,144 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+#include <kep3/lambert_bounds.hpp>
+#include <kep3/lambert_problem.hpp>
+
+#include "catch.hpp"
+
+namespace {
+double norm_diff(const std::array<double, 3> &a,
+                 const std::array<double, 3> &b) {
+  return std::sqrt((a[0] - b[0]) * (a[0] - b[0]) +
+                   (a[1] - b[1]) * (a[1] - b[1]) +
+                   (a[2] - b[2]) * (a[2] - b[2]));
+}
+} // namespace
+
+TEST_CASE("tof") {
+  // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+  std::mt19937 rng_engine(122012203u);
+  std::uniform_int_distribution<unsigned> cw_d(0, 1);
+  std::uniform_real_distribution<double> r_d(-2, 2);
+  std::uniform_real_distribution<double> mu_d(0.9, 1.1);
+  for (auto i = 0u; i < 1000u; ++i) {
+    const std::array<double, 3> r1{r_d(rng_engine), r_d(rng_engine),
+                                   r_d(rng_engine)};
+    const std::array<double, 3> r2{r_d(rng_engine), r_d(rng_engine),
+                                   r_d(rng_engine)};
+    const double mu = mu_d(rng_engine);
+    const bool cw = static_cast<bool>(cw_d(rng_engine));
+    // The parabolic and minimum energy transfers have x = 1 and x = 0.
+    // NOTE: the solver is singular at x = 1, so the parabolic time of flight
+    // is checked to separate elliptic and hyperbolic solutions.
+    {
+      const double tof_p = kep3::lambert_tof_parabolic(r1, r2, mu, cw);
+      const kep3::lambert_problem lp_e(r1, r2, tof_p * (1. + 1e-6), mu, cw, 0u);
+      const kep3::lambert_problem lp_h(r1, r2, tof_p * (1. - 1e-6), mu, cw, 0u);
+      REQUIRE(lp_e.get_x()[0] < 1.);
+      REQUIRE(lp_h.get_x()[0] > 1.);
+    }
+    {
+      const kep3::lambert_problem lp(
+          r1, r2, kep3::lambert_tof_min_energy(r1, r2, mu, cw), mu, cw, 0u);
+      REQUIRE(std::abs(lp.get_x()[0]) < 1e-6);
+    }
+    {
+      const kep3::lambert_problem lp(
+          r1, r2, kep3::lambert_tof_min_energy(r1, r2, mu, cw, 2u), mu, cw, 2u);
+      REQUIRE(lp.get_Nmax() == 2u);
+      // x = 0 lies on the left or on the right branch, depending on lambda.
+      REQUIRE(std::min(std::abs(lp.get_x()[3]), std::abs(lp.get_x()[4])) <
+              1e-6);
+    }
+    // The number of revolutions changes across the minimum time of flight.
+    REQUIRE(kep3::lambert_tof_min(r1, r2, mu, cw, 0u) == 0.);
+    for (auto N = 1u; N < 4u; ++N) {
+      const double tof_min = kep3::lambert_tof_min(r1, r2, mu, cw, N);
+      REQUIRE(kep3::lambert_Nmax(r1, r2, tof_min * (1. - 1e-6), mu, cw) ==
+              N - 1u);
+      REQUIRE(kep3::lambert_Nmax(r1, r2, tof_min * (1. + 1e-6), mu, cw) == N);
+    }
+  }
+}
+
+TEST_CASE("Nmax") {
+  // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+  std::mt19937 rng_engine(122012203u);
+  std::uniform_int_distribution<unsigned> cw_d(0, 1);
+  std::uniform_real_distribution<double> r_d(-2, 2);
+  std::uniform_real_distribution<double> tof_d(0.1, 40.);
+  std::uniform_real_distribution<double> mu_d(0.9, 1.1);
+  for (auto i = 0u; i < 1000u; ++i) {
+    const std::array<double, 3> r1{r_d(rng_engine), r_d(rng_engine),
+                                   r_d(rng_engine)};
+    const std::array<double, 3> r2{r_d(rng_engine), r_d(rng_engine),
+                                   r_d(rng_engine)};
+    const double tof = tof_d(rng_engine);
+    const double mu = mu_d(rng_engine);
+    const bool cw = static_cast<bool>(cw_d(rng_engine));
+    const kep3::lambert_problem lp(r1, r2, tof, mu, cw, 10u);
+    REQUIRE(kep3::lambert_Nmax(r1, r2, tof, mu, cw, 10u) == lp.get_Nmax());
+  }
+}
+
+TEST_CASE("dv_lower_bound") {
+  // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+  std::mt19937 rng_engine(122012203u);
+  std::uniform_int_distribution<unsigned> cw_d(0, 1);
+  std::uniform_real_distribution<double> r_d(-2, 2);
+  std::uniform_real_distribution<double> v_d(-1, 1);
+  std::uniform_real_distribution<double> tof_d(0.1, 40.);
+  std::uniform_real_distribution<double> mu_d(0.9, 1.1);
+  for (auto i = 0u; i < 5000u; ++i) {
+    const std::array<double, 3> r1{r_d(rng_engine), r_d(rng_engine),
+                                   r_d(rng_engine)};
+    const std::array<double, 3> r2{r_d(rng_engine), r_d(rng_engine),
+                                   r_d(rng_engine)};
+    const std::array<double, 3> v_dep{v_d(rng_engine), v_d(rng_engine),
+                                      v_d(rng_engine)};
+    const std::array<double, 3> v_arr{v_d(rng_engine), v_d(rng_engine),
+                                      v_d(rng_engine)};
+    const double tof = tof_d(rng_engine);
+    const double mu = mu_d(rng_engine);
+    const bool cw = static_cast<bool>(cw_d(rng_engine));
+    const kep3::lambert_problem lp(r1, r2, tof, mu, cw, 5u);
+    double dv_min = 1e300;
+    for (auto j = 0u; j < lp.get_v1().size(); ++j) {
+      dv_min = std::min(dv_min, norm_diff(lp.get_v1()[j], v_dep) +
+                                    norm_diff(lp.get_v2()[j], v_arr));
+    }
+    const double bound =
+        kep3::lambert_dv_lower_bound(r1, r2, tof, mu, v_dep, v_arr, cw, 5u);
+    REQUIRE(bound >= 0.);
+    REQUIRE(bound <= dv_min * (1. + 1e-8) + 1e-10);
+  }
+}
+
+TEST_CASE("exceptions") {
+  const std::array<double, 3> r1{1., 0., 0.};
+  const std::array<double, 3> r2{0., 1., 0.};
+  REQUIRE_THROWS_AS(kep3::lambert_tof_parabolic(r1, r2, 0.), std::domain_error);
+  REQUIRE_THROWS_AS(kep3::lambert_tof_min_energy(r1, r2, -1.),
+                    std::domain_error);
+  REQUIRE_THROWS_AS(kep3::lambert_tof_min(r1, {2., 0., 0.}, 1., false, 1u),
+                    std::domain_error);
+  REQUIRE_THROWS_AS(kep3::lambert_Nmax(r1, r2, -1., 1.), std::domain_error);
+  REQUIRE_THROWS_AS(kep3::lambert_dv_lower_bound(r1, r2, -1., 1., r1, r2),
+                    std::domain_error);
+  REQUIRE_THROWS_AS(
+      kep3::lambert_dv_lower_bound(r1, {0., 0., 1.}, 1., 1., r1, r2),
+      std::domain_error);
+}
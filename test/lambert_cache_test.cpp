@@ -0,0 +1,187 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <kep3/lambert_cache.hpp>
+#include <kep3/lambert_problem.hpp>
+
+#include "catch.hpp"
+
+using kep3::lambert_cache;
+using kep3::lambert_problem;
+
+namespace {
+const std::array<double, 3> r1 = {1., 0., 0.};
+const std::array<double, 3> r2 = {0., 1.2, 0.1};
+} // namespace
+
+TEST_CASE("get") {
+  lambert_cache cache;
+  REQUIRE(cache.get_hit_rate() == 0.);
+  const lambert_problem ref(r1, r2, 2.3, 1., false, 1u);
+  const auto lp = cache.get(r1, r2, 2.3, 1., false, 1u);
+  REQUIRE(lp.get_v1() == ref.get_v1());
+  REQUIRE(lp.get_v2() == ref.get_v2());
+  REQUIRE(cache.get_misses() == 1u);
+  REQUIRE(cache.get(r1, r2, 2.3, 1., false, 1u).get_v1() == ref.get_v1());
+  REQUIRE(cache.get_hits() == 1u);
+  REQUIRE(cache.get_hit_rate() == 0.5);
+  // Any difference in cw and multi_revs is a different problem.
+  (void)cache.get(r1, r2, 2.3, 1., true, 1u);
+  (void)cache.get(r1, r2, 2.3, 1., false, 2u);
+  REQUIRE(cache.get_misses() == 3u);
+  REQUIRE(cache.size() == 3u);
+  // Quantization: a relative perturbation far below rel_tol hits the cache
+  // (unless on the edge of a quantum, which these inputs are not), a larger
+  // one does not.
+  (void)cache.get(r1, r2, 2.3 * (1. + 1e-15), 1., false, 1u);
+  REQUIRE(cache.get_hits() == 2u);
+  (void)cache.get(r1, r2, 2.3 * (1. + 1e-9), 1., false, 1u);
+  REQUIRE(cache.get_misses() == 4u);
+  // Exact keys.
+  lambert_cache exact(16u, 0.);
+  (void)exact.get(r1, r2, 2.3, 1.);
+  (void)exact.get(r1, r2, std::nextafter(2.3, 3.), 1.);
+  REQUIRE(exact.get_misses() == 2u);
+  // Invalid problems are not cached.
+  REQUIRE_THROWS_AS(cache.get(r1, r2, -1., 1.), std::domain_error);
+  REQUIRE(cache.size() == 4u);
+  // Clearing.
+  cache.clear();
+  REQUIRE(cache.size() == 0u);
+  REQUIRE(cache.get_misses() == 5u);
+  cache.reset_counters();
+  REQUIRE(cache.get_hits() == 0u);
+  REQUIRE(cache.get_misses() == 0u);
+}
+
+TEST_CASE("options") {
+  // The options are part of the key and are passed on to the problem.
+  lambert_cache cache;
+  const lambert_problem ref(r1, r2, 2.3, 1., false, 1u,
+                            {.sensitivities = true});
+  const auto lp = cache.get(r1, r2, 2.3, 1., false, 1u,
+                            {.sensitivities = true});
+  REQUIRE(lp.get_dv1_dp() == ref.get_dv1_dp());
+  REQUIRE(cache.get(r1, r2, 2.3, 1., false, 1u).get_dv1_dp().empty());
+  (void)cache.get(r1, r2, 2.3, 1., false, 1u, {.tabulated_guess = true});
+  (void)cache.get(r1, r2, 2.3, 1., false, 1u,
+                  {.accuracy = kep3::lambert_accuracy::fast});
+  REQUIRE(cache.get_misses() == 4u);
+  REQUIRE(cache.get(r1, r2, 2.3, 1., false, 1u, {.sensitivities = true})
+              .get_dv1_dp() == ref.get_dv1_dp());
+  REQUIRE(cache.get_hits() == 1u);
+}
+
+TEST_CASE("eviction") {
+  // One shard holding two problems.
+  lambert_cache cache(2u, 1e-12, 1u);
+  (void)cache.get(r1, r2, 1., 1.);
+  (void)cache.get(r1, r2, 2., 1.);
+  (void)cache.get(r1, r2, 1., 1.);
+  // The least recently used problem (tof = 2) is evicted.
+  (void)cache.get(r1, r2, 3., 1.);
+  REQUIRE(cache.size() == 2u);
+  REQUIRE(cache.get_misses() == 3u);
+  (void)cache.get(r1, r2, 1., 1.);
+  REQUIRE(cache.get_hits() == 2u);
+  (void)cache.get(r1, r2, 2., 1.);
+  REQUIRE(cache.get_misses() == 4u);
+  // The capacity is never exceeded.
+  lambert_cache small(10u);
+  for (auto i = 0u; i < 100u; ++i) {
+    (void)small.get(r1, r2, 1. + i, 1.);
+  }
+  REQUIRE(small.size() <= 10u);
+}
+
+TEST_CASE("threads") {
+  lambert_cache cache(64u);
+  const lambert_problem ref(r1, r2, 1.5, 1.);
+  std::vector<std::thread> threads;
+  for (auto t = 0u; t < 4u; ++t) {
+    threads.emplace_back([&cache, &ref]() {
+      for (auto i = 0u; i < 200u; ++i) {
+        const auto lp = cache.get(r1, r2, 1. + (i % 10u) * 0.1, 1.);
+        if (i % 10u == 5u && lp.get_v1() != ref.get_v1()) {
+          throw std::runtime_error("wrong solution");
+        }
+      }
+    });
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+  REQUIRE(cache.get_hits() + cache.get_misses() == 800u);
+  REQUIRE(cache.size() == 10u);
+  REQUIRE(cache.get_hit_rate() >= 0.9);
+}
+
+TEST_CASE("invalid") {
+  REQUIRE_THROWS_AS(lambert_cache(0u), std::invalid_argument);
+  REQUIRE_THROWS_AS(lambert_cache(10u, 1e-12, 0u), std::invalid_argument);
+  REQUIRE_THROWS_AS(lambert_cache(10u, -1e-3), std::invalid_argument);
+  REQUIRE_THROWS_AS(lambert_cache(10u, 1e-18), std::invalid_argument);
+  REQUIRE_THROWS_AS(lambert_cache(10u, std::nan("")), std::invalid_argument);
+  lambert_cache cache(10u, 1e-6);
+  REQUIRE(cache.get_capacity() == 10u);
+  REQUIRE(cache.get_rel_tol() == 1e-6);
+}
+
+TEST_CASE("power of two boundaries") {
+  // The mantissa of the values just below a power of two is rounded up to
+  // one: they must share the key of the power of two, on both sides of it
+  // and for negative values too.
+  lambert_cache cache(10u, 1e-12);
+  const lambert_problem ref(r1, r2, 2., 1.);
+  REQUIRE(cache.get(r1, r2, 2., 1.).get_v1() == ref.get_v1());
+  REQUIRE(cache.get(r1, r2, std::nextafter(2., 0.), 1.).get_v1() ==
+          ref.get_v1());
+  REQUIRE(cache.get(r1, r2, std::nextafter(2., 3.), 1.).get_v1() ==
+          ref.get_v1());
+  REQUIRE(cache.get(r1, r2, 2., std::nextafter(1., 0.)).get_v1() ==
+          ref.get_v1());
+  REQUIRE(cache.get_misses() == 1u);
+  REQUIRE(cache.get_hits() == 3u);
+  const std::array<double, 3> r3 = {1., -0.5, 0.};
+  const std::array<double, 3> r3_below = {1., std::nextafter(-0.5, 0.), 0.};
+  REQUIRE(cache.get(r3, r2, 2., 1.).get_v1() ==
+          cache.get(r3_below, r2, 2., 1.).get_v1());
+  REQUIRE(cache.get_misses() == 2u);
+  REQUIRE(cache.get_hits() == 4u);
+  // Values further apart than rel_tol across the boundary are different keys.
+  const auto lp = cache.get(r1, r2, 2. * (1. - 1e-9), 1.);
+  REQUIRE(cache.get_misses() == 3u);
+  REQUIRE(lp.get_v1() ==
+          lambert_problem(r1, r2, 2. * (1. - 1e-9), 1.).get_v1());
+}
+
+TEST_CASE("moved from") {
+  lambert_cache cache(10u);
+  REQUIRE(cache.get(r1, r2, 2.3, 1.).get_v1() ==
+          lambert_problem(r1, r2, 2.3, 1.).get_v1());
+  lambert_cache other(std::move(cache));
+  REQUIRE(other.is_valid());
+  REQUIRE(other.size() == 1u);
+  REQUIRE(!cache.is_valid());
+  REQUIRE_THROWS_AS(cache.get(r1, r2, 2.3, 1.), std::logic_error);
+  REQUIRE_THROWS_AS(cache.size(), std::logic_error);
+  REQUIRE_THROWS_AS(cache.get_hit_rate(), std::logic_error);
+  REQUIRE_THROWS_AS(cache.clear(), std::logic_error);
+  // A moved-from cache can be assigned to.
+  cache = lambert_cache(5u);
+  REQUIRE(cache.is_valid());
+  REQUIRE(cache.get_capacity() == 5u);
+}
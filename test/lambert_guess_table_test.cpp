@@ -0,0 +1,67 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <cmath>
+#include <limits>
+#include <random>
+
+#include <kep3/detail/lambert_guess_table.hpp>
+#include <kep3/detail/lambert_kernels.hpp>
+
+#include "catch.hpp"
+
+using kep3::detail::lambert_x_guess_table_N;
+
+TEST_CASE("lookup") {
+  // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+  std::mt19937 rng_engine(12201203u);
+  std::uniform_real_distribution<double> lambda_d(-0.99, 0.99);
+  std::uniform_real_distribution<double> dT_d(0.05, 100.);
+  std::uniform_int_distribution<unsigned> N_d(0u, lambert_x_guess_table_N);
+  std::uniform_int_distribution<unsigned> right_d(0u, 1u);
+  double x = 0.;
+  unsigned one_iter = 0u;
+  const unsigned trials = 20000u;
+  for (auto i = 0u; i < trials; ++i) {
+    const double lambda = lambda_d(rng_engine);
+    const unsigned N = N_d(rng_engine);
+    const bool right = N > 0u && right_d(rng_engine) == 1u;
+    const double T =
+        dT_d(rng_engine) + (N > 0u ? kep3::detail::lambert_T_min(lambda, N) : 0.);
+    REQUIRE(kep3::detail::lambert_x_guess_lookup(T, lambda, N, right, x));
+    // The guess is close to the solution of its own branch.
+    double x_ref = x;
+    kep3::detail::lambert_householder(T, x_ref, N, 1e-14, 50u, lambda);
+    double T_ref = 0.;
+    kep3::detail::lambert_x2tof(T_ref, x_ref, N, lambda);
+    REQUIRE(std::abs(T_ref - T) < 1e-10 * T);
+    double x_an = 0.;
+    kep3::detail::lambert_solve_branch(T, lambda, N, right, x_an);
+    REQUIRE(std::abs(x_an - x_ref) < 1e-6);
+    REQUIRE(std::abs(x - x_ref) < 1e-2);
+    one_iter +=
+        kep3::detail::lambert_solve_branch(T, lambda, N, right, x_an, true)
+            .iters == 1u;
+  }
+  // A good fraction of the solutions (mostly with zero revolutions, as the
+  // tolerance is looser) converge in a single iteration.
+  REQUIRE(one_iter > trials / 10u);
+  // Out of the table.
+  REQUIRE(!kep3::detail::lambert_x_guess_lookup(
+      10., 0.5, lambert_x_guess_table_N + 1u, false, x));
+  REQUIRE(!kep3::detail::lambert_x_guess_lookup(1e-3, 0.5, 0u, false, x));
+  REQUIRE(!kep3::detail::lambert_x_guess_lookup(1e5, 0.5, 0u, false, x));
+  REQUIRE(!kep3::detail::lambert_x_guess_lookup(
+      std::numeric_limits<double>::quiet_NaN(), 0.5, 0u, false, x));
+  REQUIRE(!kep3::detail::lambert_x_guess_lookup(
+      10., std::numeric_limits<double>::quiet_NaN(), 0u, false, x));
+  // Below the minimum time of flight.
+  REQUIRE(!kep3::detail::lambert_x_guess_lookup(
+      kep3::detail::lambert_T_min(0.5, 1u) * 0.99, 0.5, 1u, true, x));
+}
@@ -7,13 +7,21 @@
 // Public License v. 2.0. If a copy of the MPL was not distributed
 // with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
 #include <iostream>
+#include <random>
+#include <span>
 #include <stdexcept>
+#include <utility>
 
 #include <fmt/core.h>
 #include <fmt/ranges.h>
 
 #include <kep3/lambert_problem.hpp>
+#include <kep3/lambert_solve.hpp>
 
 #include "catch.hpp"
 #include "test_helpers.hpp"
@@ -99,13 +107,179 @@ TEST_CASE("methods") {
   REQUIRE(kep3_tests::floating_point_error(lp.get_x()[0], -0.3826834323650896) < 1e-13);
   REQUIRE(lp.get_iters()[0] == 3u);
   REQUIRE(lp.get_Nmax() == 0u);
+  REQUIRE(lp.get_converged());
 
 }
 
+TEST_CASE("convergence") {
+  // The convergence of the solutions is reported as by lambert_solve(), both
+  // for a single branch and for the branches solved in lanes. With the fast
+  // profile the zero revolutions solution of a long transfer still converges
+  // (to a coarser x), a longer one does not.
+  const std::array<double, 3> r1 = {1., 0., 0.}, r2 = {0.7, 0.5, 0.};
+  const kep3::lambert_options fast{.accuracy = kep3::lambert_accuracy::fast};
+  for (unsigned multi_revs : {0u, 2u}) {
+    const kep3::lambert_problem lp(r1, r2, 2e4, 1., false, multi_revs, fast);
+    REQUIRE(lp.get_converged());
+    REQUIRE(std::isfinite(lp.get_x()[0]));
+    const kep3::lambert_problem lp_nc(r1, r2, 2.5e4, 1., false, multi_revs,
+                                      fast);
+    REQUIRE(lp_nc.get_Nmax() == multi_revs);
+    REQUIRE(!lp_nc.get_converged());
+    REQUIRE(kep3::lambert_solve(r1, r2, 2.5e4, 1., false, {0u, false},
+                                kep3::lambert_accuracy::fast)
+                .status == kep3::lambert_status::not_converged);
+  }
+}
+
+TEST_CASE("sensitivities") {
+  // Here we test the analytic sensitivities against central finite differences
+  // on randomly generated problems, for all the multi revolution branches.
+
+  // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+  std::mt19937 rng_engine(12201203u);
+  std::uniform_int_distribution<unsigned> cw_d(0, 1);
+  std::uniform_real_distribution<double> r_d(-2, 2);
+  std::uniform_real_distribution<double> tof_d(2., 40.);
+  const unsigned revs_max = 3u;
+  const double h = 1e-6;
+
+  for (auto i = 0u; i < 200u; ++i) {
+    std::array<double, 7> p{r_d(rng_engine), r_d(rng_engine), r_d(rng_engine),
+                            r_d(rng_engine), r_d(rng_engine), r_d(rng_engine),
+                            tof_d(rng_engine)};
+    bool cw = static_cast<bool>(cw_d(rng_engine));
+    auto solve = [&](const std::array<double, 7> &q) {
+      return kep3::lambert_problem({q[0], q[1], q[2]}, {q[3], q[4], q[5]}, q[6],
+                                   1., cw, revs_max, {.sensitivities = true});
+    };
+    const auto lp = solve(p);
+    REQUIRE(lp.get_dv1_dp().size() == lp.get_v1().size());
+    REQUIRE(lp.get_dv2_dp().size() == lp.get_v2().size());
+    for (auto k = 0u; k < 7u; ++k) {
+      auto pp = p, pm = p;
+      pp[k] += h;
+      pm[k] -= h;
+      const auto lpp = solve(pp);
+      const auto lpm = solve(pm);
+      // Skip the (rare) perturbations changing the number of solutions.
+      if (lpp.get_Nmax() != lp.get_Nmax() || lpm.get_Nmax() != lp.get_Nmax()) {
+        continue;
+      }
+      for (decltype(lp.get_x().size()) sol = 0u; sol < lp.get_x().size();
+           ++sol) {
+        for (auto j = 0u; j < 3u; ++j) {
+          const double fd1 =
+              (lpp.get_v1()[sol][j] - lpm.get_v1()[sol][j]) / (2 * h);
+          const double fd2 =
+              (lpp.get_v2()[sol][j] - lpm.get_v2()[sol][j]) / (2 * h);
+          REQUIRE(std::abs(fd1 - lp.get_dv1_dp()[sol][j][k]) <
+                  1e-6 * std::max(1., std::abs(fd1)));
+          REQUIRE(std::abs(fd2 - lp.get_dv2_dp()[sol][j][k]) <
+                  1e-6 * std::max(1., std::abs(fd2)));
+        }
+      }
+    }
+  }
+  // Without the flag no sensitivities are computed.
+  kep3::lambert_problem lp{};
+  REQUIRE(lp.get_dv1_dp().empty());
+  REQUIRE(lp.get_dv2_dp().empty());
+}
+
+TEST_CASE("tabulated_guess") {
+  // Here we test that starting the iterations from the tabulated solutions
+  // gives the same solutions, in fewer iterations.
+
+  // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+  std::mt19937 rng_engine(12201203u);
+  std::uniform_int_distribution<unsigned> cw_d(0, 1);
+  std::uniform_real_distribution<double> r_d(-2, 2);
+  std::uniform_real_distribution<double> tof_d(2., 40.);
+  const unsigned revs_max = 8u;
+  unsigned iters_an = 0u, iters_tab = 0u;
+
+  for (auto i = 0u; i < 2000u; ++i) {
+    const std::array<double, 3> r1{r_d(rng_engine), r_d(rng_engine),
+                                   r_d(rng_engine)};
+    const std::array<double, 3> r2{r_d(rng_engine), r_d(rng_engine),
+                                   r_d(rng_engine)};
+    const double tof = tof_d(rng_engine);
+    const bool cw = static_cast<bool>(cw_d(rng_engine));
+    kep3::lambert_problem lp(r1, r2, tof, 1., cw, revs_max);
+    kep3::lambert_problem lp_tab(r1, r2, tof, 1., cw, revs_max,
+                                 {.tabulated_guess = true});
+    REQUIRE(lp.get_Nmax() == lp_tab.get_Nmax());
+    for (decltype(lp.get_x().size()) sol = 0u; sol < lp.get_x().size();
+         ++sol) {
+      REQUIRE(std::abs(lp.get_x()[sol] - lp_tab.get_x()[sol]) < 1e-10);
+      REQUIRE(kep3_tests::delta_guidance_error(r1, r2, lp_tab.get_v1()[sol],
+                                               1.) < 1e-12);
+      iters_an += lp.get_iters()[sol];
+      iters_tab += lp_tab.get_iters()[sol];
+    }
+  }
+  REQUIRE(iters_tab < iters_an);
+}
+
+// Whether the view v points into the storage of the object lp.
+template <typename T>
+bool is_inline(const kep3::lambert_problem &lp, std::span<const T> v) {
+  const auto *begin = reinterpret_cast<const char *>(&lp);
+  const auto *ptr = reinterpret_cast<const char *>(v.data());
+  return std::less_equal<>{}(begin, ptr) &&
+         std::less<>{}(ptr, begin + sizeof(kep3::lambert_problem));
+}
+
+TEST_CASE("storage") {
+  // Up to 5 revolutions the solutions are stored inline, otherwise on the
+  // heap. In both cases copies and moves preserve them.
+  for (unsigned revs : {2u, 10u}) {
+    const kep3::lambert_problem lp{{1., 0., 0.}, {0., 1., 0.}, 100., 1., false,
+                                   revs};
+    REQUIRE(lp.get_Nmax() == revs);
+    REQUIRE(is_inline(lp, lp.get_v1_span()) == (revs <= 5u));
+    REQUIRE(is_inline(lp, lp.get_x_span()) == (revs <= 5u));
+    REQUIRE(std::ranges::equal(lp.get_v1_span(), lp.get_v1()));
+    REQUIRE(std::ranges::equal(lp.get_iters_span(), lp.get_iters()));
+    const auto before = boost::lexical_cast<std::string>(lp);
+    auto lp_copy = lp;
+    REQUIRE(boost::lexical_cast<std::string>(lp_copy) == before);
+    REQUIRE(lp_copy.get_v1() == lp.get_v1());
+    REQUIRE(lp_copy.get_iters() == lp.get_iters());
+    const auto lp_moved = std::move(lp_copy);
+    REQUIRE(boost::lexical_cast<std::string>(lp_moved) == before);
+    REQUIRE(lp_moved.get_v2() == lp.get_v2());
+    REQUIRE(lp_moved.get_x() == lp.get_x());
+    kep3::lambert_problem lp_assigned{};
+    lp_assigned = lp_moved;
+    REQUIRE(boost::lexical_cast<std::string>(lp_assigned) == before);
+    // Round trip through serialization.
+    std::stringstream ss;
+    {
+      boost::archive::binary_oarchive oarchive(ss);
+      oarchive << lp;
+    }
+    kep3::lambert_problem lp2{};
+    {
+      boost::archive::binary_iarchive iarchive(ss);
+      iarchive >> lp2;
+    }
+    REQUIRE(boost::lexical_cast<std::string>(lp2) == before);
+    REQUIRE(is_inline(lp2, lp2.get_v1_span()) == (revs <= 5u));
+  }
+  // Copying a problem stored inline releases the heap buffer.
+  kep3::lambert_problem lp{{1., 0., 0.}, {0., 1., 0.}, 100., 1., false, 10u};
+  REQUIRE(!is_inline(lp, lp.get_v2_span()));
+  const kep3::lambert_problem lp_inline{};
+  lp = lp_inline;
+  REQUIRE(is_inline(lp, lp.get_v2_span()));
+}
+
 TEST_CASE("serialization_test") {
   // Instantiate a generic lambert problem
   kep3::lambert_problem lp{{1.23, 0.1253232342323, 0.57235553354}, {0.234233423, 1.8645645645, 0.234234234}, 25.254856435,
-                           1.,           true,         10};
+                           1.,           true,         10, {.sensitivities = true}};
 
   // Store the string representation.
   std::stringstream ss;
@@ -125,4 +299,81 @@ TEST_CASE("serialization_test") {
   auto after = boost::lexical_cast<std::string>(lp2);
   // Compare the string represetation
   REQUIRE(before == after);
+  REQUIRE(lp.get_dv1_dp() == lp2.get_dv1_dp());
+  REQUIRE(lp.get_dv2_dp() == lp2.get_dv2_dp());
+}
+
+namespace {
+// The layout of the archives of lambert_problem written before version 1,
+// with the solutions in std::vector and m_iters stored twice.
+struct lambert_problem_v0 {
+  std::array<double, 3> r1, r2;
+  double tof, mu;
+  std::vector<std::array<double, 3>> v1, v2;
+  std::vector<unsigned> iters;
+  std::vector<double> x;
+  double s, c, lambda;
+  unsigned Nmax;
+  bool has_converged;
+  unsigned multi_revs;
+  template <class Archive> void serialize(Archive &ar, const unsigned int) {
+    ar &r1;
+    ar &r2;
+    ar &tof;
+    ar &mu;
+    ar &v1;
+    ar &v2;
+    ar &iters;
+    ar &x;
+    ar &s;
+    ar &c;
+    ar &lambda;
+    ar &iters;
+    ar &Nmax;
+    ar &has_converged;
+    ar &multi_revs;
+  }
+};
+} // namespace
+
+TEST_CASE("serialization_v0") {
+  const std::array<double, 3> r1 = {1.23, 0.1253232342323, 0.57235553354};
+  const std::array<double, 3> r2 = {0.234233423, 1.8645645645, 0.234234234};
+  const kep3::lambert_problem lp{r1, r2, 25.254856435, 1., true, 10};
+  const lambert_problem_v0 lp_v0{
+      r1,
+      r2,
+      lp.get_tof(),
+      lp.get_mu(),
+      lp.get_v1(),
+      lp.get_v2(),
+      lp.get_iters(),
+      lp.get_x(),
+      // s, c and lambda have no getters.
+      1.,
+      2.,
+      3.,
+      lp.get_Nmax(),
+      lp.get_converged(),
+      10u};
+  std::stringstream ss;
+  {
+    boost::archive::text_oarchive oarchive(ss);
+    oarchive << lp_v0;
+  }
+  // Loading over a problem with sensitivities, which must be cleared.
+  kep3::lambert_problem lp2{r1, r2, 3., 1., false, 0u, {.sensitivities = true}};
+  {
+    boost::archive::text_iarchive iarchive(ss);
+    iarchive >> lp2;
+  }
+  REQUIRE(lp2.get_v1() == lp.get_v1());
+  REQUIRE(lp2.get_v2() == lp.get_v2());
+  REQUIRE(lp2.get_iters() == lp.get_iters());
+  REQUIRE(lp2.get_x() == lp.get_x());
+  REQUIRE(lp2.get_Nmax() == lp.get_Nmax());
+  REQUIRE(lp2.get_tof() == lp.get_tof());
+  REQUIRE(lp2.get_converged());
+  REQUIRE(lp2.get_dv1_dp().empty());
+  REQUIRE(lp2.get_dv2_dp().empty());
 }
\ No newline at end of file
@@ -0,0 +1,306 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <random>
+
+#include <kep3/core_astro/constants.hpp>
+#include <kep3/detail/lambert_kernels.hpp>
+#include <kep3/detail/lambert_lanes.hpp>
+#include <kep3/detail/lambert_universal.hpp>
+#include <kep3/lambert_problem.hpp>
+#include <kep3/lambert_solve.hpp>
+
+#include "catch.hpp"
+#include "test_helpers.hpp"
+
+namespace {
+double norm_diff(const std::array<double, 3> &a,
+                 const std::array<double, 3> &b) {
+  return std::sqrt((a[0] - b[0]) * (a[0] - b[0]) +
+                   (a[1] - b[1]) * (a[1] - b[1]) +
+                   (a[2] - b[2]) * (a[2] - b[2]));
+}
+} // namespace
+
+TEST_CASE("lambert_solve") {
+  // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+  std::mt19937 rng_engine(12201203u);
+  std::uniform_int_distribution<unsigned> cw_d(0, 1);
+  std::uniform_real_distribution<double> r_d(-2, 2);
+  std::uniform_real_distribution<double> tof_d(2., 40.);
+  std::uniform_real_distribution<double> mu_d(0.9, 1.1);
+  for (auto i = 0u; i < 1000u; ++i) {
+    const std::array<double, 3> r1{r_d(rng_engine), r_d(rng_engine),
+                                   r_d(rng_engine)};
+    const std::array<double, 3> r2{r_d(rng_engine), r_d(rng_engine),
+                                   r_d(rng_engine)};
+    const double tof = tof_d(rng_engine);
+    const double mu = mu_d(rng_engine);
+    const bool cw = static_cast<bool>(cw_d(rng_engine));
+    const kep3::lambert_problem lp(r1, r2, tof, mu, cw, 3u);
+    for (unsigned N = 0u; N <= 3u; ++N) {
+      for (bool right : {false, true}) {
+        const auto sol = kep3::lambert_solve(r1, r2, tof, mu, cw, {N, right});
+        REQUIRE(sol.branch.N == N);
+        REQUIRE(sol.branch.right == right);
+        if (N > lp.get_Nmax()) {
+          REQUIRE(sol.status == kep3::lambert_status::no_solution);
+          REQUIRE(std::isnan(sol.v1[0]));
+          continue;
+        }
+        const auto idx = (N == 0u) ? 0u : 2u * N - 1u + right;
+        REQUIRE(sol.status == kep3::lambert_status::success);
+        REQUIRE(sol.x == lp.get_x()[idx]);
+        REQUIRE(sol.iters == lp.get_iters()[idx]);
+        REQUIRE(sol.v1 == lp.get_v1()[idx]);
+        REQUIRE(sol.v2 == lp.get_v2()[idx]);
+      }
+    }
+  }
+  // Invalid problems.
+  REQUIRE(kep3::lambert_solve({1., 0., 0.}, {0., 1., 0.}, -1., 1.).status ==
+          kep3::lambert_status::invalid_tof);
+  REQUIRE(kep3::lambert_solve({1., 0., 0.}, {0., 1., 0.}, 1., 0.).status ==
+          kep3::lambert_status::invalid_mu);
+  REQUIRE(kep3::lambert_solve({0., 0., 1.}, {0., 1., 0.}, 1., 1.).status ==
+          kep3::lambert_status::degenerate_geometry);
+}
+
+TEST_CASE("accuracy") {
+  // The profiles are selectable per solve: the standard one gives the default
+  // solutions, the fast one saves iterations and the precise one agrees with
+  // the standard one to machine precision.
+  // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+  std::mt19937 rng_engine(12201203u);
+  std::uniform_int_distribution<unsigned> cw_d(0, 1);
+  std::uniform_real_distribution<double> r_d(-2, 2);
+  std::uniform_real_distribution<double> tof_d(2., 40.);
+  unsigned iters_fast = 0u, iters_std = 0u, iters_precise = 0u;
+  for (auto i = 0u; i < 1000u; ++i) {
+    const std::array<double, 3> r1{r_d(rng_engine), r_d(rng_engine),
+                                   r_d(rng_engine)};
+    const std::array<double, 3> r2{r_d(rng_engine), r_d(rng_engine),
+                                   r_d(rng_engine)};
+    const double tof = tof_d(rng_engine);
+    const bool cw = static_cast<bool>(cw_d(rng_engine));
+    const kep3::lambert_problem lp(r1, r2, tof, 1., cw, 2u);
+    const kep3::lambert_problem lp_fast(
+        r1, r2, tof, 1., cw, 2u, {.accuracy = kep3::lambert_accuracy::fast});
+    const kep3::lambert_problem lp_precise(
+        r1, r2, tof, 1., cw, 2u,
+        {.accuracy = kep3::lambert_accuracy::precise});
+    REQUIRE(lp_fast.get_Nmax() == lp.get_Nmax());
+    REQUIRE(lp_precise.get_Nmax() == lp.get_Nmax());
+    for (decltype(lp.get_x().size()) j = 0u; j < lp.get_x().size(); ++j) {
+      const double v = std::sqrt(lp.get_v1()[j][0] * lp.get_v1()[j][0] +
+                                 lp.get_v1()[j][1] * lp.get_v1()[j][1] +
+                                 lp.get_v1()[j][2] * lp.get_v1()[j][2]);
+      REQUIRE(norm_diff(lp_fast.get_v1()[j], lp.get_v1()[j]) < 1e-3 * v);
+      REQUIRE(norm_diff(lp_precise.get_v1()[j], lp.get_v1()[j]) < 1e-12 * v);
+      iters_fast += lp_fast.get_iters()[j];
+      iters_std += lp.get_iters()[j];
+      iters_precise += lp_precise.get_iters()[j];
+      // The single branch solver uses the same profiles.
+      const auto sol = kep3::lambert_solve(
+          r1, r2, tof, 1., cw,
+          {static_cast<unsigned>((j + 1u) / 2u), j > 0u && j % 2u == 0u},
+          kep3::lambert_accuracy::fast);
+      REQUIRE(sol.x == lp_fast.get_x()[j]);
+      REQUIRE(sol.iters == lp_fast.get_iters()[j]);
+    }
+  }
+  REQUIRE(iters_fast < iters_std);
+  REQUIRE(iters_std < iters_precise);
+}
+
+TEST_CASE("converged_on_last_iteration") {
+  // Householder iterations meeting the convergence criterion on their last
+  // allowed step are flagged as converged, with one step less they are not.
+  // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+  std::mt19937 rng_engine(12201203u);
+  std::uniform_real_distribution<double> lambda_d(-0.99, 0.99);
+  std::uniform_real_distribution<double> T_d(0.5, 40.);
+  for (auto i = 0u; i < 1000u; ++i) {
+    const double lambda = lambda_d(rng_engine);
+    const double T = T_d(rng_engine);
+    double x = 0.;
+    const auto its =
+        kep3::detail::lambert_solve_branch(T, lambda, 0u, false, x);
+    REQUIRE(its.converged);
+    kep3::detail::lambert_tolerances tol;
+    tol.iter_max = its.iters;
+    double x_last = 0.;
+    const auto its_last = kep3::detail::lambert_solve_branch(
+        T, lambda, 0u, false, x_last, false, tol);
+    REQUIRE(its_last.converged);
+    REQUIRE(its_last.iters == its.iters);
+    REQUIRE(x_last == x);
+    // The lanes flag each lane the same way.
+    kep3::detail::lambert_lanes<4> T_l{}, x_l{}, eps_l{}, lambda_l{};
+    kep3::detail::lambert_ulanes<4> N_l{}, iters_l{};
+    kep3::detail::lambert_mask<4> active{}, converged{};
+    T_l.fill(T);
+    lambda_l.fill(lambda);
+    eps_l.fill(tol.eps_zero_rev);
+    x_l.fill(kep3::detail::lambert_x0_guess(T, lambda));
+    active.fill(true);
+    kep3::detail::lambert_householder_lanes(T_l, x_l, N_l, eps_l,
+                                            tol.iter_max, lambda_l, active,
+                                            iters_l, converged,
+                                            tol.hypergeometric_tol);
+    for (auto k = 0u; k < 4u; ++k) {
+      REQUIRE(converged[k]);
+      REQUIRE(iters_l[k] == its.iters);
+      REQUIRE(x_l[k] == x);
+    }
+    if (its.iters > 1u) {
+      tol.iter_max = its.iters - 1u;
+      REQUIRE(!kep3::detail::lambert_solve_branch(T, lambda, 0u, false,
+                                                  x_last, false, tol)
+                   .converged);
+    }
+  }
+  // The same for the Newton iterations of the universal variable solver, on
+  // zero revolutions transfers.
+  std::uniform_real_distribution<double> psi_d(-30., 30.);
+  std::uniform_real_distribution<double> A_d(-1.9, 1.9);
+  const double twopi2 = 4. * kep3::pi * kep3::pi;
+  for (auto i = 0u; i < 1000u; ++i) {
+    const double A = A_d(rng_engine);
+    double tau = 0., dt = 0., y = 0.;
+    if (!kep3::detail::lambert_universal_tof(psi_d(rng_engine), 2., A, tau,
+                                             dt, y)) {
+      continue;
+    }
+    double psi = 0.;
+    const auto its = kep3::detail::lambert_universal_newton(
+        tau, 2., A, -twopi2, twopi2, 1., psi, 100u, 1e-14);
+    REQUIRE(its.converged);
+    double psi_last = 0.;
+    const auto its_last = kep3::detail::lambert_universal_newton(
+        tau, 2., A, -twopi2, twopi2, 1., psi_last, its.iters, 1e-14);
+    REQUIRE(its_last.converged);
+    REQUIRE(psi_last == psi);
+    psi_last = 0.;
+    REQUIRE(!kep3::detail::lambert_universal_newton(tau, 2., A, -twopi2,
+                                                    twopi2, 1., psi_last,
+                                                    its.iters - 1u, 1e-14)
+                 .converged);
+  }
+}
+
+TEST_CASE("engine") {
+  // The universal variable solver finds the same solutions, on the same
+  // branches, as the default one.
+  // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+  std::mt19937 rng_engine(12201203u);
+  std::uniform_int_distribution<unsigned> cw_d(0, 1);
+  std::uniform_real_distribution<double> r_d(-2, 2);
+  std::uniform_real_distribution<double> tof_d(0.1, 40.);
+  std::uniform_real_distribution<double> mu_d(0.9, 1.1);
+  for (auto i = 0u; i < 1000u; ++i) {
+    const std::array<double, 3> r1{r_d(rng_engine), r_d(rng_engine),
+                                   r_d(rng_engine)};
+    const std::array<double, 3> r2{r_d(rng_engine), r_d(rng_engine),
+                                   r_d(rng_engine)};
+    const double tof = tof_d(rng_engine);
+    const double mu = mu_d(rng_engine);
+    const bool cw = static_cast<bool>(cw_d(rng_engine));
+    const kep3::lambert_problem lp(r1, r2, tof, mu, cw, 3u);
+    for (unsigned N = 0u; N <= 3u; ++N) {
+      for (bool right : {false, true}) {
+        const auto sol =
+            kep3::lambert_solve(r1, r2, tof, mu, cw, {N, right},
+                                kep3::lambert_accuracy::standard,
+                                kep3::lambert_engine::universal);
+        if (N > lp.get_Nmax()) {
+          REQUIRE(sol.status == kep3::lambert_status::no_solution);
+          continue;
+        }
+        const auto idx = (N == 0u) ? 0u : 2u * N - 1u + right;
+        REQUIRE(sol.status == kep3::lambert_status::success);
+        const double v = std::sqrt(lp.get_v1()[idx][0] * lp.get_v1()[idx][0] +
+                                   lp.get_v1()[idx][1] * lp.get_v1()[idx][1] +
+                                   lp.get_v1()[idx][2] * lp.get_v1()[idx][2]);
+        REQUIRE(norm_diff(sol.v1, lp.get_v1()[idx]) < 1e-9 * v);
+        REQUIRE(norm_diff(sol.v2, lp.get_v2()[idx]) < 1e-9 * v);
+        REQUIRE(std::abs(sol.x - lp.get_x()[idx]) < 1e-8);
+      }
+    }
+  }
+  REQUIRE(kep3::lambert_solve({1., 0., 0.}, {0., 1., 0.}, -1., 1., false, {},
+                              kep3::lambert_accuracy::standard,
+                              kep3::lambert_engine::universal)
+              .status == kep3::lambert_status::invalid_tof);
+  // Long way hyperbolic transfers too fast to be bracketed.
+  const std::array<double, 3> r2{std::cos(3.5), -std::sin(3.5), 0.};
+  REQUIRE(kep3::lambert_solve({1., 0., 0.}, r2, 1e-4, 1., true).status ==
+          kep3::lambert_status::success);
+  REQUIRE(kep3::lambert_solve({1., 0., 0.}, r2, 1e-4, 1., true, {},
+                              kep3::lambert_accuracy::standard,
+                              kep3::lambert_engine::universal)
+              .status == kep3::lambert_status::success);
+  const auto sol = kep3::lambert_solve({1., 0., 0.}, r2, 1e-6, 1., true, {},
+                                       kep3::lambert_accuracy::standard,
+                                       kep3::lambert_engine::universal);
+  REQUIRE(sol.status == kep3::lambert_status::bracket_not_found);
+  REQUIRE(std::isnan(sol.x));
+  REQUIRE(std::isnan(sol.v1[0]));
+}
+
+TEST_CASE("lambert_solve_min_dv") {
+  // Here we test that the pruned search finds the same solution as the
+  // exhaustive one, both for random velocities and for bodies on nearly
+  // coplanar circular orbits (where most branches are pruned).
+  // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+  std::mt19937 rng_engine(12201203u);
+  std::uniform_int_distribution<unsigned> cw_d(0, 1);
+  std::uniform_real_distribution<double> r_d(-2, 2);
+  std::uniform_real_distribution<double> v_d(-1, 1);
+  std::uniform_real_distribution<double> tof_d(2., 100.);
+  std::uniform_real_distribution<double> R_d(0.8, 1.6);
+  std::uniform_real_distribution<double> theta_d(0., 2. * kep3::pi);
+  const unsigned revs_max = 10u;
+  for (auto i = 0u; i < 2000u; ++i) {
+    std::array<double, 3> r1{}, r2{}, v_dep{}, v_arr{};
+    if (i % 2u == 0u) {
+      r1 = {r_d(rng_engine), r_d(rng_engine), r_d(rng_engine)};
+      r2 = {r_d(rng_engine), r_d(rng_engine), r_d(rng_engine)};
+      v_dep = {v_d(rng_engine), v_d(rng_engine), v_d(rng_engine)};
+      v_arr = {v_d(rng_engine), v_d(rng_engine), v_d(rng_engine)};
+    } else {
+      for (auto *rv : {&r1, &r2}) {
+        const double R = R_d(rng_engine), theta = theta_d(rng_engine);
+        *rv = {R * std::cos(theta), R * std::sin(theta), 0.01 * v_d(rng_engine)};
+        auto &v = (rv == &r1) ? v_dep : v_arr;
+        v = {-std::sin(theta) / std::sqrt(R), std::cos(theta) / std::sqrt(R),
+             0.};
+      }
+    }
+    const double tof = tof_d(rng_engine);
+    const bool cw = static_cast<bool>(cw_d(rng_engine));
+    const kep3::lambert_problem lp(r1, r2, tof, 1., cw, revs_max);
+    double best_dv = std::numeric_limits<double>::infinity();
+    for (decltype(lp.get_x().size()) j = 0u; j < lp.get_x().size(); ++j) {
+      best_dv = std::min(best_dv, norm_diff(lp.get_v1()[j], v_dep) +
+                                      norm_diff(lp.get_v2()[j], v_arr));
+    }
+    const auto sol =
+        kep3::lambert_solve_min_dv(r1, r2, tof, 1., v_dep, v_arr, cw, revs_max);
+    REQUIRE(sol.status == kep3::lambert_status::success);
+    REQUIRE(norm_diff(sol.v1, v_dep) + norm_diff(sol.v2, v_arr) == best_dv);
+  }
+  REQUIRE(kep3::lambert_solve_min_dv({0., 0., 1.}, {0., 1., 0.}, 1., 1.,
+                                     {0., 0., 0.}, {0., 0., 0.})
+              .status == kep3::lambert_status::degenerate_geometry);
+}
@@ -0,0 +1,73 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <cmath>
+#include <limits>
+#include <random>
+
+#include <kep3/detail/lambert_kernels.hpp>
+#include <kep3/detail/lambert_tmin_table.hpp>
+
+#include "catch.hpp"
+
+using kep3::detail::lambert_T_min_table_N;
+
+namespace {
+// Reference T_min via bisection on the sign of dT/dx.
+double T_min_bisection(double lambda, unsigned N) {
+  double lb = -1., ub = 1., T = 0., DT = 0., DDT = 0., DDDT = 0.;
+  for (auto i = 0u; i < 200u && ub - lb > 1e-15; ++i) {
+    const double x = (lb + ub) / 2.;
+    kep3::detail::lambert_x2tof(T, x, N, lambda);
+    kep3::detail::lambert_dTdx(DT, DDT, DDDT, x, T, lambda);
+    (DT < 0. ? lb : ub) = x;
+  }
+  kep3::detail::lambert_x2tof(T, (lb + ub) / 2., N, lambda);
+  return T;
+}
+} // namespace
+
+TEST_CASE("lookup") {
+  // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+  std::mt19937 rng_engine(12201203u);
+  std::uniform_real_distribution<double> lambda_d(-1., 1.);
+  std::uniform_int_distribution<unsigned> N_d(1u, lambert_T_min_table_N);
+  double T_tab = 0., x_tab = 0., err = 0., x_min = 0.;
+  for (auto i = 0u; i < 20000u; ++i) {
+    const double lambda = lambda_d(rng_engine);
+    const unsigned N = N_d(rng_engine);
+    REQUIRE(kep3::detail::lambert_T_min_lookup(lambda, N, T_tab, x_tab, err));
+    const double T_min = T_min_bisection(lambda, N);
+    // The tabulated value is within its error bound, and the refinement
+    // recovers T_min.
+    REQUIRE(std::abs(T_tab - T_min) <= err);
+    REQUIRE(err < 1e-3 * T_min);
+    REQUIRE(std::abs(kep3::detail::lambert_T_min(lambda, N) - T_min) <
+            1e-13 * T_min);
+    REQUIRE(std::abs(kep3::detail::lambert_T_min_from(lambda, N, x_tab, x_min) -
+                     T_min) < 1e-13 * T_min);
+    // Feasibility of times of flight close to T_min.
+    for (double dT : {-1e-2, -1e-6, 1e-6, 1e-2}) {
+      REQUIRE(kep3::detail::lambert_T_min_feasible(T_min * (1. + dT), lambda,
+                                                   N) == (dT > 0.));
+    }
+  }
+  // Halley iterations started from x = 0 used to diverge for lambda close to
+  // -1.
+  REQUIRE(std::abs(kep3::detail::lambert_T_min(-0.99, 1u) -
+                   5.74495449076492) < 1e-12);
+  // Out of the table.
+  REQUIRE(!kep3::detail::lambert_T_min_lookup(0.5, 0u, T_tab, x_tab, err));
+  REQUIRE(!kep3::detail::lambert_T_min_lookup(0.5, lambert_T_min_table_N + 1u,
+                                              T_tab, x_tab, err));
+  REQUIRE(!kep3::detail::lambert_T_min_lookup(
+      std::numeric_limits<double>::quiet_NaN(), 1u, T_tab, x_tab, err));
+  REQUIRE(std::abs(kep3::detail::lambert_T_min(0.3, 40u) -
+                   T_min_bisection(0.3, 40u)) < 1e-11);
+}
@@ -0,0 +1,203 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <kep3/core_astro/constants.hpp>
+#include <kep3/detail/npy.hpp>
+#include <kep3/epoch.hpp>
+#include <kep3/lambert_problem.hpp>
+#include <kep3/planet.hpp>
+#include <kep3/porkchop.hpp>
+
+#include "catch.hpp"
+
+using kep3::epoch;
+using kep3::planet;
+
+// A planet on an inclined circular orbit around the Sun.
+struct circular_udpla {
+  double a = kep3::AU;
+  double phase = 0.;
+  double incl = 0.1;
+  double mu = kep3::MU_SUN;
+
+  [[nodiscard]] std::array<std::array<double, 3>, 2>
+  eph(const epoch &ep) const {
+    const double n = std::sqrt(mu / (a * a * a));
+    const double th = phase + n * ep.mjd2000() * kep3::DAY2SEC;
+    const double v = n * a;
+    return {{{a * std::cos(th), a * std::sin(th) * std::cos(incl),
+              a * std::sin(th) * std::sin(incl)},
+             {-v * std::sin(th), v * std::cos(th) * std::cos(incl),
+              v * std::cos(th) * std::sin(incl)}}};
+  }
+  [[nodiscard]] double get_mu_central_body() const { return mu; }
+
+private:
+  friend class boost::serialization::access;
+  template <typename Archive> void serialize(Archive &ar, unsigned) {
+    ar &a;
+    ar &phase;
+    ar &incl;
+    ar &mu;
+  }
+};
+kep3_S11N_PLANET_EXPORT(circular_udpla);
+
+namespace {
+double norm_diff(const std::array<double, 3> &a,
+                 const std::array<double, 3> &b) {
+  return std::sqrt((a[0] - b[0]) * (a[0] - b[0]) +
+                   (a[1] - b[1]) * (a[1] - b[1]) +
+                   (a[2] - b[2]) * (a[2] - b[2]));
+}
+} // namespace
+
+TEST_CASE("porkchop") {
+  const circular_udpla earth{kep3::AU, 0., 0.1, kep3::MU_SUN};
+  const circular_udpla mars{1.52 * kep3::AU, 1., 0.12, kep3::MU_SUN};
+  // A grid larger than one tile, with some arrivals preceding departures.
+  std::vector<double> t_dep, t_arr;
+  for (auto i = 0u; i < 70u; ++i) {
+    t_dep.push_back(i * 5.);
+  }
+  for (auto j = 0u; j < 130u; ++j) {
+    t_arr.push_back(100. + j * 4.);
+  }
+  for (unsigned multi_revs : {0u, 1u}) {
+    const auto res = kep3::porkchop(planet(earth), planet(mars), t_dep, t_arr,
+                                    false, multi_revs);
+    REQUIRE(res.n_dep == t_dep.size());
+    REQUIRE(res.n_arr == t_arr.size());
+    REQUIRE(res.c3.size() == t_dep.size() * t_arr.size());
+    REQUIRE(res.vinf_arr.size() == res.c3.size());
+    REQUIRE(res.dv.size() == res.c3.size());
+    for (auto i = 0u; i < t_dep.size(); ++i) {
+      for (auto j = 0u; j < t_arr.size(); ++j) {
+        const auto idx = i * t_arr.size() + j;
+        const double tof = (t_arr[j] - t_dep[i]) * kep3::DAY2SEC;
+        if (tof <= 0.) {
+          REQUIRE(std::isnan(res.c3[idx]));
+          REQUIRE(std::isnan(res.vinf_arr[idx]));
+          REQUIRE(std::isnan(res.dv[idx]));
+          continue;
+        }
+        // Against the minimum DV solution of a lambert_problem.
+        const auto [r1, v_dep] = earth.eph(epoch(t_dep[i]));
+        const auto [r2, v_arr] = mars.eph(epoch(t_arr[j]));
+        const kep3::lambert_problem lp(r1, r2, tof, kep3::MU_SUN, false,
+                                       multi_revs);
+        double dv = 1e300, c3 = 0., vinf = 0.;
+        for (auto k = 0u; k < lp.get_v1().size(); ++k) {
+          const double dv1 = norm_diff(lp.get_v1()[k], v_dep);
+          const double dv2 = norm_diff(lp.get_v2()[k], v_arr);
+          if (dv1 + dv2 < dv) {
+            dv = dv1 + dv2;
+            c3 = dv1 * dv1;
+            vinf = dv2;
+          }
+        }
+        REQUIRE(std::abs(res.dv[idx] - dv) <= 1e-8 * dv);
+        REQUIRE(std::abs(res.c3[idx] - c3) <= 1e-8 * c3);
+        REQUIRE(std::abs(res.vinf_arr[idx] - vinf) <= 1e-8 * vinf);
+      }
+    }
+  }
+  // Planets orbiting different bodies.
+  REQUIRE_THROWS_AS(kep3::porkchop(planet(earth),
+                                   planet(circular_udpla{kep3::AU, 0., 0.1,
+                                                         kep3::MU_EARTH}),
+                                   t_dep, t_arr),
+                    std::invalid_argument);
+  REQUIRE_THROWS_AS(
+      kep3::porkchop(planet(earth),
+                     planet(circular_udpla{kep3::AU, 0., 0.1,
+                                           kep3::MU_SUN * (1. + 1e-9)}),
+                     t_dep, t_arr),
+      std::invalid_argument);
+  // The same body, with a gravity parameter a few ulps apart.
+  REQUIRE_NOTHROW(
+      kep3::porkchop(planet(earth),
+                     planet(circular_udpla{kep3::AU, 0., 0.1,
+                                           kep3::MU_SUN * (1. + 1e-15)}),
+                     t_dep, t_arr));
+  REQUIRE_THROWS_AS(kep3::porkchop(planet(circular_udpla{kep3::AU, 0., 0.1,
+                                                         0.}),
+                                   planet(earth), t_dep, t_arr),
+                    std::domain_error);
+  // Empty grid.
+  const auto res =
+      kep3::porkchop(planet(earth), planet(mars), t_dep, std::vector<double>{});
+  REQUIRE(res.n_arr == 0u);
+  REQUIRE(res.dv.empty());
+}
+
+TEST_CASE("porkchop_save_npy") {
+  const std::vector<double> t_dep = {0., 10., 20.};
+  const std::vector<double> t_arr = {200., 250.};
+  const auto res =
+      kep3::porkchop(planet(circular_udpla{}),
+                     planet(circular_udpla{1.52 * kep3::AU, 1., 0.12,
+                                           kep3::MU_SUN}),
+                     t_dep, t_arr);
+  const std::string filename = "porkchop_test.npy";
+  kep3::porkchop_save_npy(res, filename);
+  std::ifstream file(filename, std::ios::binary);
+  const std::vector<char> bytes((std::istreambuf_iterator<char>(file)),
+                                std::istreambuf_iterator<char>());
+  file.close();
+  std::remove(filename.c_str());
+  // Magic string and version 1.0, then the header length.
+  REQUIRE(std::string(bytes.begin(), bytes.begin() + 8) ==
+          std::string("\x93NUMPY\x01\x00", 8));
+  const std::size_t header_len =
+      static_cast<unsigned char>(bytes[8]) +
+      256u * static_cast<unsigned char>(bytes[9]);
+  REQUIRE((10u + header_len) % 64u == 0u);
+  const std::string header(bytes.begin() + 10,
+                           bytes.begin() + 10 +
+                               static_cast<std::ptrdiff_t>(header_len));
+  REQUIRE(header.find("'shape': (3, 3, 2)") != std::string::npos);
+  REQUIRE(header.back() == '\n');
+  // The data: C3, arrival excess velocity and DV.
+  REQUIRE(bytes.size() == 10u + header_len + 3u * 6u * sizeof(double));
+  std::vector<double> data(18u);
+  std::copy(bytes.begin() + 10 + static_cast<std::ptrdiff_t>(header_len),
+            bytes.end(), reinterpret_cast<char *>(data.data()));
+  for (auto k = 0u; k < 6u; ++k) {
+    REQUIRE(data[k] == res.c3[k]);
+    REQUIRE(data[6u + k] == res.vinf_arr[k]);
+    REQUIRE(data[12u + k] == res.dv[k]);
+  }
+  REQUIRE_THROWS_AS(kep3::porkchop_save_npy(res, "/nonexistent/dir/x.npy"),
+                    std::runtime_error);
+  // The shapes of lower rank, down to the scalars.
+  const auto npy_header = [](std::initializer_list<std::size_t> shape) {
+    std::ostringstream os;
+    kep3::detail::npy_write_header(os, shape);
+    return os.str();
+  };
+  REQUIRE(npy_header({}).find("'shape': (), ") != std::string::npos);
+  REQUIRE(npy_header({5u}).find("'shape': (5,), ") != std::string::npos);
+  REQUIRE(npy_header({5u, 2u}).find("'shape': (5, 2), ") !=
+          std::string::npos);
+  REQUIRE(npy_header({}).size() % 64u == 0u);
+}
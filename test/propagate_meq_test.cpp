@@ -0,0 +1,114 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <array>
+#include <cmath>
+#include <random>
+
+#include <kep3/core_astro/constants.hpp>
+#include <kep3/core_astro/ic2eq2ic.hpp>
+#include <kep3/core_astro/ic2par2ic.hpp>
+#include <kep3/core_astro/propagate_lagrangian.hpp>
+#include <kep3/core_astro/propagate_meq.hpp>
+
+#include "catch.hpp"
+#include "test_helpers.hpp"
+
+using kep3::pi;
+
+namespace {
+
+// Propagates the elements eq both with propagate_meq() and through the
+// cartesian state, returning the largest error on the position and velocity.
+double propagate_meq_error(const std::array<double, 6> &eq, double dt,
+                           bool retrogade) {
+  auto eq_new = eq;
+  kep3::propagate_meq(eq_new, dt, 1., retrogade);
+  // Only the true longitude changes.
+  for (auto k = 0u; k < 5u; ++k) {
+    REQUIRE(eq_new[k] == eq[k]);
+  }
+  auto pos_vel = kep3::eq2ic(eq, 1., retrogade);
+  kep3::propagate_lagrangian(pos_vel, dt, 1.);
+  const auto pos_vel_new = kep3::eq2ic(eq_new, 1., retrogade);
+  return std::max(
+      kep3_tests::floating_point_error_vector(pos_vel[0], pos_vel_new[0]),
+      kep3_tests::floating_point_error_vector(pos_vel[1], pos_vel_new[1]));
+}
+
+} // namespace
+
+TEST_CASE("propagate_meq") {
+  // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+  std::mt19937 rng_engine(122012203u);
+  std::uniform_real_distribution<double> sma_d(1.1, 10.);
+  std::uniform_real_distribution<double> ecc_d(0., 0.9);
+  std::uniform_real_distribution<double> incl_d(0., pi);
+  std::uniform_real_distribution<double> angle_d(0., 2 * pi);
+  std::uniform_real_distribution<double> dt_d(-100., 100.);
+  // Ellipses.
+  for (bool retrogade : {false, true}) {
+    for (auto i = 0u; i < 10000u; ++i) {
+      const auto pos_vel = kep3::par2ic(
+          {sma_d(rng_engine), ecc_d(rng_engine), incl_d(rng_engine),
+           angle_d(rng_engine), angle_d(rng_engine), angle_d(rng_engine)},
+          1.);
+      REQUIRE(propagate_meq_error(kep3::ic2eq(pos_vel, 1., retrogade),
+                                  dt_d(rng_engine), retrogade) < 1e-11);
+    }
+  }
+  // Circular and equatorial orbits, on which the Keplerian elements are
+  // singular.
+  for (auto i = 0u; i < 1000u; ++i) {
+    const double p = sma_d(rng_engine), L = angle_d(rng_engine);
+    const double ecc = ecc_d(rng_engine), w = angle_d(rng_engine);
+    const double dt = dt_d(rng_engine);
+    REQUIRE(propagate_meq_error({p, 0., 0., 0., 0., L}, dt, false) < 1e-11);
+    REQUIRE(propagate_meq_error({p, 0., 0., 0.3, -0.2, L}, dt, false) <
+            1e-11);
+    REQUIRE(propagate_meq_error(
+                {p, ecc * std::cos(w), ecc * std::sin(w), 0., 0., L}, dt,
+                false) < 1e-11);
+    REQUIRE(propagate_meq_error({p, 1e-12, -1e-12, 0., 0., L}, dt, false) <
+            1e-11);
+  }
+  // The true longitude is advanced continuously: on a circular orbit it
+  // grows as the mean longitude.
+  {
+    std::array<double, 6> eq = {1., 0., 0., 0., 0., 0.5};
+    kep3::propagate_meq(eq, 100.5 * 2 * pi, 1.);
+    REQUIRE(std::abs(eq[5] - (0.5 + 100.5 * 2 * pi)) < 1e-11);
+    kep3::propagate_meq(eq, -100.5 * 2 * pi, 1.);
+    REQUIRE(std::abs(eq[5] - 0.5) < 1e-11);
+  }
+  // After a full period an eccentric orbit is back to where it was.
+  {
+    std::array<double, 6> eq = {0.5, 0.3, -0.4, 0.1, 0.2, 1.};
+    const double a = eq[0] / (1. - 0.25);
+    kep3::propagate_meq(eq, 3 * 2 * pi * std::sqrt(a * a * a), 1.);
+    REQUIRE(std::abs(eq[5] - (1. + 3 * 2 * pi)) < 1e-11);
+  }
+  // Hyperbolas, through the cartesian state.
+  for (auto i = 0u; i < 1000u; ++i) {
+    const double ecc = ecc_d(rng_engine) + 1.1;
+    const double ni =
+        (2. * angle_d(rng_engine) / (2 * pi) - 1.) * 0.5 * std::acos(-1. / ecc);
+    const auto pos_vel =
+        kep3::par2ic({-sma_d(rng_engine), ecc, incl_d(rng_engine),
+                      angle_d(rng_engine), angle_d(rng_engine), ni},
+                     1.);
+    const auto eq = kep3::ic2eq(pos_vel, 1.);
+    const double dt = dt_d(rng_engine) / 10.;
+    REQUIRE(propagate_meq_error(eq, dt, false) < 1e-11);
+    auto eq_new = eq;
+    kep3::propagate_meq(eq_new, dt, 1.);
+    REQUIRE((eq_new[5] - eq[5]) * dt >= 0.);
+    REQUIRE(std::abs(eq_new[5] - eq[5]) < 2 * pi);
+  }
+}
@@ -14,12 +14,10 @@
 #include <array>
 #include <cmath>
 
-#include <xtensor-blas/xlinalg.hpp>
-#include <xtensor/xadapt.hpp>
+#include <kep3/core_astro/constants.hpp>
+#include <kep3/detail/vec3.hpp>
 
 namespace kep3_tests {
-using xt::linalg::cross;
-using xt::linalg::dot;
 // This is a float test which, while controversial, will test for abs
 // differences in small numbers, relative otherwise.
 inline double floating_point_error(double a, double b) {
@@ -35,6 +33,35 @@ inline double floating_point_error_vector(const std::array<double, 3> &r1,
   return R12 / std::max(1., R1);
 }
 
+// Largest error (absolute for small numbers, relative otherwise) of the
+// Jacobian jac of f at x, with respect to central finite differences. The
+// differences of the outputs flagged in angles are taken modulo 2pi.
+template <typename Func>
+inline double
+jacobian_error(const Func &f, const std::array<double, 6> &x,
+               const std::array<std::array<double, 6>, 6> &jac,
+               const std::array<bool, 6> &angles = {}) {
+  double retval = 0.;
+  for (auto j = 0u; j < 6u; ++j) {
+    const double h = 1e-7 * std::max(1., std::abs(x[j]));
+    auto xp = x, xm = x;
+    xp[j] += h;
+    xm[j] -= h;
+    const auto fp = f(xp);
+    const auto fm = f(xm);
+    for (auto i = 0u; i < 6u; ++i) {
+      double diff = fp[i] - fm[i];
+      if (angles[i]) {
+        diff = std::remainder(diff, 2. * kep3::pi);
+      }
+      const double fd = diff / (xp[j] - xm[j]);
+      retval = std::max(retval, std::abs(fd - jac[i][j]) /
+                                    std::max(1., std::abs(jac[i][j])));
+    }
+  }
+  return retval;
+}
+
 // see Battin: "An Introduction to the Mathematics and Methods of
 // Astrodynamics, Revised Edition", Introduction.
 //
@@ -44,13 +71,10 @@ inline double floating_point_error_vector(const std::array<double, 3> &r1,
 inline double delta_guidance_error(const std::array<double, 3> &r1,
                                    const std::array<double, 3> &r2,
                                    const std::array<double, 3> &v1, double mu) {
-  const auto r1_x = xt::adapt(r1);
-  const auto r2_x = xt::adapt(r2);
-  const auto v1_x = xt::adapt(v1);
-  auto F = dot(cross(v1_x, r1_x), cross(v1_x, (r2_x - r1_x))) +
-           mu * dot(r2_x, (r2_x / xt::linalg::norm(r2_x) -
-                           r1_x / xt::linalg::norm(r1_x)));
-  return F(0);
+  using namespace kep3::detail;
+  return vec3_dot(vec3_cross(v1, r1), vec3_cross(v1, vec3_sub(r2, r1))) +
+         mu * vec3_dot(r2, vec3_sub(vec3_div(r2, vec3_norm(r2)),
+                                    vec3_div(r1, vec3_norm(r1))));
 }
 } // namespace kep3_tests
 
@@ -0,0 +1,131 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <array>
+#include <cmath>
+#include <stdexcept>
+
+#include <kep3/core_astro/constants.hpp>
+#include <kep3/epoch.hpp>
+#include <kep3/lambert_problem.hpp>
+#include <kep3/planet.hpp>
+#include <kep3/window_search.hpp>
+
+#include "catch.hpp"
+
+using kep3::epoch;
+using kep3::planet;
+
+// A planet on an inclined, eccentric orbit around the Sun (the anomaly is
+// obtained by a few fixed point iterations on Kepler's equation).
+struct eccentric_udpla {
+  double a = kep3::AU;
+  double e = 0.;
+  double M0 = 0.;
+  double incl = 0.;
+
+  [[nodiscard]] std::array<std::array<double, 3>, 2>
+  eph(const epoch &ep) const {
+    const double n = std::sqrt(kep3::MU_SUN / (a * a * a));
+    const double M = M0 + n * ep.mjd2000() * kep3::DAY2SEC;
+    double E = M;
+    for (auto k = 0u; k < 50u; ++k) {
+      E = M + e * std::sin(E);
+    }
+    const double b = a * std::sqrt(1. - e * e);
+    const double x = a * (std::cos(E) - e), y = b * std::sin(E);
+    const double Edot = n / (1. - e * std::cos(E));
+    const double vx = -a * std::sin(E) * Edot, vy = b * std::cos(E) * Edot;
+    return {{{x, y * std::cos(incl), y * std::sin(incl)},
+             {vx, vy * std::cos(incl), vy * std::sin(incl)}}};
+  }
+  [[nodiscard]] static double get_mu_central_body() { return kep3::MU_SUN; }
+
+private:
+  friend class boost::serialization::access;
+  template <typename Archive> void serialize(Archive &ar, unsigned) {
+    ar &a;
+    ar &e;
+    ar &M0;
+    ar &incl;
+  }
+};
+kep3_S11N_PLANET_EXPORT(eccentric_udpla);
+
+namespace {
+double norm_diff(const std::array<double, 3> &a,
+                 const std::array<double, 3> &b) {
+  return std::sqrt((a[0] - b[0]) * (a[0] - b[0]) +
+                   (a[1] - b[1]) * (a[1] - b[1]) +
+                   (a[2] - b[2]) * (a[2] - b[2]));
+}
+} // namespace
+
+TEST_CASE("window_search") {
+  const eccentric_udpla earth{kep3::AU, 0.0167, 0., 0.};
+  const eccentric_udpla mars{1.524 * kep3::AU, 0.0934, 2., 0.0323};
+  const std::array<double, 2> t_dep_bounds = {0., 800.};
+  const std::array<double, 2> tof_bounds = {100., 500.};
+  // The dense grid.
+  const unsigned n = 200u;
+  double dv_grid = 1e300;
+  for (auto i = 0u; i < n; ++i) {
+    for (auto j = 0u; j < n; ++j) {
+      const double t_dep = t_dep_bounds[0] + 800. * i / (n - 1u);
+      const double tof = tof_bounds[0] + 400. * j / (n - 1u);
+      const auto [r1, v1] = earth.eph(epoch(t_dep));
+      const auto [r2, v2] = mars.eph(epoch(t_dep + tof));
+      const kep3::lambert_problem lp(r1, r2, tof * kep3::DAY2SEC,
+                                     kep3::MU_SUN);
+      dv_grid = std::min(dv_grid, norm_diff(lp.get_v1()[0], v1) +
+                                      norm_diff(lp.get_v2()[0], v2));
+    }
+  }
+  const auto res = kep3::window_search(planet(earth), planet(mars),
+                                       t_dep_bounds, tof_bounds);
+  REQUIRE(!res.windows.empty());
+  // The same optimum (or a better one, off the grid) with 10x fewer
+  // Lambert problems.
+  REQUIRE(res.windows[0].dv <= dv_grid * (1. + 1e-9));
+  REQUIRE(res.windows[0].dv >= dv_grid * (1. - 1e-2));
+  REQUIRE(10u * res.n_lambert < n * n);
+  for (const auto &w : res.windows) {
+    REQUIRE(w.t_dep >= t_dep_bounds[0]);
+    REQUIRE(w.t_dep <= t_dep_bounds[1]);
+    REQUIRE(w.tof >= tof_bounds[0]);
+    REQUIRE(w.tof <= tof_bounds[1]);
+    REQUIRE(w.dv >= res.windows[0].dv);
+    REQUIRE(std::abs(std::sqrt(w.c3) + w.vinf_arr - w.dv) <= 1e-12 * w.dv);
+  }
+  // With a merge radius covering the whole search space all the minima are
+  // merged into the best one.
+  const auto res_merged =
+      kep3::window_search(planet(earth), planet(mars), t_dep_bounds,
+                          tof_bounds, 32u, 1e-3, false, 0u, 1e9);
+  REQUIRE(res_merged.windows.size() == 1u);
+  REQUIRE(res_merged.windows[0].dv == res.windows[0].dv);
+  REQUIRE(res_merged.n_lambert == res.n_lambert);
+  // Invalid arguments.
+  REQUIRE_THROWS_AS(kep3::window_search(planet(earth), planet(mars),
+                                        {1., 0.}, tof_bounds),
+                    std::invalid_argument);
+  REQUIRE_THROWS_AS(kep3::window_search(planet(earth), planet(mars),
+                                        t_dep_bounds, {0., 100.}),
+                    std::invalid_argument);
+  REQUIRE_THROWS_AS(kep3::window_search(planet(earth), planet(mars),
+                                        t_dep_bounds, tof_bounds, 2u),
+                    std::invalid_argument);
+  REQUIRE_THROWS_AS(kep3::window_search(planet(earth), planet(mars),
+                                        t_dep_bounds, tof_bounds, 32u, 0.),
+                    std::invalid_argument);
+  REQUIRE_THROWS_AS(kep3::window_search(planet(earth), planet(mars),
+                                        t_dep_bounds, tof_bounds, 32u, 1e-3,
+                                        false, 0u, -1.),
+                    std::invalid_argument);
+}